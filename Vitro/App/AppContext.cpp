@@ -41,7 +41,7 @@ namespace vt
 
 		void on_window_close(WindowCloseEvent& event)
 		{
-			std::erase(open_windows, &event.window);
+			erase(open_windows, &event.window);
 			if(open_windows.empty())
 				engine_running_status = false;
 		}
@@ -5,12 +5,12 @@ module;
 #include <concurrentqueue/concurrentqueue.h>
 #include <ranges>
 #include <typeindex>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 export module vt.App.EventSystem;
 
 import vt.Core.ConcurrentQueue;
+import vt.Core.FlatHashMap;
 import vt.Core.Reflect;
 import vt.Core.Singleton;
 import vt.Trace.Log;
@@ -46,7 +46,7 @@ namespace vt
 			Callback	   callback;
 			EventListener* listener;
 		};
-		std::unordered_map<std::type_index, std::vector<EventHandler>> event_handlers;
+		FlatHashMap<std::type_index, std::vector<EventHandler>> event_handlers;
 
 		ConcurrentQueue<std::any> async_events; // TODO: replace with custom any-like type, since we need void*.
 		ConsumerToken			  con_token;
@@ -7,6 +7,7 @@
 
 import vt.App.AppSystem;
 import vt.Core.Algorithm;
+import vt.Core.JobSystem;
 import vt.Core.Version;
 import vt.Editor.Editor;
 import vt.Graphics.GraphicsSystem;
@@ -21,6 +22,7 @@ namespace vt
 		Engine(int argc, char* argv[])
 		try : command_line_args(argv, argv + argc), app_system(is_running),
 			graphics_system(contains(command_line_args, CVAR_DEBUG_GPU_API),
+							contains(command_line_args, CVAR_STRESS_SCENE),
 							app_system.get_current_app_name(),
 							app_system.get_current_app_version(),
 							ENGINE_VERSION)
@@ -52,10 +54,12 @@ namespace vt
 	private:
 		static constexpr Version	 ENGINE_VERSION		= {0, 0, 1};
 		static constexpr char const* CVAR_DEBUG_GPU_API = "--debug-gpu-api";
+		static constexpr char const* CVAR_STRESS_SCENE	= "--stress-scene"; // Renders windows with the StressRenderer.
 
 		std::atomic_bool			  is_running;
 		std::vector<std::string_view> command_line_args;
 		TraceSystem					  trace_system;
+		JobSystem					  job_system;
 		AppSystem					  app_system;
 		GraphicsSystem				  graphics_system;
 		Editor						  editor;
@@ -1,30 +1,44 @@
-module;
-#include <cmath>
 export module vt.Graphics.Camera;
 
 import vt.Core.Matrix;
-import vt.Core.Transform;
+import vt.Core.Quaternion;
 import vt.Core.Vector;
-import vt.Trace.Log;
 
 namespace vt
 {
+	// Not thread-safe, since even reading the view projection may rebuild it. Moving and reading a camera must happen on
+	// the same thread.
 	export class Camera
 	{
 	public:
 		Camera(Float3 position, Float3 target, Float4x4 const& projection) :
-			projection(projection), position(position), forward(normalize(target))
-		{
-			update_view_projection();
-		}
+			projection(projection), position(position), orientation(orientation_from_forward(normalize(target)))
+		{}
 
 		Float4x4 const& get_projection() const
 		{
 			return projection;
 		}
 
+		// Rebuilds the view projection if the camera changed since the last call, so that any number of movements between two
+		// reads only cost a single rebuild.
 		Float4x4 const& get_view_projection() const
 		{
+			if(view_projection_dirty)
+			{
+				auto const rotation = to_matrix3(orientation);
+
+				auto const& [right, up, forward] = rotation.rows;
+
+				Float4x4 const view {{
+					{right.x, up.x, forward.x, 0},
+					{right.y, up.y, forward.y, 0},
+					{right.z, up.z, forward.z, 0},
+					{-dot(right, position), -dot(up, position), -dot(forward, position), 1},
+				}};
+				view_projection		  = view * projection;
+				view_projection_dirty = false;
+			}
 			return view_projection;
 		}
 
@@ -33,51 +47,54 @@ namespace vt
 			return position;
 		}
 
-		Float3 const& right_direction() const
+		Quaternion const& get_orientation() const
+		{
+			return orientation;
+		}
+
+		Float3 right_direction() const
 		{
-			return right;
+			return rotate(orientation, DEFAULT_RIGHT);
 		}
 
-		Float3 const& up_direction() const
+		Float3 up_direction() const
 		{
-			return up;
+			return rotate(orientation, DEFAULT_UP);
 		}
 
-		Float3 const& forward_direction() const
+		Float3 forward_direction() const
 		{
-			return forward;
+			return rotate(orientation, DEFAULT_FORWARD);
 		}
 
 		void set_position(Float3 pos)
 		{
-			position = pos;
-			update_view_projection();
+			position			  = pos;
+			view_projection_dirty = true;
 		}
 
 		void translate(Float3 translation)
 		{
-			position += Float3x3 {right, up, forward} * translation;
-			update_view_projection();
+			position += rotate(orientation, translation);
+			view_projection_dirty = true;
 		}
 
+		// Tilts the forward direction towards the up direction.
 		void pitch(float radians)
 		{
-			forward = normalize(forward * std::cos(radians) + up * std::sin(radians));
-			update_view_projection();
+			rotate_locally(DEFAULT_RIGHT, -radians);
 		}
 
+		// Turns the forward direction towards the right direction.
 		void yaw(float radians)
 		{
-			forward = normalize(forward * std::cos(radians) + right * std::sin(radians));
-			right	= cross(up, forward);
-			update_view_projection();
+			rotate_locally(DEFAULT_UP, radians);
 		}
 
+		// Turns the right direction towards the up direction.
 		void roll(float radians)
 		{
-			right = normalize(right * std::cos(radians) + up * std::sin(radians));
-			up	  = cross(forward, right);
-			update_view_projection();
+			rotate_locally(DEFAULT_FORWARD, radians);
 		}
 
 	private:
@@ -85,16 +102,31 @@ namespace vt
 		static const inline Float3 DEFAULT_UP	   = {0, 1, 0};
 		static const inline Float3 DEFAULT_FORWARD = {0, 0, 1};
 
-		Float4x4 projection;
-		Float4x4 view_projection;
-		Float3	 position;
-		Float3	 right	 = DEFAULT_RIGHT;
-		Float3	 up		 = DEFAULT_UP;
-		Float3	 forward = DEFAULT_FORWARD;
+		Float4x4		 projection;
+		mutable Float4x4 view_projection;
+		Float3			 position;
+		Quaternion		 orientation;
+		mutable bool	 view_projection_dirty = true;
+
+		static Quaternion orientation_from_forward(Float3 forward)
+		{
+			auto right = cross(DEFAULT_UP, forward);
+
+			float const right_length = length(right);
+			if(right_length < 1e-6f) // Looking straight up or down, so the default up direction cannot be used.
+				right = DEFAULT_RIGHT;
+			else
+				right = right / right_length;
+
+			auto up = cross(forward, right);
+			return Quaternion::from_matrix({right, up, forward});
+		}
 
-		void update_view_projection()
+		void rotate_locally(Float3 axis, float radians)
 		{
-			view_projection = look_at(position, position + forward, up) * projection;
+			// Renormalizing after every delta keeps accumulated rounding errors from skewing the orientation.
+			orientation			  = normalize(orientation * Quaternion::from_axis_angle(axis, radians));
+			view_projection_dirty = true;
 		}
 	};
 }
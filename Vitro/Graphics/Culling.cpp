@@ -0,0 +1,221 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <bit>
+#include <span>
+#include <type_traits>
+#include <vector>
+export module vt.Graphics.Culling;
+
+import vt.Core.BoundingVolumeHierarchy;
+import vt.Core.Matrix;
+import vt.Core.Simd;
+import vt.Core.Vector;
+import vt.Core.VectorStream;
+import vt.Graphics.Camera;
+
+namespace vt
+{
+	export struct BoundingBox
+	{
+		Float3 center;
+		Float3 extent; // Half of the size along each axis.
+	};
+
+	export struct BoundingSphere
+	{
+		Float3 center;
+		float  radius = 0;
+	};
+
+	// Planes are stored as (normal, distance) with normals pointing to the inside, so a point p is inside if
+	// dot(normal, p) + distance >= 0 holds for every plane.
+	export class Frustum
+	{
+	public:
+		static constexpr int PLANE_COUNT = 6;
+
+		Float4 planes[PLANE_COUNT];
+
+		// Extracts the planes from a view projection matrix in row vector convention with a depth range of 0 to 1.
+		static Frustum from_view_projection(Float4x4 const& view_projection) noexcept
+		{
+			auto& m = view_projection.rows;
+
+			Float4 const columns[] {
+				{m[0].x, m[1].x, m[2].x, m[3].x},
+				{m[0].y, m[1].y, m[2].y, m[3].y},
+				{m[0].z, m[1].z, m[2].z, m[3].z},
+				{m[0].w, m[1].w, m[2].w, m[3].w},
+			};
+			Frustum frustum {{
+				columns[3] + columns[0], // Left
+				columns[3] - columns[0], // Right
+				columns[3] + columns[1], // Bottom
+				columns[3] - columns[1], // Top
+				columns[2],				 // Near
+				columns[3] - columns[2], // Far
+			}};
+			for(auto& plane : frustum.planes)
+				plane = plane / length(Float3 {plane.x, plane.y, plane.z});
+
+			return frustum;
+		}
+
+		static Frustum from_camera(Camera const& camera) noexcept
+		{
+			return from_view_projection(camera.get_view_projection());
+		}
+
+		bool intersects(BoundingBox const& box) const noexcept
+		{
+			for(auto& plane : planes)
+			{
+				Float3 const normal {plane.x, plane.y, plane.z};
+
+				float const distance = dot(normal, box.center) + plane.w;
+				float const radius	 = dot(abs(normal), box.extent);
+				if(distance + radius < 0)
+					return false;
+			}
+			return true;
+		}
+
+		bool intersects(BoundingSphere const& sphere) const noexcept
+		{
+			for(auto& plane : planes)
+				if(dot(Float3 {plane.x, plane.y, plane.z}, sphere.center) + plane.w + sphere.radius < 0)
+					return false;
+
+			return true;
+		}
+	};
+
+	// Appends the indices of set bits to the visible list, offset by the index of the first element in the pack.
+	VT_ALWAYS_INLINE void append_visible(unsigned*& out, unsigned bits, size_t first)
+	{
+		while(bits)
+		{
+			*out++ = static_cast<unsigned>(first) + std::countr_zero(bits);
+			bits &= bits - 1;
+		}
+	}
+
+	// Tests packs of bounds against the frustum planes. The test callback receives the planes broadcast into packs, whether
+	// the pack is full as a compile-time constant, the index of the first element and the number of valid elements, and
+	// returns a lane mask of bounds that are outside of at least one plane.
+	template<typename Test> void cull(Frustum const& frustum, size_t count, std::vector<unsigned>& visible, Test test)
+	{
+		simd::FloatPack planes[Frustum::PLANE_COUNT][4];
+		for(int p = 0; p != Frustum::PLANE_COUNT; ++p)
+			for(int i = 0; i != 4; ++i)
+				planes[p][i] = simd::splat_pack(frustum.planes[p][i]);
+
+		// Room for the worst case is made up front, so indices can be written without checking capacity.
+		size_t const offset = visible.size();
+		visible.resize(offset + count);
+
+		unsigned* out = visible.data() + offset;
+
+		size_t i = 0;
+		for(; i + simd::PACK_WIDTH <= count; i += simd::PACK_WIDTH)
+		{
+			unsigned outside = test(planes, std::true_type(), i, simd::PACK_WIDTH);
+			append_visible(out, ~outside & ((1u << simd::PACK_WIDTH) - 1), i);
+		}
+		if(i != count)
+		{
+			int const rest	  = static_cast<int>(count - i);
+			unsigned  outside = test(planes, std::false_type(), i, rest);
+			append_visible(out, ~outside & ((1u << rest) - 1), i);
+		}
+		visible.resize(out - visible.data());
+	}
+
+	template<bool FULL> VT_ALWAYS_INLINE simd::FloatPack load(float const src[], int count)
+	{
+		if constexpr(FULL)
+			return simd::load_pack(src);
+		else
+			return simd::load_pack_partial(src, count);
+	}
+
+	// Appends the indices of boxes that intersect the frustum to the visible list and returns how many were appended.
+	export size_t cull_boxes(Frustum const&			frustum,
+							 Float3Stream const&	centers,
+							 Float3Stream const&	extents,
+							 std::vector<unsigned>& visible)
+	{
+		VT_ASSERT(centers.size() == extents.size(), "Every box needs a center and an extent.");
+
+		size_t const previous_size = visible.size();
+		cull(frustum, centers.size(), visible, [&](auto const& planes, auto full, size_t i, int count) {
+			auto const cx = load<full>(centers.component(0) + i, count);
+			auto const cy = load<full>(centers.component(1) + i, count);
+			auto const cz = load<full>(centers.component(2) + i, count);
+			auto const ex = load<full>(extents.component(0) + i, count);
+			auto const ey = load<full>(extents.component(1) + i, count);
+			auto const ez = load<full>(extents.component(2) + i, count);
+
+			unsigned outside = 0;
+			for(auto& plane : planes)
+			{
+				auto distance = simd::mul_add(cx, plane[0], plane[3]);
+				distance	  = simd::mul_add(cy, plane[1], distance);
+				distance	  = simd::mul_add(cz, plane[2], distance);
+
+				// Projected extent of the box onto the plane normal.
+				auto radius = simd::mul(ex, simd::abs(plane[0]));
+				radius		= simd::mul_add(ey, simd::abs(plane[1]), radius);
+				radius		= simd::mul_add(ez, simd::abs(plane[2]), radius);
+
+				outside |= simd::to_bitmask(simd::greater(simd::sub(simd::splat_pack(0), radius), distance));
+			}
+			return outside;
+		});
+		return visible.size() - previous_size;
+	}
+
+	// Appends the indices of spheres that intersect the frustum to the visible list and returns how many were appended.
+	export size_t cull_spheres(Frustum const&		  frustum,
+							   Float3Stream const&	  centers,
+							   std::span<float const> radii,
+							   std::vector<unsigned>& visible)
+	{
+		VT_ASSERT(centers.size() == radii.size(), "Every sphere needs a center and a radius.");
+
+		size_t const previous_size = visible.size();
+		cull(frustum, centers.size(), visible, [&](auto const& planes, auto full, size_t i, int count) {
+			auto const cx	  = load<full>(centers.component(0) + i, count);
+			auto const cy	  = load<full>(centers.component(1) + i, count);
+			auto const cz	  = load<full>(centers.component(2) + i, count);
+			auto const radius = load<full>(radii.data() + i, count);
+
+			unsigned outside = 0;
+			for(auto& plane : planes)
+			{
+				auto distance = simd::mul_add(cx, plane[0], plane[3]);
+				distance	  = simd::mul_add(cy, plane[1], distance);
+				distance	  = simd::mul_add(cz, plane[2], distance);
+				distance	  = simd::add(distance, radius);
+
+				outside |= simd::to_bitmask(simd::greater(simd::splat_pack(0), distance));
+			}
+			return outside;
+		});
+		return visible.size() - previous_size;
+	}
+
+	// Appends the indices of hierarchy primitives that intersect the frustum to the visible list and returns how many were
+	// appended. Preferable over the batch functions for large scenes where most objects are outside of the frustum.
+	export size_t cull_hierarchy(Frustum const&					frustum,
+								 BoundingVolumeHierarchy const& hierarchy,
+								 std::vector<unsigned>&			visible)
+	{
+		size_t const previous_size = visible.size();
+		hierarchy.query_frustum(frustum.planes, [&](unsigned primitive) {
+			visible.push_back(primitive);
+		});
+		return visible.size() - previous_size;
+	}
+}
@@ -1,27 +1,39 @@
 module;
+#include <atomic>
+#include <utility>
 #include <vector>
 export module vt.Graphics.ForwardRenderer;
 
 import vt.App.EventListener;
 import vt.App.Input;
 import vt.App.WindowEvent;
+import vt.Core.Half;
+import vt.Core.Packing;
 import vt.Core.Rect;
+import vt.Core.Ref;
+import vt.Core.SmallList;
 import vt.Core.Tick;
 import vt.Core.Transform;
 import vt.Core.Vector;
+import vt.Graphics.AbstractDevice;
 import vt.Graphics.AssetResource;
 import vt.Graphics.Camera;
 import vt.Graphics.CommandList;
 import vt.Graphics.AbstractCommandList;
 import vt.Graphics.DeletionQueue;
 import vt.Graphics.DescriptorBinding;
+import vt.Graphics.DescriptorSet;
 import vt.Graphics.DescriptorSetLayout;
 import vt.Graphics.Device;
+import vt.Graphics.DynamicBufferAllocator;
 import vt.Graphics.RendererBase;
+import vt.Graphics.RenderGraph;
 import vt.Graphics.RenderPass;
 import vt.Graphics.RenderTarget;
 import vt.Graphics.RingBuffer;
 import vt.Graphics.RootSignature;
+import vt.Graphics.Shader;
+import vt.Graphics.UploadQueue;
 import vt.Trace.Log;
 
 namespace vt
@@ -33,73 +45,93 @@ namespace vt
 			RendererBase(device),
 			cam({-3, 0, -3}, {3, 0, 3}, project_perspective(0.4f * 3.14f, shared_render_target_size, 1.0f, 1000.f)),
 			final_render_pass(make_final_render_pass(shared_render_target_format)),
-			context(device)
+			graph(device)
 		{
-			initialize_root_signature_and_pipeline();
+			initialize_root_signature();
+			initialize_draw_constant_descriptors();
 			initialize_vertex_and_index_buffers();
 			initialize_depth_image(shared_render_target_size);
+			initialize_render_pipeline(); // Last, since the destructor only runs to release it once construction succeeded.
 
 			register_event_handlers<&ForwardRenderer::on_mouse_move>();
 		}
 
+		// Window contexts flush the device before destroying their renderer, so the pipeline is no longer in use.
+		~ForwardRenderer() override
+		{
+			device.release_pipeline(render_pipeline);
+		}
+
 	protected:
-		SmallList<CommandListHandle> render(Tick tick, RenderTarget const& render_target) override
+		FrameSubmission render(Tick tick, RenderTarget const& render_target) override
 		{
 			auto& current = context.current();
 
 			current.deletion_queue.delete_all();
 
-			auto& cmd = current.render_cmd_list;
-			cmd->reset();
-			cmd->begin();
-
 			Float4 clear_color = 0.5f + 0.5f * cos(time / 1000.0f + Float3 {0, 2, 4});
 			clear_color.a	   = 1;
 			time += tick * 1000;
 
-			ClearValue clear_value[] {
-				ClearValue {
-					.color = clear_color,
-				},
-				ClearValue {
-					.depth = 1.0f,
-				},
-			};
-			cmd->begin_render_pass(final_render_pass, render_target, clear_value);
-			cmd->bind_render_root_signature(root_signatures[0]);
-			cmd->bind_render_pipeline(render_pipelines[0]);
-
-			Viewport viewport {
-				.width	= static_cast<float>(render_target.get_width()),
-				.height = static_cast<float>(render_target.get_height()),
-			};
-			cmd->set_viewports(viewport);
-
-			Rectangle scissor {
-				.width	= render_target.get_width(),
-				.height = render_target.get_height(),
-			};
-			cmd->set_scissors(scissor);
-
-			Float4 triangle_color = 0.5f + 0.5f * cos(time / 1000.0f + Float3 {3, 1.5, 0});
-			triangle_color.a	  = 1;
-			cmd->push_render_constants(0, sizeof triangle_color, &triangle_color);
-
 			update_cam(tick);
-			auto& vp = cam.get_view_projection();
-			cmd->push_render_constants(sizeof triangle_color, sizeof vp, &vp);
 
-			size_t offset = 0;
-			cmd->bind_vertex_buffers(0, vertex_buffers[0], offset);
-			cmd->bind_index_buffer(index_buffers[0], 0);
-
-			cmd->draw_indexed(36, 1, 0, 0, 0);
-			cmd->end_render_pass();
-			cmd->end();
+			// Written before recording, since passes might be recorded on other threads.
+			auto&		   allocator	  = device.get_dynamic_buffer_allocator();
+			unsigned const mvp_offset	  = allocator.push(cam.get_view_projection());
+			auto&		   draw_constants = draw_constant_sets[allocator.get_current_frame_index()];
+			auto&		   pipeline		  = device.get_resource(render_pipeline);
+
+			auto vertex_buffer = graph.import_buffer("Vertices", vertex_buffers[0]);
+			auto index_buffer  = graph.import_buffer("Indices", index_buffers[0]);
+			auto depth_image   = graph.import_image("Depth", depth_images[0]);
+			graph.add_pass<CommandType::Render>(
+				"Forward",
+				[&](RenderGraph::PassBuilder& pass) {
+					pass.read(vertex_buffer, BufferAccess::Vertex);
+					pass.read(index_buffer, BufferAccess::Index);
+					pass.attach(depth_image, ImageLayout::DepthStencilAttachment, ImageLayout::DepthStencilAttachment);
+					pass.mark_side_effects(); // Renders to the swap chain image.
+				},
+				[&](AbstractRenderCommandList& cmd, RenderGraph::Resources const& resources) {
+					ClearValue clear_value[] {
+						ClearValue {
+							.color = clear_color,
+						},
+						ClearValue {
+							.depth = 1.0f,
+						},
+					};
+					cmd.begin_render_pass(final_render_pass, render_target, clear_value);
+					cmd.bind_render_root_signature(root_signatures[0]);
+					cmd.bind_render_pipeline(pipeline);
+					cmd.bind_render_descriptors(draw_constants, mvp_offset);
+
+					Viewport viewport {
+						.width	= static_cast<float>(render_target.get_width()),
+						.height = static_cast<float>(render_target.get_height()),
+					};
+					cmd.set_viewports(viewport);
+
+					Rectangle scissor {
+						.width	= render_target.get_width(),
+						.height = render_target.get_height(),
+					};
+					cmd.set_scissors(scissor);
+
+					Float4 triangle_color = 0.5f + 0.5f * cos(time / 1000.0f + Float3 {3, 1.5, 0});
+					triangle_color.a	  = 1;
+					cmd.push_render_constants(0, sizeof triangle_color, &triangle_color);
+
+					size_t offset = 0;
+					cmd.bind_vertex_buffers(0, resources.get(vertex_buffer), offset);
+					cmd.bind_index_buffer(resources.get(index_buffer), 0);
+
+					cmd.draw_indexed(36, 1, 0, 0, 0);
+					cmd.end_render_pass();
+				});
 
-			auto cmd_list = cmd->get_handle();
 			context.move_to_next_frame();
-			return {cmd_list};
+			return graph.execute();
 		}
 
 		SharedRenderTargetSpecification specify_shared_render_target() const override
@@ -122,19 +154,19 @@ namespace vt
 		RenderPass						 final_render_pass;
 		std::vector<DescriptorSetLayout> descriptor_set_layouts;
 		std::vector<RootSignature>		 root_signatures;
-		std::vector<RenderPipeline>		 render_pipelines;
+		SmallList<DescriptorSet>		 draw_constant_sets; // One per dynamic buffer, since each frame has its own.
+		RenderPipelineHandle			 render_pipeline; // Shared with other renderers that use an equal pipeline.
 		std::vector<Buffer>				 vertex_buffers;
 		std::vector<Buffer>				 index_buffers;
 		std::vector<Image>				 depth_images;
-		float							 time = 0;
+		float							 time			  = 0;
+		std::atomic<int>				 mouse_movement_x = 0; // Mouse movement since the camera was last updated.
+		std::atomic<int>				 mouse_movement_y = 0;
+		RenderGraph						 graph;
 
 		struct FrameResources
 		{
-			RenderCommandList render_cmd_list;
-			DeletionQueue	  deletion_queue;
-
-			FrameResources(Device& device) : render_cmd_list(device->make_render_command_list())
-			{}
+			DeletionQueue deletion_queue;
 		};
 		RingBuffer<FrameResources> context;
 
@@ -165,19 +197,55 @@ namespace vt
 			return device->make_render_pass(spec);
 		}
 
-		void initialize_root_signature_and_pipeline()
+		void initialize_root_signature()
 		{
+			DescriptorBinding const draw_constants_binding {
+				.shader_register = 0,
+				.type			 = DescriptorType::DynamicUniformBuffer,
+			};
+			DescriptorSetLayoutSpecification const layout_spec {
+				.bindings	= draw_constants_binding,
+				.visibility = ShaderStage::Vertex,
+			};
+			descriptor_set_layouts.emplace_back(device->make_descriptor_set_layout(layout_spec));
+
 			RootSignatureSpecification const root_sig_spec {
-				.push_constants_byte_size  = sizeof(Float4) + sizeof(Float4x4),
-				.push_constants_visibility = ShaderStage::All,
+				.push_constants_byte_size  = sizeof(Float4),
+				.push_constants_visibility = ShaderStage::Fragment,
+				.layouts				   = descriptor_set_layouts,
 			};
-			auto& sig = root_signatures.emplace_back(device->make_root_signature(root_sig_spec));
+			root_signatures.emplace_back(device->make_root_signature(root_sig_spec));
+		}
+
+		void initialize_draw_constant_descriptors()
+		{
+			auto& allocator = device.get_dynamic_buffer_allocator();
+			for(unsigned i = 0; i != MAX_FRAMES_IN_FLIGHT; ++i)
+			{
+				unsigned const variable_count = 0;
+
+				auto  sets = device->make_descriptor_sets(descriptor_set_layouts[0], &variable_count);
+				auto& set  = draw_constant_sets.emplace_back(std::move(sets[0]));
+
+				CRef<Buffer> const	   buffer = allocator.get_buffer(i);
+				DescriptorUpdate const update {
+					.set			= set,
+					.first_register = 0,
+					.type			= DescriptorType::DynamicUniformBuffer,
+					.dynamic_range	= sizeof(Float4x4),
+					.buffers		= buffer,
+				};
+				device->update_descriptors(update);
+			}
+		}
 
+		void initialize_render_pipeline()
+		{
 			auto vertex_shader	 = device->make_shader("Cube.vert." VT_SHADER_EXTENSION);
 			auto fragment_shader = device->make_shader("Cube.frag." VT_SHADER_EXTENSION);
 
 			RenderPipelineSpecification const pipe_spec {
-				.root_signature	 = sig,
+				.root_signature	 = root_signatures[0],
 				.render_pass	 = final_render_pass,
 				.vertex_shader	 = vertex_shader,
 				.fragment_shader = &fragment_shader,
@@ -185,10 +253,12 @@ namespace vt
 					VertexBufferBinding {
 						.attributes {
 							VertexAttribute {
-								.type = VertexDataType::Position,
+								.type	= VertexDataType::Position,
+								.format = VertexFormat::Half4,
 							},
 							VertexAttribute {
-								.type = VertexDataType::Color,
+								.type	= VertexDataType::Color,
+								.format = VertexFormat::UNormRgba8,
 							},
 						},
 					},
@@ -203,31 +273,28 @@ namespace vt
 					.attachment_states = {1},
 				},
 			};
-			render_pipelines = device->make_render_pipelines(pipe_spec);
+			render_pipeline = device.acquire_render_pipeline(pipe_spec);
 		}
 
 		void initialize_vertex_and_index_buffers()
 		{
 			struct Vertex
 			{
-				Float4 position;
-				Float4 color;
+				Half4	 position;
+				uint32_t color;
+			};
+			auto make_vertex = [](Float4 position, Float4 color) {
+				return Vertex {to_half(position), pack_unorm_rgba8(color)};
 			};
 			Vertex vertices[] {
-				{{-1, -1, -1, 1}, {0, 0, 0, 1}}, {{-1, 1, -1, 1}, {0, 1, 0, 1}}, {{1, 1, -1, 1}, {1, 1, 0, 1}},
-				{{1, -1, -1, 1}, {1, 0, 0, 1}},	 {{-1, -1, 1, 1}, {0, 0, 1, 1}}, {{-1, 1, 1, 1}, {0, 1, 1, 1}},
-				{{1, 1, 1, 1}, {1, 1, 1, 1}},	 {{1, -1, 1, 1}, {1, 0, 1, 1}},
+				make_vertex({-1, -1, -1, 1}, {0, 0, 0, 1}), make_vertex({-1, 1, -1, 1}, {0, 1, 0, 1}),
+				make_vertex({1, 1, -1, 1}, {1, 1, 0, 1}),	make_vertex({1, -1, -1, 1}, {1, 0, 0, 1}),
+				make_vertex({-1, -1, 1, 1}, {0, 0, 1, 1}),	make_vertex({-1, 1, 1, 1}, {0, 1, 1, 1}),
+				make_vertex({1, 1, 1, 1}, {1, 1, 1, 1}),	make_vertex({1, -1, 1, 1}, {1, 0, 1, 1}),
 			};
 			uint32_t indices[] {0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6, 4, 5, 1, 4, 1, 0,
 								3, 2, 6, 3, 6, 7, 1, 5, 6, 1, 6, 2, 4, 0, 3, 4, 3, 7};
 
-			BufferSpecification const staging_buffer_spec {
-				.size	= sizeof vertices + sizeof indices,
-				.stride = 1,
-				.usage	= BufferUsage::CopySrc | BufferUsage::Upload,
-			};
-			auto stage = device->make_buffer(staging_buffer_spec);
-
 			BufferSpecification const vertex_buffer_spec {
 				.size	= sizeof vertices,
 				.stride = sizeof(Vertex),
@@ -235,11 +302,6 @@ namespace vt
 			};
 			auto& vertex_buffer = vertex_buffers.emplace_back(device->make_buffer(vertex_buffer_spec));
 
-			auto dst = device->map(stage);
-			std::memcpy(dst, vertices, sizeof vertices);
-			std::memcpy((char*)dst + sizeof vertices, indices, sizeof indices);
-			device->unmap(stage);
-
 			BufferSpecification const index_buffer_spec {
 				.size	= sizeof indices,
 				.stride = sizeof(uint32_t),
@@ -247,16 +309,10 @@ namespace vt
 			};
 			auto& index_buffer = index_buffers.emplace_back(device->make_buffer(index_buffer_spec));
 
-			auto cmd = device->make_copy_command_list();
-			cmd->reset();
-			cmd->begin();
-			cmd->copy_buffer_region(stage, vertex_buffer, 0, 0, sizeof vertices);
-			cmd->copy_buffer_region(stage, index_buffer, sizeof vertices, 0, sizeof indices);
-			cmd->end();
-
-			auto list  = cmd->get_handle();
-			auto token = device->submit_copy_commands(list);
-			device->wait_for_workload(token);
+			// The render graph makes the first frame wait for the uploads, so there is no need to wait for them here.
+			auto& upload_queue = device.get_upload_queue();
+			upload_queue.upload_buffer(vertex_buffer, 0, vertices, sizeof vertices, BufferAccess::Vertex, CommandType::Render);
+			upload_queue.upload_buffer(index_buffer, 0, indices, sizeof indices, BufferAccess::Index, CommandType::Render);
 		}
 
 		void initialize_depth_image(Extent size)
@@ -271,8 +327,13 @@ namespace vt
 			depth_images.emplace_back(device->make_image(spec));
 		}
 
+		// Mouse movement is applied here instead of in the event handler, so that the camera is only ever touched by the
+		// render thread.
 		void update_cam(Tick tick)
 		{
+			cam.yaw(radians(0.25f * static_cast<float>(mouse_movement_x.exchange(0, std::memory_order_relaxed))));
+			cam.pitch(radians(0.25f * static_cast<float>(mouse_movement_y.exchange(0, std::memory_order_relaxed))));
+
 			float move_speed = 5 * tick;
 
 			if(Input::is_down(KeyCode::A))
@@ -301,8 +362,8 @@ namespace vt
 
 		void on_mouse_move(MouseMoveEvent& event)
 		{
-			cam.yaw(radians(0.25f * event.direction.x));
-			cam.pitch(radians(0.25f * event.direction.y));
+			mouse_movement_x.fetch_add(event.direction.x, std::memory_order_relaxed);
+			mouse_movement_y.fetch_add(event.direction.y, std::memory_order_relaxed);
 		}
 	};
 }
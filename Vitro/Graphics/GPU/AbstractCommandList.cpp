@@ -7,6 +7,7 @@ import vt.Core.FixedList;
 import vt.Core.Rect;
 import vt.Core.Vector;
 import vt.Graphics.AssetResource;
+import vt.Graphics.AssetResourceSpecification;
 import vt.Graphics.DescriptorSet;
 import vt.Graphics.Handle;
 import vt.Graphics.PipelineSpecification;
@@ -22,6 +23,13 @@ namespace vt
 		Render,
 	};
 
+	// Specifies whether the commands of a subpass are recorded directly into the command list that began it, or into
+	// secondary command lists that are then executed by it.
+	export enum class SubpassContents : uint8_t {
+		Inline,
+		Secondary,
+	};
+
 	// Holds either a clear value for a color attachment or a depth stencil attachment.
 	export union ClearValue
 	{
@@ -46,6 +54,26 @@ namespace vt
 		unsigned dst_array_index = 0; // Index of the destination image in a texture array.
 	};
 
+	// Offsets of texel data in a buffer copied to an image must be a multiple of this on every API.
+	export constexpr inline size_t BUFFER_IMAGE_OFFSET_ALIGNMENT = 512;
+
+	// Row pitches of texel data in a buffer copied to an image must be a multiple of this on every API.
+	export constexpr inline size_t BUFFER_IMAGE_ROW_PITCH_ALIGNMENT = 256;
+
+	// Dynamic offsets given when binding descriptor sets must be a multiple of this on every API.
+	export constexpr inline unsigned DYNAMIC_OFFSET_ALIGNMENT = 256;
+
+	// Describes where the texel data for one subresource of a 2D image lies in a buffer. Each row of texels, or of texel
+	// blocks for block-compressed formats, begins at a multiple of the row pitch, which must also be a multiple of the size
+	// of a texel or block.
+	export struct BufferImageCopyRegion
+	{
+		size_t	 src_offset		 = 0;
+		size_t	 row_pitch		 = 0;
+		unsigned dst_mip		 = 0; // Mip level of the destination image.
+		unsigned dst_array_index = 0; // Index of the destination image in a texture array.
+	};
+
 	export class AbstractCopyCommandList
 	{
 	public:
@@ -63,6 +91,38 @@ namespace vt
 		// Denotes the end of a range of commands. To be called before a command list is submitted.
 		virtual void end() = 0;
 
+		// Prepares the buffer for the given access by the commands recorded after this call. The state of each resource is
+		// tracked on the resource itself, so command lists that change states must be recorded one at a time and in the order
+		// of their submission. The barriers this requires are batched and recorded right before the next copy, dispatch or
+		// render pass. Must be called outside of a render pass and never on secondary command lists, which may therefore be
+		// recorded in parallel. Copy commands require their resources automatically.
+		virtual void require(Buffer const& buffer, BufferAccess access) = 0;
+
+		// Prepares the image for the given layout the same way as for buffers. Layout changes made by render passes are not
+		// tracked automatically, see assume_attachment_layout.
+		virtual void require(Image const& image, ImageLayout layout) = 0;
+
+		// Releases the buffer to the queue of the given command type after it has been prepared for the given access. The
+		// receiving command list must require the same access before its next use of the buffer, and its submission must
+		// wait for the one of this command list.
+		virtual void transition(Buffer const& buffer, BufferAccess access, CommandType next_queue) = 0;
+
+		// Releases the image to the queue of the given command type the same way as for buffers.
+		virtual void transition(Image const& image, ImageLayout layout, CommandType next_queue) = 0;
+
+		// Hands the memory of a buffer placed in a transient heap over to it from whichever resource overlapping it was used
+		// before, which discards its content. Must be called before the buffer is first required after such a resource was
+		// used, which at least includes its first use in each frame.
+		virtual void alias(Buffer const& buffer) = 0;
+
+		// Hands the memory of a placed image over to it the same way as for buffers. Its content is undefined afterwards, so
+		// it must be cleared or entirely overwritten before it is read. Placed attachments can only be aliased on render
+		// command lists, since they are also initialized for use as attachments.
+		virtual void alias(Image const& image) = 0;
+
+		// Returns how many barriers were recorded since the last reset, to help spot redundant synchronization.
+		virtual unsigned count_barriers() const = 0;
+
 		// Directs the GPU to copy the entire content of the source buffer to the destination buffer.
 		virtual void copy_buffer(Buffer const& src, Buffer& dst) = 0;
 
@@ -81,6 +141,9 @@ namespace vt
 
 		// Directs the GPU to copy the amount of texel data specified by region from the source image to the destination image.
 		virtual void copy_image_region(Image const& src, Image& dst, ImageCopyRegion const& region) = 0;
+
+		// Directs the GPU to copy texel data laid out as specified by region from the source buffer to the destination image.
+		virtual void copy_buffer_region_to_image(Buffer const& src, Image& dst, BufferImageCopyRegion const& region) = 0;
 	};
 
 	export class AbstractComputeCommandList : public AbstractCopyCommandList
@@ -95,6 +158,11 @@ namespace vt
 		// Binds descriptors into the layout of the currently bound compute root signature.
 		virtual void bind_compute_descriptors(ArrayView<DescriptorSet> descriptor_sets) = 0;
 
+		// Binds descriptors like the other overload, with one offset into the buffer of each descriptor set holding a dynamic
+		// buffer descriptor, in the order of the descriptor sets. Rebinding only to change offsets updates no descriptors.
+		virtual void bind_compute_descriptors(ArrayView<DescriptorSet> descriptor_sets,
+											  ArrayView<unsigned>	   dynamic_offsets) = 0;
+
 		// Update constant data at the given offset with the given size. Only affects compute workloads.
 		virtual void push_compute_constants(size_t byte_offset, size_t byte_size, void const* data) = 0;
 
@@ -114,14 +182,30 @@ namespace vt
 		// depth-stencil clear value.
 		virtual void begin_render_pass(RenderPass const&	 render_pass,
 									   RenderTarget const&	 render_target,
-									   ConstSpan<ClearValue> clear_values = {}) = 0;
+									   ConstSpan<ClearValue> clear_values = {},
+									   SubpassContents		 contents	  = SubpassContents::Inline) = 0;
 
 		// Transitions the currently bound render target to its next state in the render pass.
-		virtual void change_subpass() = 0;
+		virtual void change_subpass(SubpassContents contents = SubpassContents::Inline) = 0;
 
 		// Denotes the end of a render pass.
 		virtual void end_render_pass() = 0;
 
+		// Records that a render pass wrote to the image as an attachment and left it in the given final layout, so that the
+		// next barrier on the image waits for the attachment writes. Must be called after the render pass. Records nothing.
+		virtual void assume_attachment_layout(Image const& image, ImageLayout final_layout) = 0;
+
+		// Denotes the start of a range of commands in a secondary command list, which continue the given subpass of a render
+		// pass begun by a primary command list. To be called instead of begin. Secondary command lists cannot record render
+		// passes or copies. Viewports and scissors must be set in both lists, because only D3D12 inherits them.
+		virtual void begin_secondary(RenderPass const&	 render_pass,
+									 unsigned			 subpass_index,
+									 RenderTarget const& render_target) = 0;
+
+		// Executes secondary command lists in order inside the current subpass, which must have been begun with secondary
+		// contents.
+		virtual void execute_secondary_commands(ArrayView<CommandListHandle> cmds) = 0;
+
 		// Binds a pipeline for rendering commands.
 		virtual void bind_render_pipeline(RenderPipeline const& pipeline) = 0;
 
@@ -131,6 +215,9 @@ namespace vt
 		// Binds descriptors into the layout of the currently bound render root signature.
 		virtual void bind_render_descriptors(ArrayView<DescriptorSet> descriptor_sets) = 0;
 
+		// Binds descriptors with dynamic offsets the same way as for compute.
+		virtual void bind_render_descriptors(ArrayView<DescriptorSet> descriptor_sets, ArrayView<unsigned> dynamic_offsets) = 0;
+
 		// Update constant data at the given offset with the given size. Only affects rendering workloads.
 		virtual void push_render_constants(size_t byte_offset, size_t byte_size, void const* data) = 0;
 
@@ -167,9 +254,11 @@ namespace vt
 								  unsigned first_instance) = 0;
 
 		// Issue non-indexed draw calls indirectly by having the draw counts be read from the given buffer at the given offset.
+		// The buffer must have been required for indirect access before the render pass began.
 		virtual void draw_indirect(Buffer const& buffer, size_t offset, unsigned draws) = 0;
 
 		// Issue indexed draw calls indirectly by having the draw counts be read from the given buffer at the given offset.
+		// The buffer must have been required for indirect access before the render pass began.
 		virtual void draw_indexed_indirect(Buffer const& buffer, size_t offset, unsigned draws) = 0;
 	};
 
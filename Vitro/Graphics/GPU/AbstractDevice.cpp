@@ -1,9 +1,18 @@
 module;
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 export module vt.Graphics.AbstractDevice;
 
 import vt.App.Window;
 import vt.Core.Array;
+import vt.Core.JobSystem;
 import vt.Core.Ref;
 import vt.Core.SmallList;
 import vt.Core.Specification;
@@ -31,6 +40,7 @@ namespace vt
 		Explicit<unsigned>		 first_register;
 		unsigned				 first_array_index = 0;
 		Explicit<DescriptorType> type;
+		unsigned				 dynamic_range = 0; // Bytes visible through dynamic buffer descriptors, from their offset.
 		union
 		{
 			ConstSpan<CRef<Buffer>>	 buffers;
@@ -39,6 +49,62 @@ namespace vt
 		};
 	};
 
+	// Pipelines that are being made by jobs. Waiting for them runs other jobs on the waiting thread, so it is safe to wait on
+	// a worker thread too. Waits for the jobs when destroyed, so that the objects the specifications refer to can be
+	// destroyed right after it.
+	export template<typename Pipeline> class PendingPipelines
+	{
+		friend class AbstractDevice;
+
+	public:
+		PendingPipelines(PendingPipelines&&) noexcept = default;
+
+		~PendingPipelines()
+		{
+			if(state)
+				JobSystem::wait(state->counter);
+		}
+
+		PendingPipelines& operator=(PendingPipelines&& that) noexcept
+		{
+			std::swap(state, that.state);
+			return *this;
+		}
+
+		bool is_ready() const noexcept
+		{
+			return !state || state->counter.is_done();
+		}
+
+		// Waits for all jobs and returns the pipelines in the order of their specifications, or rethrows the first exception
+		// thrown by any job. Can only be called once.
+		std::vector<Pipeline> get()
+		{
+			VT_ASSERT(state, "The pipelines were already retrieved.");
+			JobSystem::wait(state->counter);
+			auto finished = std::move(state);
+			if(finished->error)
+				std::rethrow_exception(finished->error);
+
+			std::vector<Pipeline> pipelines;
+			for(auto& batch : finished->batches)
+				std::move(batch.begin(), batch.end(), std::back_inserter(pipelines));
+			return pipelines;
+		}
+
+	private:
+		struct State
+		{
+			JobCounter						   counter;
+			std::vector<std::vector<Pipeline>> batches;
+			std::mutex						   error_mutex;
+			std::exception_ptr				   error;
+		};
+		std::shared_ptr<State> state = std::make_shared<State>();
+
+		PendingPipelines() = default;
+	};
+
 	export class AbstractDevice
 	{
 	public:
@@ -53,12 +119,33 @@ namespace vt
 		// Makes a command list for rendering operations.
 		virtual RenderCommandList make_render_command_list() = 0;
 
+		// Makes a command list for rendering operations that is recorded inside a subpass begun by another render command list
+		// and executed by it. Such command lists can be recorded on other threads in parallel.
+		virtual RenderCommandList make_secondary_render_command_list() = 0;
+
 		// Makes a buffer from a specification.
 		virtual Buffer make_buffer(BufferSpecification const& spec) = 0;
 
 		// Makes an image from a specification.
 		virtual Image make_image(ImageSpecification const& spec) = 0;
 
+		// Makes a block of memory that transient resources can be placed into.
+		virtual TransientHeap make_transient_heap(TransientHeapSpecification const& spec) = 0;
+
+		// Makes a buffer with a transient usage in the heap at the given offset, which must be aligned as returned by
+		// get_memory_requirements. The buffer shares memory with other resources overlapping it, so it needs to be aliased
+		// on a command list before its first use after another one of them was used.
+		virtual Buffer make_placed_buffer(BufferSpecification const& spec, TransientHeap const& heap, size_t offset) = 0;
+
+		// Makes an image with a transient usage in the heap at the given offset with the same rules as for buffers.
+		virtual Image make_placed_image(ImageSpecification const& spec, TransientHeap const& heap, size_t offset) = 0;
+
+		// Gets how much memory a buffer made from the specification takes up in a transient heap, and how to align it.
+		virtual MemoryRequirements get_memory_requirements(BufferSpecification const& spec) = 0;
+
+		// Gets how much memory an image made from the specification takes up in a transient heap, and how to align it.
+		virtual MemoryRequirements get_memory_requirements(ImageSpecification const& spec) = 0;
+
 		// Makes pipeline objects usable in compute commands. It can be more efficient to create many at once.
 		virtual std::vector<ComputePipeline> make_compute_pipelines(ArrayView<ComputePipelineSpecification> specs) = 0;
 
@@ -128,6 +215,9 @@ namespace vt
 		// Makes the CPU wait until the workload associated with the token is finished.
 		virtual void wait_for_workload(SyncToken cpu_wait_token) = 0;
 
+		// Returns whether the workload associated with the token is finished, without waiting for it.
+		virtual bool is_workload_done(SyncToken token) = 0;
+
 		// Makes the CPU wait until all currently submitted rendering workloads are finished on the GPU.
 		virtual void flush_render_queue() = 0;
 
@@ -146,6 +236,20 @@ namespace vt
 		// Returns the maximum number of samplers that can be bound at once.
 		virtual unsigned get_max_sampler_descriptors_per_stage() const = 0;
 
+		// Makes pipeline objects usable in compute commands on the threads of the job system, so that the calling thread can
+		// continue in the meantime. The specifications are copied, but the objects they refer to must outlive the result.
+		PendingPipelines<ComputePipeline> make_compute_pipelines_async(ConstSpan<ComputePipelineSpecification> specs)
+		{
+			return make_pipelines_async(specs, &AbstractDevice::make_compute_pipelines);
+		}
+
+		// Makes pipeline objects usable in rendering commands on the threads of the job system, so that the calling thread can
+		// continue in the meantime. The specifications are copied, but the objects they refer to must outlive the result.
+		PendingPipelines<RenderPipeline> make_render_pipelines_async(ConstSpan<RenderPipelineSpecification> specs)
+		{
+			return make_pipelines_async(specs, &AbstractDevice::make_render_pipelines);
+		}
+
 		// Makes a render target from a specification.
 		RenderTarget make_render_target(RenderTargetSpecification const& spec)
 		{
@@ -181,6 +285,12 @@ namespace vt
 		}
 
 	private:
+		// Pipeline compile times vary a lot, so each worker gets several batches to even out the load.
+		static constexpr size_t PIPELINE_BATCHES_PER_WORKER = 4;
+
+		template<typename Pipeline, typename Spec>
+		using MakePipelinesFunc = std::vector<Pipeline> (AbstractDevice::*)(ArrayView<Spec>);
+
 		virtual RenderTarget make_platform_render_target(RenderTargetSpecification const& spec) = 0;
 
 		virtual RenderTarget make_platform_render_target(SharedRenderTargetSpecification const& spec,
@@ -199,5 +309,40 @@ namespace vt
 			render_target.set_width(width);
 			render_target.set_height(height);
 		}
+
+		// Splits the specifications into batches that are each made by a job. Pipeline creation is thread-safe on both APIs.
+		// Without specifications, no job is started and the result is ready right away.
+		template<typename Pipeline, typename Spec>
+		PendingPipelines<Pipeline> make_pipelines_async(ConstSpan<Spec> specs, MakePipelinesFunc<Pipeline, Spec> make_batch)
+		{
+			PendingPipelines<Pipeline> pending;
+
+			auto copied_specs = std::make_shared<std::vector<Spec>>(specs.begin(), specs.end());
+
+			size_t const max_batches = std::max(JobSystem::get_worker_count(), 1u) * PIPELINE_BATCHES_PER_WORKER;
+			size_t const batch_count = std::min(specs.size(), max_batches);
+			pending.state->batches.resize(batch_count);
+
+			for(size_t i = 0; i != batch_count; ++i)
+				JobSystem::run(
+					[this, state = pending.state, copied_specs, make_batch, i] {
+						auto&		 specs = *copied_specs;
+						size_t const begin = i * specs.size() / state->batches.size();
+						size_t const end   = (i + 1) * specs.size() / state->batches.size();
+						try
+						{
+							state->batches[i] = (this->*make_batch)({specs.data() + begin, end - begin});
+						}
+						catch(...)
+						{
+							std::lock_guard lock(state->error_mutex);
+							if(!state->error)
+								state->error = std::current_exception();
+						}
+					},
+					pending.state->counter);
+
+			return pending;
+		}
 	};
 }
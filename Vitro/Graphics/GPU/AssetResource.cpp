@@ -1,5 +1,7 @@
 module;
 #include "VitroCore/Macros.hpp"
+
+#include <cstdint>
 export module vt.Graphics.AssetResource;
 
 import vt.Graphics.AssetResourceSpecification;
@@ -8,11 +10,13 @@ import vt.Graphics.PipelineSpecification;
 import vt.Graphics.VT_GPU_API_MODULE.Buffer;
 import vt.Graphics.VT_GPU_API_MODULE.Image;
 import vt.Graphics.VT_GPU_API_MODULE.Pipeline;
+import vt.Graphics.VT_GPU_API_MODULE.TransientHeap;
 
 #if VT_DYNAMIC_GPU_API
 import vt.Graphics.VT_GPU_API_MODULE_SECONDARY.Buffer;
 import vt.Graphics.VT_GPU_API_MODULE_SECONDARY.Image;
 import vt.Graphics.VT_GPU_API_MODULE_SECONDARY.Pipeline;
+import vt.Graphics.VT_GPU_API_MODULE_SECONDARY.TransientHeap;
 #endif
 
 namespace vt
@@ -92,6 +96,45 @@ namespace vt
 		ImageFormat format;
 	};
 
+	using PlatformTransientHeap = ResourceVariant<VT_GPU_API_VARIANT_ARGS(TransientHeap)>;
+
+	// Represents a block of GPU memory that transient buffers and images can be placed into, so that resources which are
+	// not in use at the same time can share memory. Must outlive the resources placed into it.
+	export class TransientHeap : public PlatformTransientHeap
+	{
+	public:
+		// This constructor is for internal use only.
+		TransientHeap(PlatformTransientHeap&& platform_heap, TransientHeapSpecification const& spec) :
+			PlatformTransientHeap(std::move(platform_heap)),
+			size(spec.size),
+			alignment(spec.alignment),
+			memory_types(spec.memory_types),
+			contents(spec.contents)
+		{}
+
+		size_t get_size() const
+		{
+			return size;
+		}
+
+		// Checks whether resources with the given combined requirements can be placed into the heap.
+		bool supports(size_t required_alignment, uint32_t required_memory_types) const
+		{
+			return alignment >= required_alignment && (memory_types & required_memory_types) == memory_types;
+		}
+
+		TransientHeapContents get_contents() const
+		{
+			return contents;
+		}
+
+	private:
+		size_t				  size;
+		size_t				  alignment;
+		uint32_t			  memory_types;
+		TransientHeapContents contents;
+	};
+
 	using PlatformComputePipeline = ResourceVariant<VT_GPU_API_VARIANT_ARGS(ComputePipeline)>;
 	using PlatformRenderPipeline  = ResourceVariant<VT_GPU_API_VARIANT_ARGS(RenderPipeline)>;
 
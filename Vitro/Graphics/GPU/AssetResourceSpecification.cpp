@@ -22,6 +22,7 @@ namespace vt
 		Indirect  = bit(8),
 		Upload	  = bit(9),	 // Buffer will be used for uploading data to the GPU.
 		Readback  = bit(10), // Buffer will be used for reading back data from the GPU.
+		Transient = bit(11), // Buffer only lives within a frame and can share memory with other transient resources.
 	};
 	export template<> constexpr inline bool ENABLE_BIT_OPERATORS_FOR<BufferUsage> = true;
 
@@ -105,6 +106,91 @@ namespace vt
 		Bc7UNormSrgb, // Uses block compression.
 	};
 
+	// Returns how many bits a texel of the format takes up, averaged over a block for block-compressed formats.
+	export constexpr unsigned get_bits_per_texel(ImageFormat format)
+	{
+		using enum ImageFormat;
+		switch(format)
+		{
+			case Rgba32Float:
+			case Rgba32UInt:
+			case Rgba32SInt: return 128;
+			case Rgb32Float:
+			case Rgb32UInt:
+			case Rgb32SInt: return 96;
+			case Rgba16Float:
+			case Rgba16UNorm:
+			case Rgba16UInt:
+			case Rgba16SNorm:
+			case Rgba16SInt:
+			case Rg32Float:
+			case Rg32UInt:
+			case Rg32SInt:
+			case R32G8X24Typeless:
+			case D32FloatS8X24UInt: return 64;
+			case Rgb10A2UNorm:
+			case Rgb10A2UInt:
+			case Rg11B10Float:
+			case Rgba8UNorm:
+			case Rgba8UNormSrgb:
+			case Rgba8UInt:
+			case Rgba8SNorm:
+			case Rgba8SInt:
+			case Bgra8UNorm:
+			case Bgra8UNormSrgb:
+			case Rg16Float:
+			case Rg16UNorm:
+			case Rg16UInt:
+			case Rg16SNorm:
+			case Rg16SInt:
+			case R32Typeless:
+			case D32Float:
+			case R32Float:
+			case R32UInt:
+			case R32SInt:
+			case R24G8Typeless:
+			case D24UNormS8UInt: return 32;
+			case Rg8UNorm:
+			case Rg8UInt:
+			case Rg8SNorm:
+			case Rg8SInt:
+			case R16Typeless:
+			case R16Float:
+			case D16UNorm:
+			case R16UNorm:
+			case R16UInt:
+			case R16SNorm:
+			case R16SInt: return 16;
+			case R8UNorm:
+			case R8UInt:
+			case R8SNorm:
+			case R8SInt:
+			case Bc2UNorm:
+			case Bc2UNormSrgb:
+			case Bc3UNorm:
+			case Bc3UNormSrgb:
+			case Bc5UNorm:
+			case Bc5SNorm:
+			case Bc6HUFloat16:
+			case Bc6HSFloat16:
+			case Bc7UNorm:
+			case Bc7UNormSrgb: return 8;
+			case Bc1UNorm:
+			case Bc1UNormSrgb:
+			case Bc4UNorm:
+			case Bc4SNorm: return 4;
+			case Unknown: return 0;
+		}
+		return 0;
+	}
+
+	// Returns the width and height in texels of the blocks that the format stores texels in, which is 1 for uncompressed
+	// formats. Block-compressed formats are listed last.
+	export constexpr unsigned get_texel_block_extent(ImageFormat format)
+	{
+		return format >= ImageFormat::Bc1UNorm ? 4 : 1;
+	}
+
 	// Specifies a purpose for which an image will be used and for which there is a recommended memory layout to which it should
 	// be transitioned.
 	export enum class ImageLayout : uint8_t {
@@ -121,6 +207,18 @@ namespace vt
 		Presentable,
 	};
 
+	// Specifies how a buffer is accessed by the commands following a barrier, which determines what the barrier must wait for.
+	export enum class BufferAccess : uint8_t {
+		CopySource,
+		CopyDestination,
+		Vertex,
+		Index,
+		Uniform,
+		ShaderRead,
+		ShaderWrite, // Unordered access, including reads.
+		Indirect,
+	};
+
 	export enum class ImageDimension : uint8_t {
 		Image1D,
 		Image2D,
@@ -138,7 +236,7 @@ namespace vt
 		Storage			= bit(3),
 		ColorAttachment = bit(4),
 		DepthStencil	= bit(5),
-		Transient		= bit(6),
+		Transient		= bit(6), // Image only lives within a frame and can share memory with other transient resources.
 		InputAttachment = bit(7),
 	};
 	export template<> constexpr inline bool ENABLE_BIT_OPERATORS_FOR<ImageUsage> = true;
@@ -161,4 +259,39 @@ namespace vt
 			return static_cast<uint8_t>(count);
 		}
 	};
+
+	// Which kind of resources a transient heap holds. Some D3D12 hardware can't place buffers, attachments and other images
+	// in the same heap.
+	export enum class TransientHeapContents : uint8_t {
+		Buffers,
+		Images,
+		Attachments, // Images used as color or depth stencil attachments.
+	};
+
+	export constexpr TransientHeapContents get_transient_heap_contents(ImageUsage usage)
+	{
+		if(usage & ImageUsage::ColorAttachment || usage & ImageUsage::DepthStencil)
+			return TransientHeapContents::Attachments;
+		else
+			return TransientHeapContents::Images;
+	}
+
+	// Describes a block of GPU memory that transient resources can be placed into at any offset. Resources placed into
+	// overlapping ranges share memory, so only one of them can be in use at a time.
+	export struct TransientHeapSpecification
+	{
+		Positive<size_t>				size;
+		Explicit<TransientHeapContents> contents;
+		size_t							alignment	 = 0;		   // Largest alignment among the resources placed into it.
+		uint32_t						memory_types = UINT32_MAX; // Memory types suitable for all resources placed into it.
+	};
+
+	// How much memory a resource takes up in a transient heap, the alignment of the offset it can be placed at, and the
+	// bit mask of the memory types of the platform that it can be placed into.
+	export struct MemoryRequirements
+	{
+		size_t	 size		  = 0;
+		size_t	 alignment	  = 0;
+		uint32_t memory_types = UINT32_MAX;
+	};
 }
@@ -19,6 +19,10 @@ namespace vt
 		ByteAddressBuffer,
 		RwByteAddressBuffer,
 		InputAttachment,
+
+		// Dynamic buffers must be the only binding in their descriptor set layout besides samplers, with a count of 1.
+		DynamicUniformBuffer,	 // Uniform buffer bound at an offset given when binding the descriptor set.
+		DynamicStructuredBuffer, // Read-only structured buffer bound at an offset given when binding the descriptor set.
 	};
 
 	export enum class ShaderStage : uint8_t {
@@ -1,8 +1,12 @@
 module;
 #include "VitroCore/Macros.hpp"
+
+#include <cstdint>
+#include <utility>
 export module vt.Graphics.DescriptorSetLayout;
 
 import vt.Core.Array;
+import vt.Core.ContentHash;
 import vt.Core.Specification;
 import vt.Graphics.DescriptorBinding;
 import vt.Graphics.DynamicGpuApi;
@@ -17,7 +21,53 @@ namespace vt
 	using PlatformDescriptorSetLayout = ResourceVariant<VT_GPU_API_VARIANT_ARGS(DescriptorSetLayout)>;
 	export class DescriptorSetLayout : public PlatformDescriptorSetLayout
 	{
-		using PlatformDescriptorSetLayout::PlatformDescriptorSetLayout;
+	public:
+		// This constructor is for internal use only.
+		DescriptorSetLayout(PlatformDescriptorSetLayout&& platform_layout, DescriptorSetLayoutSpecification const& spec) :
+			PlatformDescriptorSetLayout(std::move(platform_layout)), content_hash(hash_specification(spec))
+		{}
+
+		// Layouts with equal content hashes are defined identically.
+		uint64_t get_content_hash() const
+		{
+			return content_hash;
+		}
+
+	private:
+		uint64_t content_hash;
+
+		static uint64_t hash_specification(DescriptorSetLayoutSpecification const& spec)
+		{
+			ContentHasher hasher;
+			hasher.add(spec.visibility.get());
+			hasher.add(spec.bindings.size());
+			for(auto& binding : spec.bindings)
+			{
+				hasher.add(binding.shader_register.get());
+				hasher.add(binding.type.get());
+
+				auto sampler = binding.static_sampler_spec;
+				hasher.add(sampler != nullptr);
+				if(sampler)
+				{
+					hasher.add(binding.static_sampler_visibility);
+					hasher.add(sampler->filter.get());
+					hasher.add(sampler->u_address_mode.get());
+					hasher.add(sampler->v_address_mode.get());
+					hasher.add(sampler->w_address_mode.get());
+					hasher.add(sampler->enable_compare);
+					hasher.add(sampler->mip_lod_bias);
+					hasher.add(sampler->max_anisotropy);
+					hasher.add(sampler->min_lod);
+					hasher.add(sampler->max_lod);
+					hasher.add(sampler->compare_op);
+					hasher.add(sampler->border_color);
+				}
+				else
+					hasher.add(binding.count.get());
+			}
+			return hasher.get();
+		}
 	};
 
 	export struct RootSignatureSpecification
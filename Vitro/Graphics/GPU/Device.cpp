@@ -1,10 +1,24 @@
 module;
 #include "VitroCore/Macros.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
 export module vt.Graphics.Device;
 
+import vt.Core.Array;
+import vt.Core.FlatHashMap;
+import vt.Core.SlotMap;
 import vt.Graphics.AbstractDevice;
+import vt.Graphics.AssetResource;
+import vt.Graphics.DynamicBufferAllocator;
 import vt.Graphics.DynamicGpuApi;
 import vt.Graphics.Handle;
+import vt.Graphics.PipelineSpecification;
+import vt.Graphics.Sampler;
+import vt.Graphics.UploadQueue;
 import vt.Graphics.VT_GPU_API_MODULE.Device;
 
 #if VT_DYNAMIC_GPU_API
@@ -13,10 +27,179 @@ import vt.Graphics.VT_GPU_API_MODULE_SECONDARY.Device;
 
 namespace vt
 {
+	export using BufferHandle		   = SlotHandle<Buffer>;
+	export using ImageHandle		   = SlotHandle<Image>;
+	export using SamplerHandle		   = SlotHandle<Sampler>;
+	export using RenderPipelineHandle  = SlotHandle<RenderPipeline>;
+	export using ComputePipelineHandle = SlotHandle<ComputePipeline>;
+
+	// Counts how often acquiring a pipeline could share an existing pipeline (hit) or had to make a new one (miss).
+	export struct PipelineRegistryStats
+	{
+		size_t hits	  = 0;
+		size_t misses = 0;
+	};
+
 	using PlatformDevice = InterfaceVariant<AbstractDevice, VT_GPU_API_VARIANT_ARGS(Device)>;
 	export class Device : public PlatformDevice
 	{
 	public:
 		using PlatformDevice::PlatformDevice;
+
+		// Transfers ownership of a resource to the device, which then refers to it through a handle that is cheap to copy
+		// and store in draw packets. Registering and unregistering must not happen concurrently with any other access to
+		// the registry of the same resource type, while lookups may happen concurrently.
+		template<typename T> SlotHandle<T> register_resource(T&& resource)
+		{
+			return get_registry<T>().insert(std::move(resource));
+		}
+
+		// Returns ownership of the resource to the caller, so that its destruction can be deferred until the GPU is done
+		// with it, such as by moving it into a deletion queue.
+		template<typename T> T unregister_resource(SlotHandle<T> handle)
+		{
+			return get_registry<T>().extract(handle);
+		}
+
+		template<typename T> T& get_resource(SlotHandle<T> handle) noexcept
+		{
+			return get_registry<T>()[handle];
+		}
+
+		template<typename T> T const& get_resource(SlotHandle<T> handle) const noexcept
+		{
+			return get_registry<T>()[handle];
+		}
+
+		// Returns null if the handle is stale or null.
+		template<typename T> T* find_resource(SlotHandle<T> handle) noexcept
+		{
+			return get_registry<T>().find(handle);
+		}
+
+		template<typename T> bool is_registered(SlotHandle<T> handle) const noexcept
+		{
+			return get_registry<T>().contains(handle);
+		}
+
+		// Destroys all registered resources of the given type at once. The GPU must no longer be using any of them.
+		template<typename T> void destroy_registered_resources()
+		{
+			get_registry<T>().clear();
+		}
+
+		// Returns a handle to a registered pipeline made from the specification. If a pipeline with an equal specification
+		// was acquired before and is not yet fully released, its handle is returned instead of making a new pipeline. Every
+		// acquisition must be matched by a call to release_pipeline, and shared pipelines must not be unregistered directly.
+		// The same synchronization rules apply as for registering resources.
+		RenderPipelineHandle acquire_render_pipeline(RenderPipelineSpecification const& spec)
+		{
+			return acquire_pipeline(spec, &AbstractDevice::make_render_pipelines);
+		}
+
+		ComputePipelineHandle acquire_compute_pipeline(ComputePipelineSpecification const& spec)
+		{
+			return acquire_pipeline(spec, &AbstractDevice::make_compute_pipelines);
+		}
+
+		// Gives up one acquisition of a pipeline. When the last one is given up, the pipeline is unregistered and returned, so
+		// that its destruction can be deferred until the GPU is done with it.
+		template<typename T> std::optional<T> release_pipeline(SlotHandle<T> handle)
+		{
+			auto& shared = std::get<SharedPipelines<T>>(shared_pipelines);
+
+			auto key = shared.keys_by_handle.find(pack_handle(handle));
+			VT_ASSERT(key != shared.keys_by_handle.end(), "Pipeline was not acquired or is already released.");
+
+			auto entry = shared.entries_by_key.find(key->second);
+			if(--entry->second.use_count != 0)
+				return std::nullopt;
+
+			shared.entries_by_key.erase(entry);
+			shared.keys_by_handle.erase(key);
+			return unregister_resource(handle);
+		}
+
+		PipelineRegistryStats get_pipeline_registry_stats() const noexcept
+		{
+			return pipeline_registry_stats;
+		}
+
+		// Returns the queue through which everything using the device uploads data from the CPU, so that all uploads of a
+		// frame share one staging ring and one submission. It is made on first use.
+		UploadQueue& get_upload_queue()
+		{
+			if(!upload_queue)
+				upload_queue.emplace(*PlatformDevice::operator->());
+			return *upload_queue;
+		}
+
+		// Returns the allocator through which everything using the device writes data that the GPU only reads in the frame it
+		// is written in. It moves on to the next frame once all window contexts have submitted their frames, and is made on
+		// first use.
+		DynamicBufferAllocator& get_dynamic_buffer_allocator()
+		{
+			if(!dynamic_buffer_allocator)
+				dynamic_buffer_allocator.emplace(*PlatformDevice::operator->());
+			return *dynamic_buffer_allocator;
+		}
+
+		template<typename T> SlotMap<T>& get_registry() noexcept
+		{
+			return std::get<SlotMap<T>>(registries);
+		}
+
+		template<typename T> SlotMap<T> const& get_registry() const noexcept
+		{
+			return std::get<SlotMap<T>>(registries);
+		}
+
+	private:
+		template<typename T> struct SharedPipelines
+		{
+			struct Entry
+			{
+				SlotHandle<T> handle;
+				unsigned	  use_count;
+			};
+			FlatHashMap<PipelineKey, Entry, PipelineKeyHash> entries_by_key;
+			FlatHashMap<uint64_t, PipelineKey>				 keys_by_handle;
+		};
+
+		std::tuple<SlotMap<Buffer>, SlotMap<Image>, SlotMap<Sampler>, SlotMap<RenderPipeline>, SlotMap<ComputePipeline>>
+			registries;
+		std::tuple<SharedPipelines<RenderPipeline>, SharedPipelines<ComputePipeline>> shared_pipelines;
+		PipelineRegistryStats														  pipeline_registry_stats;
+		std::optional<UploadQueue>													  upload_queue;
+		std::optional<DynamicBufferAllocator>										  dynamic_buffer_allocator;
+
+		template<typename T, typename S>
+		SlotHandle<T> acquire_pipeline(S const& spec, std::vector<T> (AbstractDevice::*make_pipelines)(ArrayView<S>))
+		{
+			auto& shared = std::get<SharedPipelines<T>>(shared_pipelines);
+
+			// Keys are compared in full, so specifications whose keys only share a hash get separate pipelines.
+			auto key = make_pipeline_key(spec);
+			if(auto entry = shared.entries_by_key.find(key); entry != shared.entries_by_key.end())
+			{
+				++pipeline_registry_stats.hits;
+				++entry->second.use_count;
+				return entry->second.handle;
+			}
+			++pipeline_registry_stats.misses;
+
+			AbstractDevice* device = PlatformDevice::operator->();
+
+			auto pipelines = (device->*make_pipelines)(spec);
+			auto handle	   = register_resource(std::move(pipelines.front()));
+			shared.keys_by_handle.try_emplace(pack_handle(handle), key);
+			shared.entries_by_key.try_emplace(std::move(key), handle, 1u);
+			return handle;
+		}
+
+		template<typename T> static uint64_t pack_handle(SlotHandle<T> handle) noexcept
+		{
+			return static_cast<uint64_t>(handle.index) << 32 | handle.generation;
+		}
 	};
 }
@@ -0,0 +1,129 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cstring>
+export module vt.Graphics.DynamicBufferAllocator;
+
+import vt.Core.Array;
+import vt.Core.FixedList;
+import vt.Core.SmallList;
+import vt.Graphics.AbstractCommandList;
+import vt.Graphics.AbstractDevice;
+import vt.Graphics.AssetResource;
+import vt.Graphics.AssetResourceSpecification;
+import vt.Graphics.Handle;
+import vt.Graphics.RingBuffer;
+
+namespace vt
+{
+	// A range of the buffer of the current frame, to be written by the CPU and bound through a dynamic buffer descriptor.
+	export struct DynamicAllocation
+	{
+		void*	 data;	 // Persistently mapped memory of the range, which must only be written to.
+		unsigned offset; // Dynamic offset at which to bind descriptor sets referring to the buffer of the current frame.
+	};
+
+	// Hands out ranges of one persistently mapped buffer per frame in flight by bumping an offset, for data that the GPU only
+	// reads in the frame it is written in, such as per-draw constants. Descriptor sets with a dynamic buffer descriptor are
+	// updated once per frame buffer and then bound at the offset of each allocation, so per-draw data needs no allocation,
+	// mapping or descriptor update. Allocating is thread-safe, but must not overlap with moving to the next frame.
+	export class DynamicBufferAllocator
+	{
+	public:
+		static constexpr size_t DEFAULT_FRAME_CAPACITY = 4 * 1024 * 1024;
+
+		DynamicBufferAllocator(AbstractDevice& device, size_t frame_capacity = DEFAULT_FRAME_CAPACITY) :
+			device(device), capacity(frame_capacity)
+		{
+			VT_ENSURE(frame_capacity <= UINT_MAX, "Dynamic offsets cannot address frame buffers of this size.");
+
+			for(unsigned i = 0; i != MAX_FRAMES_IN_FLIGHT; ++i)
+			{
+				auto& frame	 = frames.emplace_back(make_frame_buffer(device, frame_capacity));
+				frame.mapped = static_cast<char*>(device.map(frame.buffer));
+			}
+		}
+
+		~DynamicBufferAllocator()
+		{
+			for(auto& frame : frames)
+			{
+				for(auto token : frame.tokens)
+					device.wait_for_workload(token);
+
+				device.unmap(frame.buffer);
+			}
+		}
+
+		// Returns a range of at least the given size in the buffer of the current frame, which stays valid until the frame
+		// comes up again.
+		DynamicAllocation allocate(size_t size)
+		{
+			// Sizes are rounded up so that the head stays aligned and a single addition claims the range.
+			size_t const alignment	  = DYNAMIC_OFFSET_ALIGNMENT;
+			size_t const aligned_size = (size + alignment - 1) / alignment * alignment;
+			size_t const offset		  = head.fetch_add(aligned_size, std::memory_order_relaxed);
+			VT_ENSURE(offset + size <= capacity, "The dynamic buffer of the current frame is full.");
+
+			return {frames[index].mapped + offset, static_cast<unsigned>(offset)};
+		}
+
+		// Copies the object into a new allocation and returns the dynamic offset to bind it at.
+		template<typename T> unsigned push(T const& object)
+		{
+			auto allocation = allocate(sizeof object);
+			std::memcpy(allocation.data, &object, sizeof object);
+			return allocation.offset;
+		}
+
+		// Returns the buffer of the frame at the given index, to which descriptors can refer. Dynamic descriptors must cover
+		// no more bytes than the allocations they are bound at, since the covered range must fit into the buffer.
+		Buffer const& get_buffer(unsigned frame_index) const
+		{
+			return frames[frame_index].buffer;
+		}
+
+		unsigned get_current_frame_index() const
+		{
+			return index;
+		}
+
+		// Moves on to the buffer of the next frame, waiting until the GPU is done with it. The tokens must include every
+		// submission that used allocations of the current frame.
+		void move_to_next_frame(ConstSpan<SyncToken> frame_tokens)
+		{
+			frames[index].tokens.assign(frame_tokens.begin(), frame_tokens.end());
+
+			index = (index + 1) % MAX_FRAMES_IN_FLIGHT;
+			head.store(0, std::memory_order_relaxed);
+			for(auto token : frames[index].tokens)
+				device.wait_for_workload(token);
+		}
+
+	private:
+		struct Frame
+		{
+			Buffer				 buffer;
+			char*				 mapped = nullptr;
+			SmallList<SyncToken> tokens; // Submissions that used allocations of the frame when it was last current.
+		};
+
+		AbstractDevice&						   device;
+		FixedList<Frame, MAX_FRAMES_IN_FLIGHT> frames;
+		size_t								   capacity;
+		std::atomic<size_t>					   head	 = 0; // Offset after the last allocation of the current frame.
+		unsigned							   index = 0;
+
+		static Buffer make_frame_buffer(AbstractDevice& device, size_t capacity)
+		{
+			BufferSpecification const spec {
+				.size	= capacity,
+				.stride = 1,
+				.usage	= BufferUsage::Uniform | BufferUsage::Storage | BufferUsage::Upload,
+			};
+			return device.make_buffer(spec);
+		}
+	};
+}
@@ -1,8 +1,14 @@
 module;
+#include "VitroCore/Macros.hpp"
+
 #include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
 export module vt.Graphics.PipelineSpecification;
 
 import vt.Core.Array;
+import vt.Core.ContentHash;
 import vt.Core.Enum;
 import vt.Core.FixedList;
 import vt.Core.Specification;
@@ -29,6 +35,22 @@ namespace vt
 		BlendIndices,
 	};
 
+	// How a vertex attribute is laid out in the vertex buffer. Shaders receive normalized formats as floats in [0, 1] or
+	// [-1, 1], and halves as floats.
+	export enum class VertexFormat : uint8_t {
+		Default, // 32-bit floats for all data types except blend indices, which are 32-bit unsigned integers.
+		Float,
+		Float2,
+		Float3,
+		Float4,
+		Half2,
+		Half4,
+		UInt,
+		UNormRgba8,	  // As packed by pack_unorm_rgba8.
+		UNormRgb10A2, // As packed by pack_unorm_rgb10a2.
+		SNorm16x2,	  // Used for octahedral normals as packed by pack_octahedral_normal.
+	};
+
 	// Specifies whether a vertex buffer binding holds per-vertex or per-instance data.
 	export enum class VertexBufferInputRate : uint8_t {
 		PerVertex,
@@ -136,6 +158,7 @@ namespace vt
 	{
 		Explicit<VertexDataType> type;
 		uint8_t					 semantic_index = 0;
+		VertexFormat			 format			= VertexFormat::Default;
 	};
 
 	export struct VertexBufferBinding
@@ -232,10 +255,14 @@ namespace vt
 		Shader const&		 compute_shader;
 	};
 
-	export size_t get_vertex_data_type_size(VertexDataType type)
+	// Resolves the default format to the concrete format used for the attribute's data type.
+	export VertexFormat get_vertex_attribute_format(VertexAttribute const& attribute)
 	{
+		if(attribute.format != VertexFormat::Default)
+			return attribute.format;
+
 		using enum VertexDataType;
-		switch(type)
+		switch(attribute.type)
 		{
 			case Position:
 			case TransformedPosition:
@@ -243,11 +270,155 @@ namespace vt
 			case Normal:
 			case Binormal:
 			case Tangent:
-			case Color: return sizeof(Float4);
+			case Color: return VertexFormat::Float4;
 			case PointSize:
-			case BlendWeight: return sizeof(float);
-			case BlendIndices: return sizeof(unsigned);
+			case BlendWeight: return VertexFormat::Float;
+			case BlendIndices: return VertexFormat::UInt;
+		}
+		VT_UNREACHABLE();
+	}
+
+	export size_t get_vertex_attribute_size(VertexAttribute const& attribute)
+	{
+		using enum VertexFormat;
+		switch(get_vertex_attribute_format(attribute))
+		{
+			case Float: return sizeof(float);
+			case Float2: return 2 * sizeof(float);
+			case Float3: return 3 * sizeof(float);
+			case Float4: return 4 * sizeof(float);
+			case Half2: return 2 * sizeof(uint16_t);
+			case Half4: return 4 * sizeof(uint16_t);
+			case UInt:
+			case UNormRgba8:
+			case UNormRgb10A2:
+			case SNorm16x2: return sizeof(uint32_t);
+			case Default: break;
 		}
-		return 0;
+		VT_UNREACHABLE();
+	}
+
+	// Canonical form of everything that determines the pipeline made from a specification, so that pipelines made from
+	// specifications with equal keys are interchangeable. Shaders are represented by their content hash, render passes by
+	// their compatibility hash and root signatures by their layout hash, since they don't keep their specification. Both
+	// APIs accept a pipeline together with any identically defined root signature.
+	export class PipelineKey
+	{
+	public:
+		void add_bytes(void const* data, size_t size)
+		{
+			auto bytes = static_cast<unsigned char const*>(data);
+			content.insert(content.end(), bytes, bytes + size);
+		}
+
+		// Only scalars are accepted, because padding bytes in class types would make keys of equal specifications differ.
+		template<typename T>
+		requires std::is_scalar_v<T>
+		void add(T value)
+		{
+			add_bytes(&value, sizeof value);
+		}
+
+		uint64_t get_hash() const noexcept
+		{
+			return hash_content(content.data(), content.size());
+		}
+
+		bool operator==(PipelineKey const&) const = default;
+
+	private:
+		std::vector<unsigned char> content;
+	};
+
+	export struct PipelineKeyHash
+	{
+		size_t operator()(PipelineKey const& key) const noexcept
+		{
+			return key.get_hash();
+		}
+	};
+
+	export PipelineKey make_pipeline_key(RenderPipelineSpecification const& spec)
+	{
+		PipelineKey key;
+		key.add(spec.root_signature.get_layout_hash());
+		key.add(spec.render_pass.get_compatibility_hash());
+
+		auto add_shader = [&](Shader const* shader) {
+			key.add(shader ? shader->get_content_hash() : 0);
+		};
+		add_shader(&spec.vertex_shader);
+		add_shader(spec.hull_shader);
+		add_shader(spec.domain_shader);
+		add_shader(spec.fragment_shader);
+
+		key.add(spec.vertex_buffer_bindings.size());
+		for(auto& binding : spec.vertex_buffer_bindings)
+		{
+			key.add(binding.input_rate);
+			key.add(binding.attributes.size());
+			for(auto attribute : binding.attributes)
+			{
+				key.add(attribute.type.get());
+				key.add(attribute.semantic_index);
+				key.add(get_vertex_attribute_format(attribute));
+			}
+		}
+		key.add(spec.primitive_topology.get());
+		key.add(spec.patch_list_control_point_count);
+		key.add(spec.enable_primitive_restart);
+		key.add(spec.subpass_index.get());
+
+		auto& rasterizer = spec.rasterizer;
+		key.add(rasterizer.fill_mode);
+		key.add(rasterizer.cull_mode.get());
+		key.add(rasterizer.winding_order.get());
+		key.add(rasterizer.depth_bias);
+		key.add(rasterizer.depth_bias_clamp);
+		key.add(rasterizer.depth_bias_slope);
+
+		auto& depth_stencil = spec.depth_stencil;
+		key.add(depth_stencil.enable_depth_test);
+		key.add(depth_stencil.enable_depth_write);
+		key.add(depth_stencil.depth_compare_op);
+		key.add(depth_stencil.enable_depth_bounds_test);
+		key.add(depth_stencil.enable_stencil_test);
+		key.add(depth_stencil.stencil_read_mask);
+		key.add(depth_stencil.stencil_write_mask);
+		for(auto stencil_op : {depth_stencil.front, depth_stencil.back})
+		{
+			key.add(stencil_op.fail_op);
+			key.add(stencil_op.pass_op);
+			key.add(stencil_op.depth_fail_op);
+			key.add(stencil_op.compare_op);
+		}
+
+		key.add(spec.multisample.sample_mask);
+		key.add(spec.multisample.sample_count.get());
+		key.add(spec.multisample.enable_alpha_to_coverage);
+
+		key.add(spec.blend.attachment_states.size());
+		for(auto attachment : spec.blend.attachment_states)
+		{
+			key.add(attachment.enable_blend);
+			key.add(attachment.src_color_factor);
+			key.add(attachment.dst_color_factor);
+			key.add(attachment.color_op);
+			key.add(attachment.src_alpha_factor);
+			key.add(attachment.dst_alpha_factor);
+			key.add(attachment.alpha_op);
+			key.add(attachment.write_mask);
+		}
+		key.add(spec.blend.enable_logic_op);
+		key.add(spec.blend.logic_op);
+		return key;
+	}
+
+	export PipelineKey make_pipeline_key(ComputePipelineSpecification const& spec)
+	{
+		PipelineKey key;
+		key.add(spec.root_signature.get_layout_hash());
+		key.add(spec.compute_shader.get_content_hash());
+		return key;
 	}
 }
@@ -3,21 +3,66 @@ module;
 #include "VitroCore/Macros.hpp"
 export module vt.Graphics.D3D12.Buffer;
 
+import vt.Core.LookupTable;
 import vt.Graphics.AssetResourceSpecification;
 import vt.Graphics.D3D12.DescriptorPool;
 import vt.Graphics.D3D12.Resource;
+import vt.Graphics.D3D12.TransientHeap;
 
 namespace vt::d3d12
 {
+	export constexpr inline auto BUFFER_ACCESS_LOOKUP = [] {
+		LookupTable<BufferAccess, D3D12_RESOURCE_STATES> _;
+		using enum BufferAccess;
+
+		_[CopySource]	   = D3D12_RESOURCE_STATE_COPY_SOURCE;
+		_[CopyDestination] = D3D12_RESOURCE_STATE_COPY_DEST;
+		_[Vertex]		   = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+		_[Index]		   = D3D12_RESOURCE_STATE_INDEX_BUFFER;
+		_[Uniform]		   = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+		_[ShaderRead]	   = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+		_[ShaderWrite]	   = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+		_[Indirect]		   = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+		return _;
+	}();
+
 	export class D3D12Buffer : public Resource
 	{
 	public:
 		D3D12Buffer(BufferSpecification const& spec, ID3D12Device4& device, D3D12MA::Allocator& allocator, DescriptorPool& pool)
 		{
+			buffer_resource = true;
 			initialize_resource(spec, allocator);
 			initialize_descriptor(spec, device, pool);
 		}
 
+		// Places the buffer into the transient heap at the given offset instead of giving it its own memory.
+		D3D12Buffer(BufferSpecification const& spec,
+					ID3D12Device4&			   device,
+					D3D12MA::Allocator&		   allocator,
+					DescriptorPool&			   pool,
+					D3D12TransientHeap const&  heap,
+					size_t					   offset)
+		{
+			VT_ASSERT(!(spec.usage.get() & (BufferUsage::Upload | BufferUsage::Readback)),
+					  "Transient heaps are not visible to the CPU.");
+
+			buffer_resource	   = true;
+			auto resource_desc = fill_resource_desc(spec);
+
+			auto result = allocator.CreateAliasingResource(heap.get_allocation(), offset, &resource_desc,
+														   D3D12_RESOURCE_STATE_COMMON, nullptr, VT_COM_OUT(resource));
+			VT_CHECK_RESULT(result, "Failed to create placed D3D12 buffer.");
+			initialize_descriptor(spec, device, pool);
+		}
+
+		static MemoryRequirements get_memory_requirements(BufferSpecification const& spec, ID3D12Device4& device)
+		{
+			auto resource_desc = fill_resource_desc(spec);
+			auto info		   = device.GetResourceAllocationInfo(0, 1, &resource_desc);
+			return {info.SizeInBytes, info.Alignment};
+		}
+
 	private:
 		static D3D12_RESOURCE_DESC fill_resource_desc(BufferSpecification const& spec)
 		{
@@ -65,6 +110,9 @@ namespace vt::d3d12
 			auto result		   = allocator.CreateResource(&allocation_desc, &resource_desc, initial_state, nullptr,
 													  std::out_ptr(allocation), VT_COM_OUT(resource));
 			VT_CHECK_RESULT(result, "Failed to create D3D12 buffer.");
+
+			state		= initial_state;
+			fixed_state = heap_type != D3D12_HEAP_TYPE_DEFAULT;
 		}
 
 		void initialize_descriptor(BufferSpecification const& spec, ID3D12Device4& device, DescriptorPool& pool)
@@ -72,6 +120,11 @@ namespace vt::d3d12
 			auto usage = spec.usage.get();
 			using enum BufferUsage;
 
+			// Upload buffers can't hold unordered access views, and ones large enough to be sub-allocated exceed the size limit
+			// of constant buffer views, so shaders only access them through root descriptors.
+			if(usage & Upload)
+				return;
+
 			if(usage & RwUntyped || usage & Storage)
 			{
 				descriptor = pool.allocate_cbv_srv_uav();
@@ -2,6 +2,7 @@ module;
 #include "D3D12API.hpp"
 #include "VitroCore/Macros.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <type_traits>
 export module vt.Graphics.D3D12.CommandList;
@@ -11,13 +12,17 @@ import vt.Core.FixedList;
 import vt.Core.LookupTable;
 import vt.Core.Rect;
 import vt.Core.SmallList;
+import vt.Graphics.D3D12.Buffer;
 import vt.Graphics.D3D12.DescriptorPool;
 import vt.Graphics.D3D12.Handle;
+import vt.Graphics.D3D12.Image;
 import vt.Graphics.D3D12.RenderPass;
 import vt.Graphics.D3D12.RenderTarget;
+import vt.Graphics.D3D12.Resource;
 import vt.Graphics.D3D12.RootSignature;
 import vt.Graphics.AssetResource;
 import vt.Graphics.AbstractCommandList;
+import vt.Graphics.AssetResourceSpecification;
 import vt.Graphics.DescriptorSet;
 import vt.Graphics.Handle;
 import vt.Graphics.PipelineSpecification;
@@ -37,6 +42,16 @@ namespace vt::d3d12
 		return _;
 	}();
 
+	constexpr D3D12_RESOURCE_STATES WRITE_STATES = D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_UNORDERED_ACCESS |
+												   D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_DEPTH_WRITE |
+												   D3D12_RESOURCE_STATE_STREAM_OUT | D3D12_RESOURCE_STATE_RESOLVE_DEST;
+
+	// Images can only be implicitly promoted from the common state to these states.
+	constexpr D3D12_RESOURCE_STATES PROMOTABLE_IMAGE_STATES = D3D12_RESOURCE_STATE_COPY_SOURCE |
+															  D3D12_RESOURCE_STATE_COPY_DEST |
+															  D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE |
+															  D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+
 	template<CommandType> class CommandListData;
 
 	template<> class CommandListData<CommandType::Copy>
@@ -61,6 +76,7 @@ namespace vt::d3d12
 		D3D_PRIMITIVE_TOPOLOGY				   bound_primitive_topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
 		unsigned							   subpass_index;
 		FixedList<ClearValue, MAX_ATTACHMENTS> clear_values;
+		bool								   is_bundle;
 	};
 
 	export template<CommandType TYPE>
@@ -71,8 +87,11 @@ namespace vt::d3d12
 						 DescriptorPool&		 descriptor_pool,
 						 ID3D12CommandSignature* dispatch_signature,
 						 ID3D12CommandSignature* draw_signature,
-						 ID3D12CommandSignature* draw_indexed_signature)
+						 ID3D12CommandSignature* draw_indexed_signature,
+						 bool					 is_bundle = false)
 		{
+			VT_ASSERT(TYPE == CommandType::Render || !is_bundle, "Only render command lists can be secondary command lists.");
+
 			if constexpr(TYPE != CommandType::Copy)
 			{
 				this->descriptor_pool	 = &descriptor_pool;
@@ -82,12 +101,14 @@ namespace vt::d3d12
 			{
 				this->draw_signature		 = draw_signature;
 				this->draw_indexed_signature = draw_indexed_signature;
+				this->is_bundle				 = is_bundle;
 			}
 
-			auto result = device.CreateCommandAllocator(COMMAND_TYPE_LOOKUP[TYPE], VT_COM_OUT(allocator));
+			auto type	= is_bundle ? D3D12_COMMAND_LIST_TYPE_BUNDLE : COMMAND_TYPE_LOOKUP[TYPE];
+			auto result = device.CreateCommandAllocator(type, VT_COM_OUT(allocator));
 			VT_CHECK_RESULT(result, "Failed to create D3D12 command allocator.");
 
-			result = device.CreateCommandList1(0, COMMAND_TYPE_LOOKUP[TYPE], D3D12_COMMAND_LIST_FLAG_NONE, VT_COM_OUT(cmd));
+			result = device.CreateCommandList1(0, type, D3D12_COMMAND_LIST_FLAG_NONE, VT_COM_OUT(cmd));
 			VT_CHECK_RESULT(result, "Failed to create D3D12 command list.");
 		}
 
@@ -100,6 +121,15 @@ namespace vt::d3d12
 		{
 			auto result = allocator->Reset();
 			VT_CHECK_RESULT(result, "Failed to reset D3D12 command allocator.");
+
+			// States advance as barriers are planned, so those of barriers that were never recorded are rolled back.
+			for(auto [resource, original] : original_states)
+				resource->get_state() = original;
+			original_states.clear();
+			pending_barriers.clear();
+			decaying_resources.clear();
+			barrier_count	   = 0;
+			inside_render_pass = false;
 		}
 
 		void begin()
@@ -119,6 +149,14 @@ namespace vt::d3d12
 
 		void end()
 		{
+			flush_barriers();
+
+			// Resources that decay to the common state once the command list has executed are expected to be in it by the
+			// next command list that uses them.
+			for(auto resource : decaying_resources)
+				resource->get_state() = D3D12_RESOURCE_STATE_COMMON;
+			decaying_resources.clear();
+
 			auto result = cmd->Close();
 			VT_CHECK_RESULT(result, "Failed to end D3D12 command list.");
 
@@ -126,23 +164,88 @@ namespace vt::d3d12
 				this->bound_primitive_topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
 		}
 
+		void require(Buffer const& buffer, BufferAccess access)
+		{
+			require_state(buffer.d3d12, BUFFER_ACCESS_LOOKUP[access]);
+		}
+
+		void require(Image const& image, ImageLayout layout)
+		{
+			require_state(image.d3d12, IMAGE_LAYOUT_LOOKUP[layout]);
+		}
+
+		// D3D12 has no queue ownership, so resources are handed to other queues in the common state, which buffers and
+		// resources used by copy command lists decay to anyway.
+		void transition(Buffer const& buffer, BufferAccess access, CommandType next_queue)
+		{
+			if(next_queue == TYPE)
+				require(buffer, access);
+		}
+
+		void transition(Image const& image, ImageLayout layout, CommandType next_queue)
+		{
+			if(next_queue == TYPE)
+				require(image, layout);
+			else if(TYPE != CommandType::Copy)
+				require_state(image.d3d12, D3D12_RESOURCE_STATE_COMMON);
+		}
+
+		void alias(Buffer const& buffer)
+		{
+			assert_outside_render_pass();
+			add_aliasing_barrier(buffer.d3d12);
+		}
+
+		void alias(Image const& image)
+		{
+			assert_outside_render_pass();
+			auto& resource = image.d3d12;
+			add_aliasing_barrier(resource);
+
+			// Placed render targets and depth stencils must be initialized after aliasing, which discarding does without
+			// touching their memory. Discarding requires them to be in their writable attachment state.
+			auto const flags = resource.get_resource()->GetDesc().Flags;
+			if(flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+			{
+				VT_ASSERT(TYPE == CommandType::Render, "Placed attachments can only be aliased on render command lists.");
+				require_state(resource, flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET ? D3D12_RESOURCE_STATE_RENDER_TARGET
+																						: D3D12_RESOURCE_STATE_DEPTH_WRITE);
+				flush_barriers();
+				cmd->DiscardResource(resource.get_resource(), nullptr);
+			}
+		}
+
+		unsigned count_barriers() const
+		{
+			return barrier_count;
+		}
+
 		void copy_buffer(Buffer const& src, Buffer& dst)
 		{
+			require_copy(src.d3d12, dst.d3d12);
+
 			cmd->CopyResource(dst.d3d12.get_resource(), src.d3d12.get_resource());
 		}
 
 		void copy_image(Image const& src, Image& dst)
 		{
+			require_copy(src.d3d12, dst.d3d12);
+
 			cmd->CopyResource(dst.d3d12.get_resource(), src.d3d12.get_resource());
 		}
 
 		void copy_buffer_to_image(Buffer const& src, Image& dst)
 		{
+			require_copy(src.d3d12, dst.d3d12);
+
 			cmd->CopyResource(dst.d3d12.get_resource(), src.d3d12.get_resource());
 		}
 
 		void update_buffer(Buffer& dst, size_t offset, size_t size, void const* data)
 		{
+			require_state(dst.d3d12, D3D12_RESOURCE_STATE_COPY_DEST);
+			flush_barriers();
+
 			SmallList<D3D12_WRITEBUFFERIMMEDIATE_PARAMETER> params(size / sizeof(DWORD));
 
 			auto param	 = params.begin();
@@ -163,11 +266,15 @@ namespace vt::d3d12
 
 		void copy_buffer_region(Buffer const& src, Buffer& dst, size_t src_offset, size_t dst_offset, size_t size)
 		{
+			require_copy(src.d3d12, dst.d3d12);
+
 			cmd->CopyBufferRegion(dst.d3d12.get_resource(), dst_offset, src.d3d12.get_resource(), src_offset, size);
 		}
 
 		void copy_image_region(Image const& src, Image& dst, ImageCopyRegion const& region)
 		{
+			require_copy(src.d3d12, dst.d3d12);
+
 			D3D12_TEXTURE_COPY_LOCATION const source {
 				.pResource		  = src.d3d12.get_resource(),
 				.Type			  = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
@@ -192,6 +299,37 @@ namespace vt::d3d12
 			cmd->CopyTextureRegion(&destination, dst_x, dst_y, dst_z, &source, &box);
 		}
 
+		void copy_buffer_region_to_image(Buffer const& src, Image& dst, BufferImageCopyRegion const& region)
+		{
+			require_copy(src.d3d12, dst.d3d12);
+
+			// Footprints of block-compressed formats must cover whole blocks, even in mips smaller than a block.
+			unsigned const extent = get_texel_block_extent(dst.get_format());
+			unsigned const width  = std::max(dst.get_width() >> region.dst_mip, 1);
+			unsigned const height = std::max(dst.get_height() >> region.dst_mip, 1);
+
+			D3D12_TEXTURE_COPY_LOCATION const source {
+				.pResource = src.d3d12.get_resource(),
+				.Type	   = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+				.PlacedFootprint {
+					.Offset = region.src_offset,
+					.Footprint {
+						.Format	  = IMAGE_FORMAT_LOOKUP[dst.get_format()],
+						.Width	  = (width + extent - 1) / extent * extent,
+						.Height	  = (height + extent - 1) / extent * extent,
+						.Depth	  = 1,
+						.RowPitch = static_cast<UINT>(region.row_pitch),
+					},
+				},
+			};
+			D3D12_TEXTURE_COPY_LOCATION const destination {
+				.pResource		  = dst.d3d12.get_resource(),
+				.Type			  = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+				.SubresourceIndex = region.dst_mip + region.dst_array_index * dst.count_mips(),
+			};
+			cmd->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+		}
+
 		void bind_compute_pipeline(ComputePipeline const& pipeline)
 		{
 			cmd->SetPipelineState(pipeline.d3d12.get_handle());
@@ -205,7 +343,12 @@ namespace vt::d3d12
 
 		void bind_compute_descriptors(ArrayView<DescriptorSet> descriptor_sets)
 		{
-			bind_descriptor_sets<false>(descriptor_sets, this->bound_compute_root_indices);
+			bind_descriptor_sets<false>(descriptor_sets, this->bound_compute_root_indices, {});
+		}
+
+		void bind_compute_descriptors(ArrayView<DescriptorSet> descriptor_sets, ArrayView<unsigned> dynamic_offsets)
+		{
+			bind_descriptor_sets<false>(descriptor_sets, this->bound_compute_root_indices, dynamic_offsets);
 		}
 
 		void push_compute_constants(size_t byte_offset, size_t byte_size, void const* data)
@@ -220,27 +363,34 @@ namespace vt::d3d12
 
 		void dispatch(unsigned x_count, unsigned y_count, unsigned z_count)
 		{
+			flush_barriers();
 			cmd->Dispatch(x_count, y_count, z_count);
 		}
 
 		void dispatch_indirect(Buffer const& buffer, size_t offset)
 		{
+			require(buffer, BufferAccess::Indirect);
+			flush_barriers();
 			cmd->ExecuteIndirect(this->dispatch_signature, 1, buffer.d3d12.get_resource(), offset, nullptr, 0);
 		}
 
 		void begin_render_pass(RenderPass const&	 render_pass,
 							   RenderTarget const&	 render_target,
-							   ConstSpan<ClearValue> clear_values = {})
+							   ConstSpan<ClearValue> clear_values = {},
+							   SubpassContents		 = SubpassContents::Inline)
 		{
+			flush_barriers();
+
 			this->bound_render_pass	  = render_pass.d3d12.get_data_for_command_list();
 			this->bound_render_target = render_target.d3d12.get_data_for_command_list();
 			this->clear_values.assign(clear_values.begin(), clear_values.end());
 
 			begin_subpass(0);
 			this->subpass_index = 1;
+			inside_render_pass	= true;
 		}
 
-		void change_subpass()
+		void change_subpass(SubpassContents = SubpassContents::Inline)
 		{
 			VT_ASSERT(this->subpass_index < this->bound_render_pass.count_subpasses() - 1,
 					  "All subpasses of this render pass have already been transitioned through.");
@@ -252,6 +402,7 @@ namespace vt::d3d12
 		void end_render_pass()
 		{
 			cmd->EndRenderPass();
+			inside_render_pass = false;
 
 			auto& final_transitions = this->bound_render_pass.get_final_transitions();
 
@@ -274,6 +425,28 @@ namespace vt::d3d12
 			cmd->ResourceBarrier(count(barriers), barriers.data());
 		}
 
+		void assume_attachment_layout(Image const& image, ImageLayout final_layout)
+		{
+			image.d3d12.get_state() = IMAGE_LAYOUT_LOOKUP[final_layout];
+		}
+
+		// Bundles inherit the render pass, so they don't need to know which one they are executed in.
+		void begin_secondary(RenderPass const&, unsigned, RenderTarget const&)
+		{
+			VT_ASSERT(this->is_bundle, "Only secondary command lists can be begun inside a render pass.");
+			begin();
+			inside_render_pass = true;
+		}
+
+		void execute_secondary_commands(ArrayView<CommandListHandle> cmds)
+		{
+			for(auto bundle : cmds)
+				cmd->ExecuteBundle(static_cast<ID3D12GraphicsCommandList*>(bundle.d3d12));
+
+			// State changed by a bundle carries over, so the topology has to be set again for the next pipeline.
+			this->bound_primitive_topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+		}
+
 		void bind_render_pipeline(RenderPipeline const& pipeline)
 		{
 			cmd->SetPipelineState(pipeline.d3d12.get_handle());
@@ -294,7 +467,12 @@ namespace vt::d3d12
 
 		void bind_render_descriptors(ArrayView<DescriptorSet> descriptor_sets)
 		{
-			bind_descriptor_sets<true>(descriptor_sets, this->bound_render_root_indices);
+			bind_descriptor_sets<true>(descriptor_sets, this->bound_render_root_indices, {});
+		}
+
+		void bind_render_descriptors(ArrayView<DescriptorSet> descriptor_sets, ArrayView<unsigned> dynamic_offsets)
+		{
+			bind_descriptor_sets<true>(descriptor_sets, this->bound_render_root_indices, dynamic_offsets);
 		}
 
 		void push_render_constants(size_t byte_offset, size_t byte_size, void const* data)
@@ -337,12 +515,18 @@ namespace vt::d3d12
 		{
 			static_assert(std::is_layout_compatible_v<Viewport, D3D12_VIEWPORT>);
 
+			if(this->is_bundle) // Bundles inherit viewports and cannot set them.
+				return;
+
 			auto data = reinterpret_cast<D3D12_VIEWPORT const*>(viewports.data());
 			cmd->RSSetViewports(count(viewports), data);
 		}
 
 		void set_scissors(ArrayView<Rectangle> scissors)
 		{
+			if(this->is_bundle) // Bundles inherit scissors and cannot set them.
+				return;
+
 			FixedList<D3D12_RECT, MAX_ATTACHMENTS> rects(scissors.size());
 
 			auto rect = rects.begin();
@@ -388,17 +572,142 @@ namespace vt::d3d12
 
 		void draw_indirect(Buffer const& buffer, size_t offset, unsigned draws)
 		{
+			assert_indirect_access(buffer);
 			cmd->ExecuteIndirect(this->draw_signature, draws, buffer.d3d12.get_resource(), offset, nullptr, 0);
 		}
 
 		void draw_indexed_indirect(Buffer const& buffer, size_t offset, unsigned draws)
 		{
+			assert_indirect_access(buffer);
 			cmd->ExecuteIndirect(this->draw_indexed_signature, draws, buffer.d3d12.get_resource(), offset, nullptr, 0);
 		}
 
 	private:
+		struct OriginalState
+		{
+			Resource const*		  resource;
+			D3D12_RESOURCE_STATES original;
+		};
+
 		ComUnique<ID3D12CommandAllocator>	  allocator;
 		ComUnique<ID3D12GraphicsCommandList4> cmd;
+		SmallList<D3D12_RESOURCE_BARRIER>	  pending_barriers;
+		SmallList<Resource const*>			  decaying_resources;
+		SmallList<OriginalState>			  original_states; // States from before the first change since the last flush.
+		unsigned							  barrier_count		 = 0;
+		bool								  inside_render_pass = false; // Also true while recording a bundle.
+
+		static bool is_read_only(D3D12_RESOURCE_STATES state)
+		{
+			return !(state & WRITE_STATES);
+		}
+
+		// Barriers cannot be recorded inside a render pass, and bundles, which may be recorded in parallel, must not touch
+		// the resource states shared by all command lists.
+		void assert_outside_render_pass() const
+		{
+			VT_ASSERT(!inside_render_pass, "Resource states cannot change inside a render pass or secondary command list.");
+		}
+
+		void assert_indirect_access(Buffer const& buffer) const
+		{
+			auto& resource = buffer.d3d12;
+			VT_ASSERT(resource.has_fixed_state() || resource.get_state() & D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT,
+					  "Indirect arguments must be required for indirect access before the render pass begins.");
+		}
+
+		// Adds the barrier needed to bring the resource into the next state to the pending barriers, unless the resource can
+		// be implicitly promoted from the common state.
+		void require_state(Resource const& resource, D3D12_RESOURCE_STATES next)
+		{
+			assert_outside_render_pass();
+			if(resource.has_fixed_state())
+				return;
+
+			auto& state = resource.get_state();
+
+			auto is_remembered = [&](OriginalState const& original) {
+				return original.resource == &resource;
+			};
+			if(std::none_of(original_states.begin(), original_states.end(), is_remembered))
+				original_states.emplace_back(&resource, state);
+
+			if(state == next)
+			{
+				if(next == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+				{
+					auto& barrier = pending_barriers.emplace_back();
+					barrier.Type  = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+					barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+					barrier.UAV	  = {
+						  .pResource = resource.get_resource(),
+					  };
+				}
+				return;
+			}
+
+			bool const reads_only = is_read_only(state) && is_read_only(next);
+			if(reads_only && state != D3D12_RESOURCE_STATE_COMMON && (state & next) == next)
+				return;
+
+			bool const decays = TYPE == CommandType::Copy || resource.is_buffer();
+			if(state == D3D12_RESOURCE_STATE_COMMON && (resource.is_buffer() || !(next & ~PROMOTABLE_IMAGE_STATES)))
+			{
+				// Implicitly promoted images decay only if they were promoted to a read-only state.
+				if(decays || is_read_only(next))
+					decaying_resources.emplace_back(&resource);
+
+				state = next;
+				return;
+			}
+
+			auto after = reads_only && state != D3D12_RESOURCE_STATE_COMMON ? state | next : next;
+			pending_barriers.emplace_back(D3D12_RESOURCE_BARRIER {
+				.Type  = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+				.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+				.Transition {
+					.pResource	 = resource.get_resource(),
+					.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+					.StateBefore = state,
+					.StateAfter	 = after,
+				},
+			});
+			if(decays)
+				decaying_resources.emplace_back(&resource);
+
+			state = after;
+		}
+
+		// Leaving the resource before the barrier unspecified makes the barrier wait for all work using any placed resource.
+		void add_aliasing_barrier(Resource const& resource)
+		{
+			pending_barriers.emplace_back(D3D12_RESOURCE_BARRIER {
+				.Type  = D3D12_RESOURCE_BARRIER_TYPE_ALIASING,
+				.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+				.Aliasing {
+					.pResourceBefore = nullptr,
+					.pResourceAfter	 = resource.get_resource(),
+				},
+			});
+		}
+
+		void require_copy(Resource const& src, Resource const& dst)
+		{
+			require_state(src, D3D12_RESOURCE_STATE_COPY_SOURCE);
+			require_state(dst, D3D12_RESOURCE_STATE_COPY_DEST);
+			flush_barriers();
+		}
+
+		void flush_barriers()
+		{
+			original_states.clear();
+			if(pending_barriers.empty())
+				return;
+
+			cmd->ResourceBarrier(count(pending_barriers), pending_barriers.data());
+			barrier_count += count(pending_barriers);
+			pending_barriers.clear();
+		}
 
 		static DXGI_FORMAT get_index_format_from_stride(unsigned stride)
 		{
@@ -539,23 +848,34 @@ namespace vt::d3d12
 			cmd->BeginRenderPass(count(rt_descs), rt_descs.data(), ds_desc_ptr, subpass.flags);
 		}
 
-		template<bool RENDER> void bind_descriptor_sets(ArrayView<DescriptorSet> sets, RootParameterMap const& indices)
+		// Each descriptor set with a dynamic descriptor consumes one dynamic offset, in the order of the descriptor sets.
+		template<bool RENDER>
+		void bind_descriptor_sets(ArrayView<DescriptorSet> sets, RootParameterMap const& indices, ConstSpan<unsigned> offsets)
 		{
+			auto offset = offsets.begin();
 			for(auto& set : sets)
 			{
 				auto [view_index, sampler_table_index] = indices.find(set.d3d12.get_layout_id());
-				switch(set.d3d12.get_view_parameter_type())
+				if(set.d3d12.get_view_parameter_type() == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
+					bind_descriptor_table<RENDER>(view_index, set.d3d12.get_view_table_start());
+				else
 				{
-					case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
-						bind_descriptor_table<RENDER>(view_index, set.d3d12.get_view_table_start());
-						break;
-					case D3D12_ROOT_PARAMETER_TYPE_CBV: bind_cbv<RENDER>(view_index, set.d3d12.get_gpu_address()); break;
-					case D3D12_ROOT_PARAMETER_TYPE_SRV: bind_srv<RENDER>(view_index, set.d3d12.get_gpu_address()); break;
-					case D3D12_ROOT_PARAMETER_TYPE_UAV: bind_uav<RENDER>(view_index, set.d3d12.get_gpu_address()); break;
+					auto address = set.d3d12.get_gpu_address();
+					if(set.d3d12.has_dynamic_offset())
+						address += *offset++;
+
+					switch(set.d3d12.get_view_parameter_type())
+					{
+						case D3D12_ROOT_PARAMETER_TYPE_CBV: bind_cbv<RENDER>(view_index, address); break;
+						case D3D12_ROOT_PARAMETER_TYPE_SRV: bind_srv<RENDER>(view_index, address); break;
+						case D3D12_ROOT_PARAMETER_TYPE_UAV: bind_uav<RENDER>(view_index, address); break;
+					}
 				}
 				if(sampler_table_index)
 					bind_descriptor_table<RENDER>(sampler_table_index, set.d3d12.get_sampler_table_start());
 			}
+			VT_ASSERT(offset == offsets.end(),
+					  "There must be one dynamic offset for each descriptor set with a dynamic descriptor.");
 		}
 
 		template<bool RENDER> void bind_descriptor_table(UINT index, D3D12_GPU_DESCRIPTOR_HANDLE table)
@@ -192,6 +192,7 @@ namespace vt::d3d12
 				layout.get_id(),
 				layout.get_view_root_parameter_type(),
 				sampler_table_start,
+				layout.has_dynamic_offset(),
 			};
 		}
 
@@ -20,6 +20,7 @@ namespace vt::d3d12
 						   D3D12_GPU_DESCRIPTOR_HANDLE		  view_table_start) :
 			layout_id(layout_id),
 			view_param_type(D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE),
+			dynamic_offset(false),
 			sampler_table_start(sampler_table_start),
 			view_table_start(view_table_start)
 		{}
@@ -28,8 +29,12 @@ namespace vt::d3d12
 		// virtual address member happens when the descriptor set is updated using the device.
 		D3D12DescriptorSet(unsigned					   layout_id,
 						   D3D12_ROOT_PARAMETER_TYPE   view_param_type,
-						   D3D12_GPU_DESCRIPTOR_HANDLE sampler_table_start) :
-			layout_id(layout_id), view_param_type(view_param_type), sampler_table_start(sampler_table_start)
+						   D3D12_GPU_DESCRIPTOR_HANDLE sampler_table_start,
+						   bool						   dynamic_offset) :
+			layout_id(layout_id),
+			view_param_type(view_param_type),
+			dynamic_offset(dynamic_offset),
+			sampler_table_start(sampler_table_start)
 		{}
 
 		unsigned get_layout_id() const
@@ -47,6 +52,12 @@ namespace vt::d3d12
 			return view_param_type != D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
 		}
 
+		// Whether the dynamic offset given when binding the descriptor set is added to the address of its root descriptor.
+		bool has_dynamic_offset() const
+		{
+			return dynamic_offset;
+		}
+
 		// Returns a zero descriptor if the descriptor set contains no view descriptor table.
 		D3D12_GPU_DESCRIPTOR_HANDLE get_view_table_start() const
 		{
@@ -74,6 +85,7 @@ namespace vt::d3d12
 		unsigned					   layout_id;
 		D3D12_ROOT_PARAMETER_TYPE	   view_param_type : 16;
 		unsigned					   range_count	   : 16;
+		bool						   dynamic_offset;
 		RangeOffsetMap::const_iterator range_begin;
 		D3D12_GPU_DESCRIPTOR_HANDLE	   sampler_table_start;
 		union
@@ -19,17 +19,19 @@ namespace vt::d3d12
 		LookupTable<DescriptorType, D3D12_DESCRIPTOR_RANGE_TYPE> _;
 		using enum DescriptorType;
 
-		_[Sampler]			   = D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
-		_[Buffer]			   = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-		_[Texture]			   = _[Buffer];
-		_[StructuredBuffer]	   = _[Buffer];
-		_[ByteAddressBuffer]   = _[Buffer];
-		_[RwBuffer]			   = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
-		_[RwTexture]		   = _[RwBuffer];
-		_[RwStructuredBuffer]  = _[RwBuffer];
-		_[RwByteAddressBuffer] = _[RwBuffer];
-		_[InputAttachment]	   = _[RwBuffer];
-		_[UniformBuffer]	   = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+		_[Sampler]				   = D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
+		_[Buffer]				   = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+		_[Texture]				   = _[Buffer];
+		_[StructuredBuffer]		   = _[Buffer];
+		_[ByteAddressBuffer]	   = _[Buffer];
+		_[DynamicStructuredBuffer] = _[Buffer];
+		_[RwBuffer]				   = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+		_[RwTexture]			   = _[RwBuffer];
+		_[RwStructuredBuffer]	   = _[RwBuffer];
+		_[RwByteAddressBuffer]	   = _[RwBuffer];
+		_[InputAttachment]		   = _[RwBuffer];
+		_[UniformBuffer]		   = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+		_[DynamicUniformBuffer]	   = _[UniformBuffer];
 		return _;
 	}();
 
@@ -60,9 +62,14 @@ namespace vt::d3d12
 		D3D12DescriptorSetLayout(DescriptorSetLayoutSpecification const& spec) :
 			visibility(SHADER_STAGE_LOOKUP[spec.visibility]),
 			view_parameter_type(determine_view_parameter_type(spec)),
+			dynamic_offset(has_dynamic_binding(spec)),
 			static_samplers(count_static_samplers(spec)),
 			descriptor_table_ranges(determine_descriptor_table_range_count(spec))
 		{
+			// Dynamic offsets are applied to the GPU address of a root descriptor, since descriptor tables have none.
+			VT_ASSERT(!dynamic_offset || has_root_descriptor(),
+					  "Dynamic buffers must be the only binding in their layout besides samplers, with a count of 1.");
+
 			initialize_static_samplers(spec);
 			initialize_descriptor_table_ranges(spec);
 		}
@@ -92,6 +99,12 @@ namespace vt::d3d12
 			return view_parameter_type != D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
 		}
 
+		// Whether descriptor sets of this layout take a dynamic offset when they are bound.
+		bool has_dynamic_offset() const
+		{
+			return dynamic_offset;
+		}
+
 		ConstSpan<D3D12_DESCRIPTOR_RANGE1> get_view_descriptor_table_ranges() const
 		{
 			return {descriptor_table_ranges.begin(), descriptor_table_ranges.begin() + sampler_range_start_index};
@@ -110,12 +123,15 @@ namespace vt::d3d12
 		D3D12_ROOT_PARAMETER1 get_root_descriptor_parameter() const
 		{
 			VT_ASSERT(has_root_descriptor(), "This method is only valid on descriptor set layouts holding a root descriptor.");
+
+			// The data behind dynamic descriptors is rewritten every time their buffer is reused for another frame.
 			return {
 				.ParameterType = view_parameter_type,
 				.Descriptor {
 					.ShaderRegister = root_descriptor_register,
 					.RegisterSpace	= 0, // Not the final value, will be set when creating root signature.
-					.Flags			= D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC,
+					.Flags			= dynamic_offset ? D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE
+													 : D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC,
 				},
 				.ShaderVisibility = visibility,
 			};
@@ -133,6 +149,7 @@ namespace vt::d3d12
 		D3D12_SHADER_VISIBILITY			 visibility;
 		UINT							 root_descriptor_register;
 		D3D12_ROOT_PARAMETER_TYPE		 view_parameter_type : sizeof(char);
+		bool							 dynamic_offset;
 		uint8_t							 sampler_range_start_index;
 		Array<D3D12_STATIC_SAMPLER_DESC> static_samplers;
 		Array<D3D12_DESCRIPTOR_RANGE1>	 descriptor_table_ranges;
@@ -148,9 +165,9 @@ namespace vt::d3d12
 			if(candidate == spec.bindings.end()) // If there are only sampler bindings, it can't be a root descriptor.
 				return D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
 
-			auto next = std::find_if(candidate, spec.bindings.end(), is_resource_binding);
+			auto next = std::find_if(candidate + 1, spec.bindings.end(), is_resource_binding);
 			// If there are multiple bindings of non-sampler type, it can't be a root descriptor.
-			if(next != candidate && is_resource_binding(*next))
+			if(next != spec.bindings.end())
 				return D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
 
 			if(candidate->count != 1) // If a binding specifies multiple descriptors, it can't be a root descriptor.
@@ -161,8 +178,10 @@ namespace vt::d3d12
 				using enum DescriptorType;
 				case Buffer:
 				case StructuredBuffer:
-				case ByteAddressBuffer: return D3D12_ROOT_PARAMETER_TYPE_SRV;
-				case UniformBuffer: return D3D12_ROOT_PARAMETER_TYPE_CBV;
+				case ByteAddressBuffer:
+				case DynamicStructuredBuffer: return D3D12_ROOT_PARAMETER_TYPE_SRV;
+				case UniformBuffer:
+				case DynamicUniformBuffer: return D3D12_ROOT_PARAMETER_TYPE_CBV;
 				case RwTexture:
 				case RwBuffer:
 				case RwStructuredBuffer:
@@ -172,6 +191,14 @@ namespace vt::d3d12
 			return D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
 		}
 
+		static bool has_dynamic_binding(DescriptorSetLayoutSpecification const& spec)
+		{
+			return std::any_of(spec.bindings.begin(), spec.bindings.end(), [](DescriptorBinding const& binding) {
+				return binding.type == DescriptorType::DynamicUniformBuffer ||
+					   binding.type == DescriptorType::DynamicStructuredBuffer;
+			});
+		}
+
 		static size_t count_static_samplers(DescriptorSetLayoutSpecification const& spec)
 		{
 			size_t count = 0;
@@ -62,6 +62,12 @@ namespace vt::d3d12
 														 draw_signature.get(), draw_indexed_signature.get());
 		}
 
+		RenderCommandList make_secondary_render_command_list() override
+		{
+			return D3D12CommandList<CommandType::Render>(*device, *descriptor_pool, dispatch_signature.get(),
+														 draw_signature.get(), draw_indexed_signature.get(), true);
+		}
+
 		Buffer make_buffer(BufferSpecification const& spec) override
 		{
 			return {
@@ -78,6 +84,40 @@ namespace vt::d3d12
 			};
 		}
 
+		TransientHeap make_transient_heap(TransientHeapSpecification const& spec) override
+		{
+			return {
+				D3D12TransientHeap(spec, *allocator),
+				spec,
+			};
+		}
+
+		Buffer make_placed_buffer(BufferSpecification const& spec, TransientHeap const& heap, size_t offset) override
+		{
+			return {
+				D3D12Buffer(spec, *device, *allocator, *descriptor_pool, heap.d3d12, offset),
+				spec,
+			};
+		}
+
+		Image make_placed_image(ImageSpecification const& spec, TransientHeap const& heap, size_t offset) override
+		{
+			return {
+				D3D12Image(spec, *device, *allocator, *descriptor_pool, heap.d3d12, offset),
+				spec,
+			};
+		}
+
+		MemoryRequirements get_memory_requirements(BufferSpecification const& spec) override
+		{
+			return D3D12Buffer::get_memory_requirements(spec, *device);
+		}
+
+		MemoryRequirements get_memory_requirements(ImageSpecification const& spec) override
+		{
+			return D3D12Image::get_memory_requirements(spec, *device);
+		}
+
 		std::vector<ComputePipeline> make_compute_pipelines(ArrayView<ComputePipelineSpecification> specs) override
 		{
 			std::vector<ComputePipeline> pipelines;
@@ -104,17 +144,26 @@ namespace vt::d3d12
 
 		DescriptorSetLayout make_descriptor_set_layout(DescriptorSetLayoutSpecification const& spec) override
 		{
-			return D3D12DescriptorSetLayout(spec);
+			return {
+				D3D12DescriptorSetLayout(spec),
+				spec,
+			};
 		}
 
 		RenderPass make_render_pass(RenderPassSpecification const& spec) override
 		{
-			return D3D12RenderPass(spec);
+			return {
+				D3D12RenderPass(spec),
+				spec,
+			};
 		}
 
 		RootSignature make_root_signature(RootSignatureSpecification const& spec) override
 		{
-			return D3D12RootSignature(spec, *device);
+			return {
+				D3D12RootSignature(spec, *device),
+				spec,
+			};
 		}
 
 		Sampler make_sampler(SamplerSpecification const& spec) override
@@ -124,7 +173,9 @@ namespace vt::d3d12
 
 		Shader make_shader(char const path[]) override
 		{
-			return D3D12Shader(std::ifstream(path, std::ios::binary));
+			D3D12Shader shader(std::ifstream(path, std::ios::binary));
+			auto		content_hash = shader.get_content_hash();
+			return {std::move(shader), content_hash};
 		}
 
 		SwapChain make_swap_chain(Window& window, uint8_t buffer_count = SwapChain::DEFAULT_BUFFERS) override
@@ -155,6 +206,16 @@ namespace vt::d3d12
 					for(Sampler const& sampler : update.samplers)
 						src_samplers.emplace_back(sampler.d3d12.get_handle());
 				}
+				else if(update.set.d3d12.holds_root_descriptor())
+				{
+					// Root descriptors are just the address of the buffer, to which dynamic offsets are added when binding. The
+					// range is only needed on Vulkan, but is checked here as well to keep both APIs equally strict.
+					VT_ASSERT(!update.set.d3d12.has_dynamic_offset() || update.dynamic_range != 0,
+							  "Dynamic buffer descriptors need a nonzero range.");
+					Buffer const& buffer = update.buffers[0];
+
+					update.set.d3d12.root_descriptor_gpu_address = buffer.d3d12.get_gpu_address();
+				}
 				else
 				{}
 			}
@@ -219,6 +280,12 @@ namespace vt::d3d12
 			wait_for_fence_value(cpu_wait_token.d3d12.fence, cpu_wait_token.d3d12.fence_value);
 		}
 
+		bool is_workload_done(SyncToken token) override
+		{
+			auto fence = token.d3d12.fence;
+			return !fence || fence->GetCompletedValue() >= token.d3d12.fence_value;
+		}
+
 		void flush_render_queue() override
 		{
 			render_queue.flush();
@@ -7,6 +7,7 @@ import vt.Core.LookupTable;
 import vt.Graphics.AssetResourceSpecification;
 import vt.Graphics.D3D12.DescriptorPool;
 import vt.Graphics.D3D12.Resource;
+import vt.Graphics.D3D12.TransientHeap;
 
 namespace vt::d3d12
 {
@@ -164,12 +165,38 @@ namespace vt::d3d12
 			initialize_descriptor(spec, device, pool);
 		}
 
+		// Places the image into the transient heap at the given offset instead of giving it its own memory.
+		D3D12Image(ImageSpecification const& spec,
+				   ID3D12Device4&			 device,
+				   D3D12MA::Allocator&		 allocator,
+				   DescriptorPool&			 pool,
+				   D3D12TransientHeap const& heap,
+				   size_t					 offset)
+		{
+			auto resource_desc = fill_resource_desc(spec);
+			auto initial_state = derive_image_resource_states(spec.usage);
+
+			auto result = allocator.CreateAliasingResource(heap.get_allocation(), offset, &resource_desc, initial_state,
+														   nullptr, VT_COM_OUT(resource));
+			VT_CHECK_RESULT(result, "Failed to create placed D3D12 image.");
+			state = initial_state;
+			initialize_descriptor(spec, device, pool);
+		}
+
+		static MemoryRequirements get_memory_requirements(ImageSpecification const& spec, ID3D12Device4& device)
+		{
+			auto resource_desc = fill_resource_desc(spec);
+			auto info		   = device.GetResourceAllocationInfo(0, 1, &resource_desc);
+			return {info.SizeInBytes, info.Alignment};
+		}
+
 	private:
 		static D3D12_RESOURCE_DESC fill_resource_desc(ImageSpecification const& spec)
 		{
 			return {
 				.Dimension		  = IMAGE_DIMENSION_LOOKUP[spec.dimension],
-				.Alignment		  = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+				.Alignment		  = spec.sample_count > 1 ? D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT
+															  : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
 				.Width			  = spec.expanse.width,
 				.Height			  = spec.expanse.height,
 				.DepthOrArraySize = static_cast<UINT16>(spec.expanse.depth),
@@ -195,6 +222,7 @@ namespace vt::d3d12
 			auto result = allocator.CreateResource(&allocation_desc, &resource_desc, initial_state, nullptr,
 												   std::out_ptr(allocation), VT_COM_OUT(resource));
 			VT_CHECK_RESULT(result, "Failed to create D3D12 image.");
+			state = initial_state;
 		}
 
 		void initialize_descriptor(ImageSpecification const& spec, ID3D12Device4& device, DescriptorPool& pool)
@@ -30,20 +30,20 @@ namespace vt::d3d12
 		return _;
 	}();
 
-	constexpr inline auto VERTEX_DATA_TYPE_LOOKUP = [] {
-		LookupTable<VertexDataType, DXGI_FORMAT> _;
-		using enum VertexDataType;
-
-		_[Position]			   = DXGI_FORMAT_R32G32B32A32_FLOAT;
-		_[TransformedPosition] = _[Position];
-		_[TextureCoordinates]  = _[Position];
-		_[Normal]			   = _[Position];
-		_[Binormal]			   = _[Position];
-		_[Tangent]			   = _[Position];
-		_[Color]			   = _[Position];
-		_[PointSize]		   = DXGI_FORMAT_R32_FLOAT;
-		_[BlendWeight]		   = DXGI_FORMAT_R32_FLOAT;
-		_[BlendIndices]		   = DXGI_FORMAT_R32_UINT;
+	constexpr inline auto VERTEX_FORMAT_LOOKUP = [] {
+		LookupTable<VertexFormat, DXGI_FORMAT> _;
+		using enum VertexFormat;
+
+		_[Float]		= DXGI_FORMAT_R32_FLOAT;
+		_[Float2]		= DXGI_FORMAT_R32G32_FLOAT;
+		_[Float3]		= DXGI_FORMAT_R32G32B32_FLOAT;
+		_[Float4]		= DXGI_FORMAT_R32G32B32A32_FLOAT;
+		_[Half2]		= DXGI_FORMAT_R16G16_FLOAT;
+		_[Half4]		= DXGI_FORMAT_R16G16B16A16_FLOAT;
+		_[UInt]			= DXGI_FORMAT_R32_UINT;
+		_[UNormRgba8]	= DXGI_FORMAT_R8G8B8A8_UNORM;
+		_[UNormRgb10A2] = DXGI_FORMAT_R10G10B10A2_UNORM;
+		_[SNorm16x2]	= DXGI_FORMAT_R16G16_SNORM;
 		return _;
 	}();
 
@@ -392,13 +392,13 @@ namespace vt::d3d12
 					input_element_descs.emplace_back(D3D12_INPUT_ELEMENT_DESC {
 						.SemanticName		  = VERTEX_DATA_TYPE_SEMANTIC_LOOKUP[attribute.type],
 						.SemanticIndex		  = attribute.semantic_index,
-						.Format				  = VERTEX_DATA_TYPE_LOOKUP[attribute.type],
+						.Format				  = VERTEX_FORMAT_LOOKUP[get_vertex_attribute_format(attribute)],
 						.InputSlot			  = index,
 						.AlignedByteOffset	  = static_cast<UINT>(offset),
 						.InputSlotClass		  = input_rate,
 						.InstanceDataStepRate = step_rate,
 					});
-					offset += get_vertex_data_type_size(attribute.type);
+					offset += get_vertex_attribute_size(attribute);
 				}
 				++index;
 			}
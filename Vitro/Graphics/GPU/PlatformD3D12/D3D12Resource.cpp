@@ -40,9 +40,29 @@ namespace vt::d3d12
 			return descriptor.get();
 		}
 
+		// The state is tracked by command lists as they record accesses of the resource.
+		D3D12_RESOURCE_STATES& get_state() const
+		{
+			return state;
+		}
+
+		// Resources in upload or readback heaps can never leave their initial state, so their state isn't tracked.
+		bool has_fixed_state() const
+		{
+			return fixed_state;
+		}
+
+		bool is_buffer() const
+		{
+			return buffer_resource;
+		}
+
 	protected:
 		ComUnique<D3D12MA::Allocation> allocation;
 		ComUnique<ID3D12Resource>	   resource;
 		UniqueCpuDescriptor			   descriptor;
+		mutable D3D12_RESOURCE_STATES  state		   = D3D12_RESOURCE_STATE_COMMON;
+		bool						   fixed_state	   = false;
+		bool						   buffer_resource = false;
 	};
 }
@@ -6,6 +6,7 @@ module;
 export module vt.Graphics.D3D12.Shader;
 
 import vt.Core.Array;
+import vt.Core.ContentHash;
 
 namespace vt::d3d12
 {
@@ -15,6 +16,7 @@ namespace vt::d3d12
 		D3D12Shader(std::ifstream file) : bytecode(query_bytecode_size(file))
 		{
 			file.read(bytecode.data(), bytecode.size());
+			content_hash = hash_content(bytecode.data(), bytecode.size());
 		}
 
 		D3D12_SHADER_BYTECODE get_bytecode() const
@@ -25,8 +27,14 @@ namespace vt::d3d12
 			};
 		}
 
+		uint64_t get_content_hash() const
+		{
+			return content_hash;
+		}
+
 	private:
 		Array<char> bytecode;
+		uint64_t	content_hash;
 
 		static size_t query_bytecode_size(std::ifstream& file)
 		{
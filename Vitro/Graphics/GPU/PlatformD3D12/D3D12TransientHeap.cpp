@@ -0,0 +1,54 @@
+module;
+#include "D3D12API.hpp"
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+export module vt.Graphics.D3D12.TransientHeap;
+
+import vt.Core.LookupTable;
+import vt.Graphics.AssetResourceSpecification;
+import vt.Graphics.D3D12.Handle;
+
+namespace vt::d3d12
+{
+	// Heaps restricted to one kind of resource work on all resource heap tiers.
+	constexpr inline auto HEAP_FLAGS_LOOKUP = [] {
+		LookupTable<TransientHeapContents, D3D12_HEAP_FLAGS> _;
+		using enum TransientHeapContents;
+
+		_[Buffers]	   = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		_[Images]	   = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		_[Attachments] = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+		return _;
+	}();
+
+	export class D3D12TransientHeap
+	{
+	public:
+		D3D12TransientHeap(TransientHeapSpecification const& spec, D3D12MA::Allocator& allocator)
+		{
+			D3D12MA::ALLOCATION_DESC const allocation_desc {
+				.HeapType		= D3D12_HEAP_TYPE_DEFAULT,
+				.ExtraHeapFlags = HEAP_FLAGS_LOOKUP[spec.contents],
+			};
+			// Multisampled attachments need the larger alignment.
+			size_t const default_alignment = spec.contents == TransientHeapContents::Attachments
+												 ? D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT
+												 : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+			D3D12_RESOURCE_ALLOCATION_INFO const allocation_info {
+				.SizeInBytes = spec.size,
+				.Alignment	 = std::max(spec.alignment, default_alignment),
+			};
+			auto result = allocator.AllocateMemory(&allocation_desc, &allocation_info, std::out_ptr(allocation));
+			VT_CHECK_RESULT(result, "Failed to allocate D3D12 transient heap.");
+		}
+
+		D3D12MA::Allocation* get_allocation() const
+		{
+			return allocation.get();
+		}
+
+	private:
+		ComUnique<D3D12MA::Allocation> allocation;
+	};
+}
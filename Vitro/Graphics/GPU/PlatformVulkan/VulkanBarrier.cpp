@@ -0,0 +1,286 @@
+module;
+#include "VitroCore/Macros.hpp"
+#include "VulkanAPI.hpp"
+
+#include <algorithm>
+export module vt.Graphics.Vulkan.Barrier;
+
+import vt.Core.Array;
+import vt.Core.Enum;
+import vt.Core.LookupTable;
+import vt.Core.SmallList;
+import vt.Graphics.AssetResourceSpecification;
+import vt.Graphics.Vulkan.Handle;
+import vt.Graphics.Vulkan.Image;
+
+namespace vt::vulkan
+{
+	// Describes an access of a resource by the commands following a barrier.
+	export struct AccessScope
+	{
+		VkPipelineStageFlags stages;
+		VkAccessFlags		 access;
+		VkImageLayout		 layout = VK_IMAGE_LAYOUT_UNDEFINED;
+	};
+
+	constexpr VkPipelineStageFlags SHADER_STAGES = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+												   VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+												   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+	constexpr VkAccessFlags WRITE_ACCESS = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+										   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+										   VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+	export constexpr inline auto BUFFER_ACCESS_LOOKUP = [] {
+		LookupTable<BufferAccess, AccessScope> _;
+		using enum BufferAccess;
+
+		_[CopySource]	   = {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT};
+		_[CopyDestination] = {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT};
+		_[Vertex]		   = {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT};
+		_[Index]		   = {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT};
+		_[Uniform]		   = {SHADER_STAGES, VK_ACCESS_UNIFORM_READ_BIT};
+		_[ShaderRead]	   = {SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT};
+		_[ShaderWrite]	   = {SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT};
+		_[Indirect]		   = {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT};
+		return _;
+	}();
+
+	export constexpr inline auto IMAGE_ACCESS_LOOKUP = [] {
+		LookupTable<ImageLayout, AccessScope> _;
+		using enum ImageLayout;
+
+		constexpr VkPipelineStageFlags FRAGMENT_TESTS = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+														VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		constexpr VkAccessFlags		   DEPTH_STENCIL  = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+												VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		constexpr VkAccessFlags		   MEMORY		  = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+		_[Undefined]			  = {VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0};
+		_[General]				  = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, MEMORY};
+		_[CopySource]			  = {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT};
+		_[CopyDestination]		  = {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT};
+		_[ColorAttachment]		  = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+									 VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT};
+		_[DepthStencilAttachment] = {FRAGMENT_TESTS, DEPTH_STENCIL};
+		_[DepthStencilReadOnly]	  = {FRAGMENT_TESTS | SHADER_STAGES,
+									 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT};
+		_[ShaderResource]		  = {SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT};
+		_[FragmentShaderResource] = {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT};
+		_[UnorderedAccess]		  = {SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT};
+		_[Presentable]			  = {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0};
+
+		for(size_t i = 0; i != size_from_enum_max<ImageLayout>(); ++i)
+			_[ImageLayout(i)].layout = IMAGE_LAYOUT_LOOKUP[ImageLayout(i)];
+		return _;
+	}();
+
+	// Collects the barriers that the tracked states of resources call for and records all of them with one pipeline barrier
+	// command once the next command accessing resources is recorded. Stages that the queue does not support are masked out.
+	// States advance as barriers are planned, so the batch remembers the states from before the first change since the last
+	// flush and restores them if the planned barriers are discarded.
+	export class BarrierBatch
+	{
+	public:
+		BarrierBatch(VkPipelineStageFlags supported_stages) : supported_stages(supported_stages)
+		{}
+
+		// Adds what is needed for the next access of the buffer on the given queue family to the batch. If the next family
+		// differs, ownership of the buffer is released to it, and it must be required on that family before its next use.
+		void require(VkBuffer		buffer,
+					 ResourceState& state,
+					 AccessScope	next,
+					 uint32_t		queue_family,
+					 uint32_t		next_queue_family)
+		{
+			next.layout = VK_IMAGE_LAYOUT_UNDEFINED; // Keeps buffers from ever looking like they need a layout transition.
+			plan(state, next, queue_family, next_queue_family, [&](Transition const& transition) {
+				buffer_barriers.emplace_back(VkBufferMemoryBarrier {
+					.sType				 = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+					.srcAccessMask		 = transition.src_access,
+					.dstAccessMask		 = transition.dst_access,
+					.srcQueueFamilyIndex = transition.src_queue_family,
+					.dstQueueFamilyIndex = transition.dst_queue_family,
+					.buffer				 = buffer,
+					.offset				 = 0,
+					.size				 = VK_WHOLE_SIZE,
+				});
+			});
+		}
+
+		// Same as for buffers, but covers all subresources of the image.
+		void require(VkImage			image,
+					 VkImageAspectFlags aspect,
+					 ResourceState&		state,
+					 AccessScope		next,
+					 uint32_t			queue_family,
+					 uint32_t			next_queue_family)
+		{
+			plan(state, next, queue_family, next_queue_family, [&](Transition const& transition) {
+				image_barriers.emplace_back(VkImageMemoryBarrier {
+					.sType				 = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+					.srcAccessMask		 = transition.src_access,
+					.dstAccessMask		 = transition.dst_access,
+					.oldLayout			 = transition.old_layout,
+					.newLayout			 = transition.new_layout,
+					.srcQueueFamilyIndex = transition.src_queue_family,
+					.dstQueueFamilyIndex = transition.dst_queue_family,
+					.image				 = image,
+					.subresourceRange {
+						.aspectMask		= aspect,
+						.baseMipLevel	= 0,
+						.levelCount		= VK_REMAINING_MIP_LEVELS,
+						.baseArrayLayer = 0,
+						.layerCount		= VK_REMAINING_ARRAY_LAYERS,
+					},
+				});
+			});
+		}
+
+		void flush(DeviceApiTable const& api, VkCommandBuffer cmd)
+		{
+			original_states.clear();
+			if(buffer_barriers.empty() && image_barriers.empty())
+				return;
+
+			auto src = src_stages & supported_stages;
+			auto dst = dst_stages & supported_stages;
+			api.vkCmdPipelineBarrier(cmd, src ? src : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+									 dst ? dst : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, count(buffer_barriers),
+									 buffer_barriers.data(), count(image_barriers), image_barriers.data());
+
+			issued_count += count(buffer_barriers) + count(image_barriers);
+			buffer_barriers.clear();
+			image_barriers.clear();
+			src_stages = 0;
+			dst_stages = 0;
+		}
+
+		// Discards barriers that were not flushed, rolls back the states they were planned for and restarts the count of
+		// issued barriers.
+		void reset()
+		{
+			for(auto [state, original] : original_states)
+				*state = original;
+			original_states.clear();
+
+			buffer_barriers.clear();
+			image_barriers.clear();
+			src_stages	 = 0;
+			dst_stages	 = 0;
+			issued_count = 0;
+		}
+
+		unsigned count_issued() const
+		{
+			return issued_count;
+		}
+
+	private:
+		struct Transition
+		{
+			VkAccessFlags src_access;
+			VkAccessFlags dst_access;
+			VkImageLayout old_layout;
+			VkImageLayout new_layout;
+			uint32_t	  src_queue_family;
+			uint32_t	  dst_queue_family;
+		};
+
+		struct OriginalState
+		{
+			ResourceState* state;
+			ResourceState  original;
+		};
+
+		SmallList<VkBufferMemoryBarrier> buffer_barriers;
+		SmallList<VkImageMemoryBarrier>	 image_barriers;
+		SmallList<OriginalState>		 original_states;
+		VkPipelineStageFlags			 src_stages = 0;
+		VkPipelineStageFlags			 dst_stages = 0;
+		VkPipelineStageFlags			 supported_stages;
+		unsigned						 issued_count = 0;
+
+		void plan(ResourceState& state, AccessScope next, uint32_t family, uint32_t next_family, auto add_barrier)
+		{
+			VT_ASSERT(state.queue_family == VK_QUEUE_FAMILY_IGNORED || state.queue_family == family,
+					  "The resource is owned by another queue family and must be transitioned to this one first.");
+
+			auto is_remembered = [&](OriginalState const& original) {
+				return original.state == &state;
+			};
+			if(std::none_of(original_states.begin(), original_states.end(), is_remembered))
+				original_states.emplace_back(&state, state);
+
+			if(state.releasing_family != VK_QUEUE_FAMILY_IGNORED)
+			{
+				// Acquires ownership with the same layouts as the release.
+				add(add_barrier, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, next.stages,
+					{
+						.src_access		  = 0,
+						.dst_access		  = next.access,
+						.old_layout		  = state.pre_release_layout,
+						.new_layout		  = state.layout,
+						.src_queue_family = state.releasing_family,
+						.dst_queue_family = family,
+					});
+				state.stages		   = next.stages;
+				state.access		   = next.access;
+				state.releasing_family = VK_QUEUE_FAMILY_IGNORED;
+				if(state.layout == next.layout && next_family == family)
+					return;
+			}
+
+			if(next_family != family)
+			{
+				add(add_barrier, state.stages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+					{
+						.src_access		  = state.access & WRITE_ACCESS,
+						.dst_access		  = 0,
+						.old_layout		  = state.layout,
+						.new_layout		  = next.layout,
+						.src_queue_family = family,
+						.dst_queue_family = next_family,
+					});
+				state = {
+					.layout				= next.layout,
+					.queue_family		= next_family,
+					.releasing_family	= family,
+					.pre_release_layout = state.layout,
+				};
+				return;
+			}
+			state.queue_family = family;
+
+			bool const changes_layout = state.layout != next.layout;
+			bool const only_reads	  = !(state.access & WRITE_ACCESS) && !(next.access & WRITE_ACCESS);
+			if(!changes_layout && (state.access == 0 || only_reads))
+			{
+				// Nothing to wait for, but later writes must wait for all reads since the last barrier.
+				state.stages = state.access == 0 ? next.stages : state.stages | next.stages;
+				state.access |= next.access;
+				return;
+			}
+
+			add(add_barrier, state.stages, next.stages,
+				{
+					.src_access		  = state.access & WRITE_ACCESS,
+					.dst_access		  = next.access,
+					.old_layout		  = state.layout,
+					.new_layout		  = next.layout,
+					.src_queue_family = VK_QUEUE_FAMILY_IGNORED,
+					.dst_queue_family = VK_QUEUE_FAMILY_IGNORED,
+				});
+			state.stages = next.stages;
+			state.access = next.access;
+			state.layout = next.layout;
+		}
+
+		void add(auto add_barrier, VkPipelineStageFlags src, VkPipelineStageFlags dst, Transition const& transition)
+		{
+			src_stages |= src;
+			dst_stages |= dst;
+			add_barrier(transition);
+		}
+	};
+}
@@ -8,6 +8,7 @@ export module vt.Graphics.Vulkan.Buffer;
 import vt.Core.Array;
 import vt.Graphics.AssetResourceSpecification;
 import vt.Graphics.Vulkan.Handle;
+import vt.Graphics.Vulkan.TransientHeap;
 
 namespace vt::vulkan
 {
@@ -51,6 +52,8 @@ namespace vt::vulkan
 			else
 				usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
+			auto buffer_info = fill_buffer_info(spec);
+
 			VmaAllocationCreateInfo const allocation_info {
 				.flags			= 0,
 				.usage			= usage,
@@ -61,15 +64,6 @@ namespace vt::vulkan
 				.pUserData		= nullptr,
 				.priority		= 0,
 			};
-
-			VkBufferCreateInfo const buffer_info {
-				.sType				   = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-				.size				   = spec.size,
-				.usage				   = convert_buffer_usage(spec.usage),
-				.sharingMode		   = VK_SHARING_MODE_EXCLUSIVE,
-				.queueFamilyIndexCount = 0,
-				.pQueueFamilyIndices   = nullptr,
-			};
 			auto result = vmaCreateBuffer(allocator, &buffer_info, &allocation_info, std::out_ptr(buffer),
 										  &buffer.get_deleter().allocation, nullptr);
 
@@ -77,6 +71,38 @@ namespace vt::vulkan
 			VT_CHECK_RESULT(result, "Failed to create Vulkan buffer.");
 		}
 
+		// Places the buffer into the transient heap at the given offset instead of giving it its own memory.
+		VulkanBuffer(BufferSpecification const& spec, DeviceApiTable const& api, VulkanTransientHeap const& heap, size_t offset)
+		{
+			VT_ASSERT(!(spec.usage.get() & (BufferUsage::Upload | BufferUsage::Readback)),
+					  "Transient heaps are not visible to the CPU.");
+
+			auto buffer_info = fill_buffer_info(spec);
+			auto result		 = api.vkCreateBuffer(api.device, &buffer_info, nullptr, std::out_ptr(buffer));
+			VT_CHECK_RESULT(result, "Failed to create placed Vulkan buffer.");
+			buffer.get_deleter().api = &api;
+
+			VkMemoryRequirements requirements;
+			api.vkGetBufferMemoryRequirements(api.device, buffer.get(), &requirements);
+			VT_ENSURE(heap.supports(requirements), "The memory type of the transient heap is unsuitable for this buffer.");
+
+			result = vmaBindBufferMemory2(api.allocator, heap.get_allocation(), offset, buffer.get(), nullptr);
+			VT_CHECK_RESULT(result, "Failed to bind Vulkan buffer to transient heap.");
+		}
+
+		static MemoryRequirements get_memory_requirements(BufferSpecification const& spec, DeviceApiTable const& api)
+		{
+			auto	 buffer_info = fill_buffer_info(spec);
+			VkBuffer buffer;
+			auto	 result = api.vkCreateBuffer(api.device, &buffer_info, nullptr, &buffer);
+			VT_CHECK_RESULT(result, "Failed to create Vulkan buffer for querying memory requirements.");
+
+			VkMemoryRequirements requirements;
+			api.vkGetBufferMemoryRequirements(api.device, buffer, &requirements);
+			api.vkDestroyBuffer(api.device, buffer, nullptr);
+			return {requirements.size, requirements.alignment, requirements.memoryTypeBits};
+		}
+
 		VkBuffer get_handle() const
 		{
 			return buffer.get();
@@ -87,13 +113,19 @@ namespace vt::vulkan
 			return buffer.get_deleter().allocation;
 		}
 
+		// The state is tracked by command lists as they record accesses of the buffer.
+		ResourceState& get_state() const
+		{
+			return state;
+		}
+
 	private:
 		struct BufferDeleter
 		{
 			using pointer = VkBuffer;
 
 			DeviceApiTable const* api;
-			VmaAllocation		  allocation;
+			VmaAllocation		  allocation; // Null for buffers placed into transient heaps.
 
 			void operator()(VkBuffer buffer) const
 			{
@@ -102,6 +134,19 @@ namespace vt::vulkan
 		};
 		using UniqueVkBuffer = std::unique_ptr<VkBuffer, BufferDeleter>;
 
-		UniqueVkBuffer buffer;
+		UniqueVkBuffer		  buffer;
+		mutable ResourceState state;
+
+		static VkBufferCreateInfo fill_buffer_info(BufferSpecification const& spec)
+		{
+			return {
+				.sType				   = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+				.size				   = spec.size,
+				.usage				   = convert_buffer_usage(spec.usage),
+				.sharingMode		   = VK_SHARING_MODE_EXCLUSIVE,
+				.queueFamilyIndexCount = 0,
+				.pQueueFamilyIndices   = nullptr,
+			};
+		}
 	};
 }
@@ -2,6 +2,7 @@ module;
 #include "VitroCore/Macros.hpp"
 #include "VulkanAPI.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <ranges>
 #include <type_traits>
@@ -10,19 +11,46 @@ export module vt.Graphics.Vulkan.CommandList;
 
 import vt.Core.Array;
 import vt.Core.FixedList;
+import vt.Core.LookupTable;
 import vt.Core.Rect;
 import vt.Graphics.AssetResource;
 import vt.Graphics.AbstractCommandList;
+import vt.Graphics.AssetResourceSpecification;
 import vt.Graphics.DescriptorSet;
 import vt.Graphics.Handle;
 import vt.Graphics.PipelineSpecification;
 import vt.Graphics.RenderPass;
 import vt.Graphics.RenderTarget;
 import vt.Graphics.RootSignature;
+import vt.Graphics.Vulkan.Barrier;
 import vt.Graphics.Vulkan.RootSignature;
 
 namespace vt::vulkan
 {
+	constexpr inline auto SUBPASS_CONTENTS_LOOKUP = [] {
+		LookupTable<SubpassContents, VkSubpassContents> _;
+		using enum SubpassContents;
+
+		_[Inline]	 = VK_SUBPASS_CONTENTS_INLINE;
+		_[Secondary] = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+		return _;
+	}();
+
+	// Pipeline stages that a barrier may refer to on a queue that supports the given type of commands.
+	constexpr inline auto SUPPORTED_STAGES_LOOKUP = [] {
+		LookupTable<CommandType, VkPipelineStageFlags> _;
+		using enum CommandType;
+
+		constexpr VkPipelineStageFlags COMMON = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT |
+												VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_HOST_BIT |
+												VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+		_[Copy]	   = COMMON;
+		_[Compute] = COMMON | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		_[Render]  = ~VkPipelineStageFlags(0);
+		return _;
+	}();
+
 	template<CommandType> class CommandListData;
 
 	template<> class CommandListData<CommandType::Copy>
@@ -44,8 +72,14 @@ namespace vt::vulkan
 	class VulkanCommandList final : public AbstractCommandList<TYPE>, private CommandListData<TYPE>
 	{
 	public:
-		VulkanCommandList(uint32_t queue_family, DeviceApiTable const& in_api) : api(&in_api)
+		VulkanCommandList(uint32_t				queue_family,
+						  DeviceApiTable const& in_api,
+						  VkCommandBufferLevel	level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) :
+			api(&in_api), queue_family(queue_family), barriers(SUPPORTED_STAGES_LOOKUP[TYPE])
 		{
+			VT_ASSERT(TYPE == CommandType::Render || level == VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+					  "Only render command lists can be secondary command lists.");
+
 			VkCommandPoolCreateInfo const pool_info {
 				.sType			  = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
 				.queueFamilyIndex = queue_family,
@@ -56,7 +90,7 @@ namespace vt::vulkan
 			VkCommandBufferAllocateInfo const alloc_info {
 				.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
 				.commandPool		= pool.get(),
-				.level				= VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+				.level				= level,
 				.commandBufferCount = 1,
 			};
 			result = api->vkAllocateCommandBuffers(api->device, &alloc_info, &cmd);
@@ -72,6 +106,8 @@ namespace vt::vulkan
 		{
 			auto result = api->vkResetCommandPool(api->device, pool.get(), 0);
 			VT_CHECK_RESULT(result, "Failed to reset Vulkan command pool.");
+			barriers.reset();
+			inside_render_pass = false;
 		}
 
 		void begin()
@@ -87,12 +123,60 @@ namespace vt::vulkan
 
 		void end()
 		{
+			barriers.flush(*api, cmd);
 			auto result = api->vkEndCommandBuffer(cmd);
 			VT_CHECK_RESULT(result, "Failed to end Vulkan command buffer.");
 		}
 
+		void require(Buffer const& buffer, BufferAccess access)
+		{
+			transition(buffer, access, TYPE);
+		}
+
+		void require(Image const& image, ImageLayout layout)
+		{
+			transition(image, layout, TYPE);
+		}
+
+		void transition(Buffer const& buffer, BufferAccess access, CommandType next_queue)
+		{
+			assert_outside_render_pass();
+
+			auto& vk_buffer = buffer.vulkan;
+			barriers.require(vk_buffer.get_handle(), vk_buffer.get_state(), BUFFER_ACCESS_LOOKUP[access], queue_family,
+							 get_queue_family(next_queue));
+		}
+
+		void transition(Image const& image, ImageLayout layout, CommandType next_queue)
+		{
+			assert_outside_render_pass();
+
+			auto& vk_image = image.vulkan;
+			barriers.require(vk_image.get_handle(), vk_image.get_aspect(), vk_image.get_state(), IMAGE_ACCESS_LOOKUP[layout],
+							 queue_family, get_queue_family(next_queue));
+		}
+
+		void alias(Buffer const& buffer)
+		{
+			assert_outside_render_pass();
+			discard_state(buffer.vulkan.get_state());
+		}
+
+		void alias(Image const& image)
+		{
+			assert_outside_render_pass();
+			discard_state(image.vulkan.get_state());
+		}
+
+		unsigned count_barriers() const
+		{
+			return barriers.count_issued();
+		}
+
 		void copy_buffer(Buffer const& src, Buffer& dst)
 		{
+			require_copy(src, dst);
+
 			VkBufferCopy const copy {
 				.srcOffset = 0,
 				.dstOffset = 0,
@@ -103,6 +187,8 @@ namespace vt::vulkan
 
 		void copy_image(Image const& src, Image& dst)
 		{
+			require_copy(src, dst);
+
 			VkImageCopy const copy {
 				.srcSubresource {
 					.aspectMask		= IMAGE_ASPECT_FLAGS_LOOKUP[src.get_format()],
@@ -130,6 +216,8 @@ namespace vt::vulkan
 
 		void copy_buffer_to_image(Buffer const& src, Image& dst)
 		{
+			require_copy(src, dst);
+
 			VkBufferImageCopy const copy {
 				.bufferOffset	   = 0,
 				.bufferRowLength   = 0, // Zero here means the layout is the same as the destination image extent.
@@ -153,11 +241,16 @@ namespace vt::vulkan
 
 		void update_buffer(Buffer& dst, size_t offset, size_t size, void const* data)
 		{
+			require(dst, BufferAccess::CopyDestination);
+			barriers.flush(*api, cmd);
+
 			api->vkCmdUpdateBuffer(cmd, dst.vulkan.get_handle(), offset, size, data);
 		}
 
 		void copy_buffer_region(Buffer const& src, Buffer& dst, size_t src_offset, size_t dst_offset, size_t size)
 		{
+			require_copy(src, dst);
+
 			VkBufferCopy const copy {
 				.srcOffset = src_offset,
 				.dstOffset = dst_offset,
@@ -168,6 +261,8 @@ namespace vt::vulkan
 
 		void copy_image_region(Image const& src, Image& dst, ImageCopyRegion const& region)
 		{
+			require_copy(src, dst);
+
 			VkImageCopy const copy {
 				.srcSubresource {
 					.aspectMask		= IMAGE_ASPECT_FLAGS_LOOKUP[src.get_format()],
@@ -201,6 +296,36 @@ namespace vt::vulkan
 								VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
 		}
 
+		void copy_buffer_region_to_image(Buffer const& src, Image& dst, BufferImageCopyRegion const& region)
+		{
+			require_copy(src, dst);
+
+			// Vulkan measures rows in texels instead of bytes.
+			auto const	   format	  = dst.get_format();
+			unsigned const extent	  = get_texel_block_extent(format);
+			size_t const   block_size = get_bits_per_texel(format) * extent * extent / 8;
+
+			VkBufferImageCopy const copy {
+				.bufferOffset	   = region.src_offset,
+				.bufferRowLength   = static_cast<uint32_t>(region.row_pitch / block_size * extent),
+				.bufferImageHeight = 0, // Zero here means the rows are tightly packed.
+				.imageSubresource {
+					.aspectMask		= IMAGE_ASPECT_FLAGS_LOOKUP[format],
+					.mipLevel		= region.dst_mip,
+					.baseArrayLayer = region.dst_array_index,
+					.layerCount		= 1,
+				},
+				.imageOffset = {0, 0, 0},
+				.imageExtent {
+					.width	= static_cast<uint32_t>(std::max(dst.get_width() >> region.dst_mip, 1)),
+					.height = static_cast<uint32_t>(std::max(dst.get_height() >> region.dst_mip, 1)),
+					.depth	= 1,
+				},
+			};
+			api->vkCmdCopyBufferToImage(cmd, src.vulkan.get_handle(), dst.vulkan.get_handle(),
+										VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+		}
+
 		void bind_compute_pipeline(ComputePipeline const& pipeline)
 		{
 			api->vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.vulkan.get_handle());
@@ -215,7 +340,14 @@ namespace vt::vulkan
 		{
 			auto& signature = this->bound_compute_layout;
 			auto  layout	= signature.get_compute_layout_handle();
-			bind_descriptor_sets(VK_PIPELINE_BIND_POINT_COMPUTE, signature, layout, descriptor_sets);
+			bind_descriptor_sets(VK_PIPELINE_BIND_POINT_COMPUTE, signature, layout, descriptor_sets, {});
+		}
+
+		void bind_compute_descriptors(ArrayView<DescriptorSet> descriptor_sets, ArrayView<unsigned> dynamic_offsets)
+		{
+			auto& signature = this->bound_compute_layout;
+			auto  layout	= signature.get_compute_layout_handle();
+			bind_descriptor_sets(VK_PIPELINE_BIND_POINT_COMPUTE, signature, layout, descriptor_sets, dynamic_offsets);
 		}
 
 		void push_compute_constants(size_t byte_offset, size_t byte_size, void const* data)
@@ -228,18 +360,24 @@ namespace vt::vulkan
 
 		void dispatch(unsigned x_count, unsigned y_count, unsigned z_count)
 		{
+			barriers.flush(*api, cmd);
 			api->vkCmdDispatch(cmd, x_count, y_count, z_count);
 		}
 
 		void dispatch_indirect(Buffer const& buffer, size_t offset)
 		{
+			require(buffer, BufferAccess::Indirect);
+			barriers.flush(*api, cmd);
 			api->vkCmdDispatchIndirect(cmd, buffer.vulkan.get_handle(), offset);
 		}
 
 		void begin_render_pass(RenderPass const&	 render_pass,
 							   RenderTarget const&	 render_target,
-							   ConstSpan<ClearValue> clear_values = {})
+							   ConstSpan<ClearValue> clear_values = {},
+							   SubpassContents		 contents	  = SubpassContents::Inline)
 		{
+			barriers.flush(*api, cmd);
+
 			VkRenderPassBeginInfo const begin_info {
 				.sType		 = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
 				.renderPass	 = render_pass.vulkan.get_handle(),
@@ -259,17 +397,55 @@ namespace vt::vulkan
 			};
 			// static_assert(std::is_layout_compatible_v<VkClearValue, ClearValue>); // TODO: Wait for compiler fix
 
-			api->vkCmdBeginRenderPass(cmd, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+			api->vkCmdBeginRenderPass(cmd, &begin_info, SUBPASS_CONTENTS_LOOKUP[contents]);
+			inside_render_pass = true;
 		}
 
-		void change_subpass()
+		void change_subpass(SubpassContents contents = SubpassContents::Inline)
 		{
-			api->vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+			api->vkCmdNextSubpass(cmd, SUBPASS_CONTENTS_LOOKUP[contents]);
 		}
 
 		void end_render_pass()
 		{
 			api->vkCmdEndRenderPass(cmd);
+			inside_render_pass = false;
+		}
+
+		void assume_attachment_layout(Image const& image, ImageLayout final_layout)
+		{
+			image.vulkan.get_state() = {
+				.stages		  = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
+				.access		  = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				.layout		  = IMAGE_LAYOUT_LOOKUP[final_layout],
+				.queue_family = queue_family,
+			};
+		}
+
+		void begin_secondary(RenderPass const& render_pass, unsigned subpass_index, RenderTarget const& render_target)
+		{
+			VkCommandBufferInheritanceInfo const inheritance_info {
+				.sType		 = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+				.renderPass	 = render_pass.vulkan.get_handle(),
+				.subpass	 = subpass_index,
+				.framebuffer = render_target.vulkan.get_handle(),
+			};
+			auto const usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+
+			VkCommandBufferBeginInfo const begin_info {
+				.sType			  = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+				.flags			  = static_cast<VkCommandBufferUsageFlags>(usage),
+				.pInheritanceInfo = &inheritance_info,
+			};
+			auto result = api->vkBeginCommandBuffer(cmd, &begin_info);
+			VT_CHECK_RESULT(result, "Failed to begin Vulkan secondary command buffer.");
+			inside_render_pass = true;
+		}
+
+		void execute_secondary_commands(ArrayView<CommandListHandle> cmds)
+		{
+			auto secondaries = reinterpret_cast<VkCommandBuffer const*>(cmds.data());
+			api->vkCmdExecuteCommands(cmd, count(cmds), secondaries);
 		}
 
 		void bind_render_pipeline(RenderPipeline const& pipeline)
@@ -286,7 +462,14 @@ namespace vt::vulkan
 		{
 			auto& signature = this->bound_render_layout;
 			auto  layout	= signature.get_render_layout_handle();
-			bind_descriptor_sets(VK_PIPELINE_BIND_POINT_GRAPHICS, signature, layout, descriptor_sets);
+			bind_descriptor_sets(VK_PIPELINE_BIND_POINT_GRAPHICS, signature, layout, descriptor_sets, {});
+		}
+
+		void bind_render_descriptors(ArrayView<DescriptorSet> descriptor_sets, ArrayView<unsigned> dynamic_offsets)
+		{
+			auto& signature = this->bound_render_layout;
+			auto  layout	= signature.get_render_layout_handle();
+			bind_descriptor_sets(VK_PIPELINE_BIND_POINT_GRAPHICS, signature, layout, descriptor_sets, dynamic_offsets);
 		}
 
 		void push_render_constants(size_t byte_offset, size_t byte_size, void const* data)
@@ -372,11 +555,13 @@ namespace vt::vulkan
 
 		void draw_indirect(Buffer const& buffer, size_t offset, unsigned draws)
 		{
+			assert_indirect_access(buffer);
 			api->vkCmdDrawIndirect(cmd, buffer.vulkan.get_handle(), offset, draws, sizeof(VkDrawIndirectCommand));
 		}
 
 		void draw_indexed_indirect(Buffer const& buffer, size_t offset, unsigned draws)
 		{
+			assert_indirect_access(buffer);
 			api->vkCmdDrawIndexedIndirect(cmd, buffer.vulkan.get_handle(), offset, draws, sizeof(VkDrawIndexedIndirectCommand));
 		}
 
@@ -384,6 +569,60 @@ namespace vt::vulkan
 		DeviceApiTable const* api;
 		UniqueVkCommandPool	  pool;
 		VkCommandBuffer		  cmd;
+		uint32_t			  queue_family;
+		BarrierBatch		  barriers;
+		bool				  inside_render_pass = false; // Also true while recording a secondary command list.
+
+		uint32_t get_queue_family(CommandType type) const
+		{
+			switch(type)
+			{
+				case CommandType::Copy: return api->queue_families.copy;
+				case CommandType::Compute: return api->queue_families.compute;
+				case CommandType::Render: return api->queue_families.render;
+			}
+			VT_UNREACHABLE();
+		}
+
+		// Makes the next barrier on the resource wait for all earlier memory accesses, since any of them might have gone to
+		// the same memory through another resource. Since the content is discarded, no queue family owns the resource.
+		static void discard_state(ResourceState& state)
+		{
+			state = {
+				.stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+				.access = VK_ACCESS_MEMORY_WRITE_BIT,
+			};
+		}
+
+		// Barriers cannot be recorded inside a render pass, and secondary command lists, which may be recorded in parallel,
+		// must not touch the resource states shared by all command lists.
+		void assert_outside_render_pass() const
+		{
+			VT_ASSERT(!inside_render_pass, "Resource states cannot change inside a render pass or secondary command list.");
+		}
+
+		void assert_indirect_access(Buffer const& buffer) const
+		{
+			VT_ASSERT(buffer.vulkan.get_state().access & VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+					  "Indirect arguments must be required for indirect access before the render pass begins.");
+		}
+
+		void require_copy(auto const& src, auto const& dst)
+		{
+			require_for_copy(src, true);
+			require_for_copy(dst, false);
+			barriers.flush(*api, cmd);
+		}
+
+		void require_for_copy(Buffer const& buffer, bool is_source)
+		{
+			require(buffer, is_source ? BufferAccess::CopySource : BufferAccess::CopyDestination);
+		}
+
+		void require_for_copy(Image const& image, bool is_source)
+		{
+			require(image, is_source ? ImageLayout::CopySource : ImageLayout::CopyDestination);
+		}
 
 		static VkIndexType get_index_type_from_stride(unsigned stride)
 		{
@@ -395,15 +634,27 @@ namespace vt::vulkan
 			VT_UNREACHABLE();
 		}
 
+		// Each descriptor set with a dynamic descriptor consumes one dynamic offset, in the order of the descriptor sets.
 		void bind_descriptor_sets(VkPipelineBindPoint				   bind_point,
 								  CommandListPipelineLayoutData const& root_signature,
 								  VkPipelineLayout					   layout,
-								  ArrayView<DescriptorSet>			   descriptor_sets) const
+								  ArrayView<DescriptorSet>			   descriptor_sets,
+								  ConstSpan<unsigned>				   dynamic_offsets) const
 		{
 			SmallList<VkDescriptorSet> sets;
 			sets.reserve(descriptor_sets.size());
 
+			auto	 offsets	  = dynamic_offsets.data();
+			uint32_t offset_count = 0;
+
+			auto bind_sets = [&](uint32_t first) {
+				api->vkCmdBindDescriptorSets(cmd, bind_point, layout, first, count(sets), sets.data(), offset_count, offsets);
+				offsets	    += offset_count;
+				offset_count = 0;
+			};
+
 			sets.emplace_back(descriptor_sets[0].vulkan.get_handle());
+			offset_count += descriptor_sets[0].vulkan.has_dynamic_offset();
 			uint32_t start_index = root_signature.get_layout_index(descriptor_sets[0].vulkan.get_layout());
 			uint32_t prev_index	 = start_index;
 
@@ -412,14 +663,17 @@ namespace vt::vulkan
 				uint32_t index = root_signature.get_layout_index(set.vulkan.get_layout());
 				if(index != prev_index + 1)
 				{
-					api->vkCmdBindDescriptorSets(cmd, bind_point, layout, start_index, count(sets), sets.data(), 0, nullptr);
+					bind_sets(start_index);
 					sets.clear();
 					start_index = index;
 				}
 				sets.emplace_back(set.vulkan.get_handle());
+				offset_count += set.vulkan.has_dynamic_offset();
 				++prev_index;
 			}
-			api->vkCmdBindDescriptorSets(cmd, bind_point, layout, start_index, count(sets), sets.data(), 0, nullptr);
+			bind_sets(start_index);
+			VT_ASSERT(offsets == dynamic_offsets.data() + dynamic_offsets.size(),
+					  "There must be one dynamic offset for each descriptor set with a dynamic descriptor.");
 		}
 	};
 }
@@ -21,14 +21,16 @@ namespace vt::vulkan
 		LookupTable<VkDescriptorType, uint32_t, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT + 1> _;
 
 		// Feel free to change any of these should the need arise.
-		_[VK_DESCRIPTOR_TYPE_SAMPLER]			   = 256;
-		_[VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE]		   = 10000;
-		_[VK_DESCRIPTOR_TYPE_STORAGE_IMAGE]		   = 128;
-		_[VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER] = 64;
-		_[VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER] = 64;
-		_[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER]	   = 128;
-		_[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER]	   = 128;
-		_[VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT]	   = 128;
+		_[VK_DESCRIPTOR_TYPE_SAMPLER]				 = 256;
+		_[VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE]			 = 10000;
+		_[VK_DESCRIPTOR_TYPE_STORAGE_IMAGE]			 = 128;
+		_[VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER]	 = 64;
+		_[VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER]	 = 64;
+		_[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER]		 = 128;
+		_[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER]		 = 128;
+		_[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC] = 64;
+		_[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC] = 64;
+		_[VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT]		 = 128;
 		return _;
 	}();
 
@@ -57,6 +59,8 @@ namespace vt::vulkan
 				{VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, MAX_SIZES[VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER]},
 				make_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, lim.maxPerStageDescriptorUniformBuffers),
 				make_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, lim.maxPerStageDescriptorStorageBuffers),
+				{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, MAX_SIZES[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC]},
+				{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, MAX_SIZES[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC]},
 				make_pool_size(VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, lim.maxPerStageDescriptorInputAttachments),
 			};
 			max_sampler_descriptors	 = sizes[0].descriptorCount;
@@ -100,9 +104,12 @@ namespace vt::vulkan
 
 			SmallList<DescriptorSet> final_sets;
 			final_sets.reserve(layouts.size());
-			auto layout = set_layouts.begin();
+			auto layout = layouts.begin();
 			for(auto set : sets)
-				final_sets.emplace_back(VulkanDescriptorSet(set, *layout++));
+			{
+				auto& set_layout = layout++->vulkan;
+				final_sets.emplace_back(VulkanDescriptorSet(set, set_layout.get_handle(), set_layout.has_dynamic_offset()));
+			}
 
 			return final_sets;
 		}
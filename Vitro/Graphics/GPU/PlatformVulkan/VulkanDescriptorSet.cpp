@@ -8,7 +8,8 @@ namespace vt::vulkan
 	export class VulkanDescriptorSet
 	{
 	public:
-		VulkanDescriptorSet(VkDescriptorSet set, VkDescriptorSetLayout layout) : set(set), layout(layout)
+		VulkanDescriptorSet(VkDescriptorSet set, VkDescriptorSetLayout layout, bool dynamic_offset) :
+			set(set), layout(layout), dynamic_offset(dynamic_offset)
 		{}
 
 		VkDescriptorSet get_handle() const
@@ -21,8 +22,14 @@ namespace vt::vulkan
 			return layout;
 		}
 
+		bool has_dynamic_offset() const
+		{
+			return dynamic_offset;
+		}
+
 	private:
 		VkDescriptorSet		  set;
 		VkDescriptorSetLayout layout;
+		bool				  dynamic_offset;
 	};
 }
@@ -20,17 +20,19 @@ namespace vt::vulkan
 		LookupTable<DescriptorType, VkDescriptorType> _;
 		using enum DescriptorType;
 
-		_[Sampler]			   = VK_DESCRIPTOR_TYPE_SAMPLER;
-		_[Texture]			   = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-		_[RwTexture]		   = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-		_[Buffer]			   = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-		_[RwBuffer]			   = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-		_[UniformBuffer]	   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		_[StructuredBuffer]	   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-		_[RwStructuredBuffer]  = _[StructuredBuffer];
-		_[ByteAddressBuffer]   = _[StructuredBuffer];
-		_[RwByteAddressBuffer] = _[StructuredBuffer];
-		_[InputAttachment]	   = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+		_[Sampler]				   = VK_DESCRIPTOR_TYPE_SAMPLER;
+		_[Texture]				   = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+		_[RwTexture]			   = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		_[Buffer]				   = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+		_[RwBuffer]				   = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+		_[UniformBuffer]		   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		_[StructuredBuffer]		   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		_[RwStructuredBuffer]	   = _[StructuredBuffer];
+		_[ByteAddressBuffer]	   = _[StructuredBuffer];
+		_[RwByteAddressBuffer]	   = _[StructuredBuffer];
+		_[InputAttachment]		   = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+		_[DynamicUniformBuffer]	   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		_[DynamicStructuredBuffer] = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
 		return _;
 	}();
 
@@ -55,14 +57,16 @@ namespace vt::vulkan
 
 	export constexpr inline auto REGISTER_OFFSET_LOOKUP = [] {
 		LookupTable<VkDescriptorType, unsigned, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT + 1> _;
-		_[VK_DESCRIPTOR_TYPE_SAMPLER]			   = tool::S_BINDING_OFFSET;
-		_[VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE]		   = tool::T_BINDING_OFFSET;
-		_[VK_DESCRIPTOR_TYPE_STORAGE_IMAGE]		   = tool::U_BINDING_OFFSET;
-		_[VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER] = tool::T_BINDING_OFFSET;
-		_[VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER] = tool::U_BINDING_OFFSET;
-		_[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER]	   = tool::B_BINDING_OFFSET;
-		_[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER]	   = tool::U_BINDING_OFFSET;
-		_[VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT]	   = tool::U_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_SAMPLER]				 = tool::S_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE]			 = tool::T_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_STORAGE_IMAGE]			 = tool::U_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER]	 = tool::T_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER]	 = tool::U_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER]		 = tool::B_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER]		 = tool::U_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC] = tool::B_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC] = tool::T_BINDING_OFFSET;
+		_[VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT]		 = tool::U_BINDING_OFFSET;
 		return _;
 	}();
 
@@ -97,6 +101,12 @@ namespace vt::vulkan
 					flags.emplace_back(VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT);
 				else
 					flags.emplace_back(0);
+
+				if(type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC)
+				{
+					VT_ASSERT(!dynamic_offset && binding.count == 1, "Layouts can only hold one dynamic buffer descriptor.");
+					dynamic_offset = true;
+				}
 			}
 
 			VkDescriptorSetLayoutBindingFlagsCreateInfo const flags_info {
@@ -119,8 +129,15 @@ namespace vt::vulkan
 			return layout.get();
 		}
 
+		// Whether descriptor sets of this layout take a dynamic offset when they are bound.
+		bool has_dynamic_offset() const
+		{
+			return dynamic_offset;
+		}
+
 	private:
 		UniqueVkDescriptorSetLayout layout;
 		std::vector<VulkanSampler>	static_samplers;
+		bool						dynamic_offset = false;
 	};
 }
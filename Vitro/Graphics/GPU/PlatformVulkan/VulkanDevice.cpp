@@ -2,9 +2,12 @@ module;
 #include "VitroCore/Macros.hpp"
 #include "VulkanAPI.hpp"
 
+#include <algorithm>
 #include <array>
 #include <bit>
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string_view>
 #include <vector>
 export module vt.Graphics.Vulkan.Device;
@@ -16,7 +19,9 @@ import vt.Graphics.Handle;
 import vt.Graphics.RingBuffer;
 import vt.Graphics.Vulkan.DescriptorPool;
 import vt.Graphics.Vulkan.Handle;
+import vt.Graphics.Vulkan.PipelineCache;
 import vt.Graphics.Vulkan.SyncTokenPool;
+import vt.Trace.Log;
 
 namespace vt::vulkan
 {
@@ -26,14 +31,23 @@ namespace vt::vulkan
 		VulkanDevice(Adapter const& in_adapter, VkPhysicalDeviceProperties const& properties) :
 			adapter(in_adapter.vulkan),
 			queue_families(query_queue_families()),
+			uses_timeline_semaphores(query_timeline_semaphore_support()),
 			device(make_device()),
 			api(std::make_unique<DeviceApiTable>(InstanceApiTable::get().vkGetDeviceProcAddr, adapter, device.get())),
 			sync_tokens(*api),
-			descriptor_pool(*api, properties)
+			descriptor_pool(*api, properties),
+			// Heap-allocated, because it holds a mutex and the device must stay movable.
+			pipeline_cache(std::make_unique<PipelineCache>(*api, properties))
 		{
 			api->vkGetDeviceQueue(device.get(), queue_families.render, 0, &render_queue);
 			api->vkGetDeviceQueue(device.get(), queue_families.compute, 0, &compute_queue);
 			api->vkGetDeviceQueue(device.get(), queue_families.copy, 0, &copy_queue);
+			api->queue_families = queue_families;
+
+			if(uses_timeline_semaphores)
+				timelines.emplace(QueueTimelines {*api, *api, *api});
+			else
+				Log().info("Vulkan timeline semaphores are not supported, falling back to fences.");
 
 			initialize_allocator();
 		}
@@ -53,6 +67,11 @@ namespace vt::vulkan
 			return VulkanCommandList<CommandType::Render>(queue_families.render, *api);
 		}
 
+		RenderCommandList make_secondary_render_command_list() override
+		{
+			return VulkanCommandList<CommandType::Render>(queue_families.render, *api, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+		}
+
 		Buffer make_buffer(BufferSpecification const& spec) override
 		{
 			return {
@@ -69,7 +88,41 @@ namespace vt::vulkan
 			};
 		}
 
-		SmallList<ComputePipeline> make_compute_pipelines(ArrayView<ComputePipelineSpecification> specs) override
+		TransientHeap make_transient_heap(TransientHeapSpecification const& spec) override
+		{
+			return {
+				VulkanTransientHeap(spec, *api),
+				spec,
+			};
+		}
+
+		Buffer make_placed_buffer(BufferSpecification const& spec, TransientHeap const& heap, size_t offset) override
+		{
+			return {
+				VulkanBuffer(spec, *api, heap.vulkan, offset),
+				spec,
+			};
+		}
+
+		Image make_placed_image(ImageSpecification const& spec, TransientHeap const& heap, size_t offset) override
+		{
+			return {
+				VulkanImage(spec, *api, heap.vulkan, offset),
+				spec,
+			};
+		}
+
+		MemoryRequirements get_memory_requirements(BufferSpecification const& spec) override
+		{
+			return VulkanBuffer::get_memory_requirements(spec, *api);
+		}
+
+		MemoryRequirements get_memory_requirements(ImageSpecification const& spec) override
+		{
+			return VulkanImage::get_memory_requirements(spec, *api);
+		}
+
+		std::vector<ComputePipeline> make_compute_pipelines(ArrayView<ComputePipelineSpecification> specs) override
 		{
 			Array<VkComputePipelineCreateInfo> pipeline_infos(specs.size());
 
@@ -79,8 +132,11 @@ namespace vt::vulkan
 
 			Array<VkPipeline> pipelines(specs.size());
 
-			auto result = api->vkCreateComputePipelines(api->device, pipeline_cache.get(), count(pipeline_infos),
-														pipeline_infos.data(), nullptr, pipelines.data());
+			auto start	= std::chrono::steady_clock::now();
+			auto cache	= pipeline_cache->get_for_current_thread();
+			auto result = api->vkCreateComputePipelines(api->device, cache, count(pipeline_infos), pipeline_infos.data(),
+														nullptr, pipelines.data());
+			log_pipeline_creation_time("compute", specs.size(), start);
 
 			std::vector<ComputePipeline> compute_pipelines;
 			compute_pipelines.reserve(specs.size());
@@ -107,8 +163,11 @@ namespace vt::vulkan
 
 			Array<VkPipeline> pipelines(specs.size());
 
-			auto result = api->vkCreateGraphicsPipelines(device.get(), pipeline_cache.get(), count(pipeline_infos),
-														 pipeline_infos.data(), nullptr, pipelines.data());
+			auto start	= std::chrono::steady_clock::now();
+			auto cache	= pipeline_cache->get_for_current_thread();
+			auto result = api->vkCreateGraphicsPipelines(device.get(), cache, count(pipeline_infos), pipeline_infos.data(),
+														 nullptr, pipelines.data());
+			log_pipeline_creation_time("render", specs.size(), start);
 
 			std::vector<RenderPipeline> render_pipelines;
 			render_pipelines.reserve(specs.size());
@@ -119,25 +178,34 @@ namespace vt::vulkan
 			return render_pipelines;
 		}
 
-		std::vector<DescriptorSet> make_descriptor_sets(ArrayView<DescriptorSetLayout> layouts,
-														unsigned const				   variable_counts[]) override
+		SmallList<DescriptorSet> make_descriptor_sets(ArrayView<DescriptorSetLayout> layouts,
+													  unsigned const				 variable_counts[]) override
 		{
 			return descriptor_pool.make_descriptor_sets(layouts, variable_counts, *api);
 		}
 
 		DescriptorSetLayout make_descriptor_set_layout(DescriptorSetLayoutSpecification const& spec) override
 		{
-			return VulkanDescriptorSetLayout(spec, *api);
+			return {
+				VulkanDescriptorSetLayout(spec, *api),
+				spec,
+			};
 		}
 
 		RenderPass make_render_pass(RenderPassSpecification const& spec) override
 		{
-			return VulkanRenderPass(spec, *api);
+			return {
+				VulkanRenderPass(spec, *api),
+				spec,
+			};
 		}
 
 		RootSignature make_root_signature(RootSignatureSpecification const& spec) override
 		{
-			return VulkanRootSignature(spec, *api);
+			return {
+				VulkanRootSignature(spec, *api),
+				spec,
+			};
 		}
 
 		Sampler make_sampler(SamplerSpecification const& spec) override
@@ -147,7 +215,9 @@ namespace vt::vulkan
 
 		Shader make_shader(char const path[]) override
 		{
-			return VulkanShader(path, *api);
+			VulkanShader shader(path, *api);
+			auto		 content_hash = shader.get_content_hash();
+			return {std::move(shader), content_hash};
 		}
 
 		SwapChain make_swap_chain(Window& window, uint8_t buffer_count = SwapChain::DEFAULT_BUFFERS) override
@@ -213,38 +283,77 @@ namespace vt::vulkan
 
 		SyncToken submit_render_commands(ArrayView<CommandListHandle> cmds, ConstSpan<SyncToken> gpu_wait_tokens = {}) override
 		{
-			return submit(render_queue, cmds, gpu_wait_tokens);
+			return submit(render_queue, get_timeline(&QueueTimelines::render), cmds, gpu_wait_tokens);
 		}
 
 		SyncToken submit_compute_commands(ArrayView<CommandListHandle> cmds, ConstSpan<SyncToken> gpu_wait_tokens = {}) override
 		{
-			return submit(compute_queue, cmds, gpu_wait_tokens);
+			return submit(compute_queue, get_timeline(&QueueTimelines::compute), cmds, gpu_wait_tokens);
 		}
 
 		SyncToken submit_copy_commands(ArrayView<CommandListHandle> cmds, ConstSpan<SyncToken> gpu_wait_tokens = {}) override
 		{
-			return submit(copy_queue, cmds, gpu_wait_tokens);
+			return submit(copy_queue, get_timeline(&QueueTimelines::copy), cmds, gpu_wait_tokens);
 		}
 
 		SyncToken submit_for_present(ArrayView<CommandListHandle> cmds,
 									 SwapChain&					  swap_chain,
 									 ConstSpan<SyncToken>		  gpu_wait_tokens = {}) override
 		{
-			auto submit_token = submit(render_queue, cmds, gpu_wait_tokens);
-			swap_chain.vulkan.present(submit_token.vulkan.semaphore, render_queue);
+			VkSemaphore present_semaphore;
+
+			auto submit_token = submit(render_queue, get_timeline(&QueueTimelines::render), cmds, gpu_wait_tokens,
+									   &present_semaphore);
+			swap_chain.vulkan.present(present_semaphore, render_queue);
 			return submit_token;
 		}
 
 		void wait_for_workload(SyncToken cpu_wait_token) override
 		{
-			uint64_t resets = cpu_wait_token.vulkan.resets;
-			if(resets == 0 || resets != sync_tokens.get_current_resets(cpu_wait_token))
-				return; // The token is either already reused, meaning its workload must be done, or default-initialized.
+			auto& token = cpu_wait_token.vulkan;
+			if(token.value == 0)
+				return; // The token is default-initialized.
+
+			if(!token.fence)
+			{
+				VkSemaphoreWaitInfoKHR const wait_info {
+					.sType			= VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
+					.semaphoreCount = 1,
+					.pSemaphores	= &token.semaphore,
+					.pValues		= &token.value,
+				};
+				auto result = api->vkWaitSemaphoresKHR(device.get(), &wait_info, UINT64_MAX);
+				VT_CHECK_RESULT(result, "Failed to wait for Vulkan timeline semaphore.");
+				return;
+			}
 
-			auto result = api->vkWaitForFences(device.get(), 1, &cpu_wait_token.vulkan.fence, false, UINT64_MAX);
+			if(token.value != sync_tokens.get_current_resets(cpu_wait_token))
+				return; // The token is already reused, meaning its workload must be done.
+
+			auto result = api->vkWaitForFences(device.get(), 1, &token.fence, false, UINT64_MAX);
 			VT_CHECK_RESULT(result, "Failed to wait for Vulkan fence.");
 		}
 
+		bool is_workload_done(SyncToken token) override
+		{
+			auto& vulkan_token = token.vulkan;
+			if(vulkan_token.value == 0)
+				return true; // The token is default-initialized.
+
+			if(!vulkan_token.fence)
+			{
+				uint64_t value;
+				auto	 result = api->vkGetSemaphoreCounterValueKHR(device.get(), vulkan_token.semaphore, &value);
+				VT_CHECK_RESULT(result, "Failed to query Vulkan timeline semaphore.");
+				return value >= vulkan_token.value;
+			}
+
+			if(vulkan_token.value != sync_tokens.get_current_resets(token))
+				return true; // The token is already reused, meaning its workload must be done.
+
+			return api->vkGetFenceStatus(device.get(), vulkan_token.fence) == VK_SUCCESS;
+		}
+
 		void flush_render_queue() override
 		{
 			auto result = api->vkQueueWaitIdle(render_queue);
@@ -288,11 +397,11 @@ namespace vt::vulkan
 
 		static constexpr VkPhysicalDeviceFeatures REQUIRED_FEATURES {};
 
-		struct QueueFamilies
+		struct QueueTimelines
 		{
-			uint32_t render	 = UINT32_MAX;
-			uint32_t compute = UINT32_MAX;
-			uint32_t copy	 = UINT32_MAX;
+			QueueTimeline render;
+			QueueTimeline compute;
+			QueueTimeline copy;
 		};
 
 		struct DeviceDeleter
@@ -317,16 +426,30 @@ namespace vt::vulkan
 
 		VkPhysicalDevice				adapter;
 		QueueFamilies					queue_families;
+		bool							uses_timeline_semaphores;
 		UniqueVkDevice					device;
 		std::unique_ptr<DeviceApiTable> api;
 		SyncTokenPool					sync_tokens;
 		DescriptorPool					descriptor_pool;
-		UniqueVkPipelineCache			pipeline_cache;
+		std::unique_ptr<PipelineCache>	pipeline_cache;
 		VkQueue							render_queue;
 		VkQueue							compute_queue;
 		VkQueue							copy_queue;
+		std::optional<QueueTimelines>	timelines; // Empty if timeline semaphores are not supported.
 		UniqueVmaAllocator				allocator;
 
+		// Reports pipeline creation times, so that runs with a cold and a warm pipeline cache can be compared.
+		void log_pipeline_creation_time(char const							  kind[],
+										size_t								  pipeline_count,
+										std::chrono::steady_clock::time_point start) const
+		{
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+			auto cache_state = pipeline_cache->is_warm() ? "warm" : "cold";
+			Log().info("Made ", pipeline_count, " Vulkan ", kind, " pipelines in ", elapsed.count(), " ms with a ", cache_state,
+					   " pipeline cache.");
+		}
+
 		static bool check_queue_flags(VkQueueFlags flags, VkQueueFlags wanted, VkQueueFlags unwanted)
 		{
 			return flags & wanted && !(flags & unwanted);
@@ -361,11 +484,15 @@ namespace vt::vulkan
 				}
 			}
 
+			// Dynamic descriptors only cover a range starting at the offset given when binding them.
+			bool const is_dynamic = type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+									type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+			VT_ASSERT(!is_dynamic || update.dynamic_range != 0, "Dynamic buffer descriptors need a nonzero range.");
 			for(Buffer const& buffer : update.buffers)
 				buffer_infos.emplace_back(VkDescriptorBufferInfo {
 					.buffer = buffer.vulkan.get_handle(),
 					.offset = 0,
-					.range	= buffer.get_size(),
+					.range	= is_dynamic ? update.dynamic_range : buffer.get_size(),
 				});
 			return count(update.buffers);
 		}
@@ -436,11 +563,41 @@ namespace vt::vulkan
 			return families;
 		}
 
+		bool query_timeline_semaphore_support() const
+		{
+			auto extensions = query_device_extensions();
+
+			auto is_timeline_extension = [](VkExtensionProperties const& extension) {
+				return std::string_view(extension.extensionName) == VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME;
+			};
+			if(std::none_of(extensions.begin(), extensions.end(), is_timeline_extension))
+				return false;
+
+			VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_features {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+			};
+			VkPhysicalDeviceFeatures2KHR features {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR,
+				.pNext = &timeline_features,
+			};
+			InstanceApiTable::get().vkGetPhysicalDeviceFeatures2KHR(adapter, &features);
+			return timeline_features.timelineSemaphore;
+		}
+
 		UniqueVkDevice make_device() const
 		{
 			ensure_device_extensions_exist();
 			ensure_features_exist();
 
+			SmallList<char const*> extensions(std::begin(REQUIRED_DEVICE_EXTENSIONS), std::end(REQUIRED_DEVICE_EXTENSIONS));
+			if(uses_timeline_semaphores)
+				extensions.emplace_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+
+			VkPhysicalDeviceTimelineSemaphoreFeaturesKHR const timeline_features {
+				.sType			   = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+				.timelineSemaphore = true,
+			};
+
 			float const priorities[] {1.0f};
 
 			VkDeviceQueueCreateInfo const queue_info {
@@ -455,12 +612,13 @@ namespace vt::vulkan
 
 			VkDeviceCreateInfo const device_info {
 				.sType					 = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+				.pNext					 = uses_timeline_semaphores ? &timeline_features : nullptr,
 				.queueCreateInfoCount	 = count(queue_infos),
 				.pQueueCreateInfos		 = queue_infos,
 				.enabledLayerCount		 = 0,
 				.ppEnabledLayerNames	 = nullptr,
-				.enabledExtensionCount	 = count(REQUIRED_DEVICE_EXTENSIONS),
-				.ppEnabledExtensionNames = REQUIRED_DEVICE_EXTENSIONS,
+				.enabledExtensionCount	 = count(extensions),
+				.ppEnabledExtensionNames = extensions.data(),
 				.pEnabledFeatures		 = &REQUIRED_FEATURES,
 			};
 			UniqueVkDevice fresh_device;
@@ -471,7 +629,7 @@ namespace vt::vulkan
 			return fresh_device;
 		}
 
-		void ensure_device_extensions_exist() const
+		Array<VkExtensionProperties> query_device_extensions() const
 		{
 			auto& driver = InstanceApiTable::get();
 
@@ -483,6 +641,12 @@ namespace vt::vulkan
 			result = driver.vkEnumerateDeviceExtensionProperties(adapter, nullptr, &extension_count, extensions.data());
 			VT_CHECK_RESULT(result, "Failed to enumerate Vulkan device extensions.");
 
+			return extensions;
+		}
+
+		void ensure_device_extensions_exist() const
+		{
+			auto extensions = query_device_extensions();
 			for(std::string_view required_ext : REQUIRED_DEVICE_EXTENSIONS)
 			{
 				bool found = false;
@@ -569,29 +733,68 @@ namespace vt::vulkan
 			return ptr;
 		}
 
-		SyncToken submit(VkQueue queue, ArrayView<CommandListHandle> cmds, ConstSpan<SyncToken> gpu_wait_tokens)
+		QueueTimeline* get_timeline(QueueTimeline QueueTimelines::*queue_timeline)
 		{
-			SmallList<VkSemaphore> wait_semaphores(gpu_wait_tokens.size());
+			return timelines ? &(*timelines.*queue_timeline) : nullptr;
+		}
 
-			auto semaphore = wait_semaphores.begin();
+		// Without a timeline, the returned token refers to a fence and binary semaphore from the pool. When a semaphore for
+		// presenting is requested, a binary semaphore is signaled as well, since presenting cannot wait for a timeline.
+		SyncToken submit(VkQueue					  queue,
+						 QueueTimeline*				  timeline,
+						 ArrayView<CommandListHandle> cmds,
+						 ConstSpan<SyncToken>		  gpu_wait_tokens,
+						 VkSemaphore*				  present_semaphore = nullptr)
+		{
+			SmallList<VkSemaphore>			wait_semaphores;
+			SmallList<uint64_t>				wait_values;
+			SmallList<VkPipelineStageFlags> wait_stages;
 			for(auto& token : gpu_wait_tokens)
-				*semaphore++ = token.vulkan.semaphore;
+			{
+				if(token.vulkan.value == 0)
+					continue; // Default-initialized tokens have nothing to wait for.
 
-			auto token = sync_tokens.acquire_token(*api);
+				wait_semaphores.emplace_back(token.vulkan.semaphore);
+				wait_values.emplace_back(token.vulkan.value); // Ignored for binary semaphores.
+				wait_stages.emplace_back(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+			}
 
-			VkPipelineStageFlags stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			auto	token = timeline ? timeline->make_next_token() : sync_tokens.acquire_token(*api);
+			VkFence fence = token.vulkan.fence;
 
+			SmallList<VkSemaphore> signal_semaphores {token.vulkan.semaphore};
+			SmallList<uint64_t>	   signal_values {token.vulkan.value};
+			if(present_semaphore && timeline)
+			{
+				// The pool's fence is signaled by this submission, so that the pool can tell when to reuse the semaphore.
+				auto present_token = sync_tokens.acquire_token(*api);
+				fence			   = present_token.vulkan.fence;
+				signal_semaphores.emplace_back(present_token.vulkan.semaphore);
+				signal_values.emplace_back(0);
+				*present_semaphore = present_token.vulkan.semaphore;
+			}
+			else if(present_semaphore)
+				*present_semaphore = token.vulkan.semaphore;
+
+			VkTimelineSemaphoreSubmitInfoKHR const timeline_info {
+				.sType					   = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+				.waitSemaphoreValueCount   = count(wait_values),
+				.pWaitSemaphoreValues	   = wait_values.data(),
+				.signalSemaphoreValueCount = count(signal_values),
+				.pSignalSemaphoreValues	   = signal_values.data(),
+			};
 			VkSubmitInfo const submit {
 				.sType				  = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+				.pNext				  = uses_timeline_semaphores ? &timeline_info : nullptr,
 				.waitSemaphoreCount	  = count(wait_semaphores),
 				.pWaitSemaphores	  = wait_semaphores.data(),
-				.pWaitDstStageMask	  = &stages,
+				.pWaitDstStageMask	  = wait_stages.data(),
 				.commandBufferCount	  = count(cmds),
 				.pCommandBuffers	  = reinterpret_cast<VkCommandBuffer const*>(cmds.data()),
-				.signalSemaphoreCount = 1,
-				.pSignalSemaphores	  = &token.vulkan.semaphore,
+				.signalSemaphoreCount = count(signal_semaphores),
+				.pSignalSemaphores	  = signal_semaphores.data(),
 			};
-			auto result = api->vkQueueSubmit(queue, 1, &submit, token.vulkan.fence);
+			auto result = api->vkQueueSubmit(queue, 1, &submit, fence);
 			VT_CHECK_RESULT(result, "Failed to submit to Vulkan queue.");
 
 			return token;
@@ -156,6 +156,7 @@ namespace vt::vulkan
 #endif
 
 			VK_KHR_SURFACE_EXTENSION_NAME,
+			VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, // Needed to query timeline semaphore support.
 
 			// Will not actually get submitted unless debug features are requested during driver creation. This should always be
 			// the last extension.
@@ -12,11 +12,33 @@ namespace vt::vulkan
 	export using VulkanAdapter			 = VkPhysicalDevice;
 	export using VulkanCommandListHandle = VkCommandBuffer;
 
+	// Tokens of queue timelines have no fence, a timeline semaphore and the value it reaches once the workload is done. Tokens
+	// from the sync token pool have a fence, a binary semaphore and the fence's reset count at the time of acquisition.
 	export struct VulkanSyncToken
 	{
 		VkFence		fence	  = nullptr;
 		VkSemaphore semaphore = nullptr;
-		uint64_t	resets	  = 0;
+		uint64_t	value	  = 0;
+	};
+
+	export struct QueueFamilies
+	{
+		uint32_t render	 = UINT32_MAX;
+		uint32_t compute = UINT32_MAX;
+		uint32_t copy	 = UINT32_MAX;
+	};
+
+	// The last known access of a buffer or image in recording order, which the next barrier on it has to wait for. While an
+	// ownership transfer to another queue family is pending, the releasing family and the layout before the release are kept,
+	// because the acquiring barrier has to repeat them.
+	export struct ResourceState
+	{
+		VkPipelineStageFlags stages				= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		VkAccessFlags		 access				= 0;
+		VkImageLayout		 layout				= VK_IMAGE_LAYOUT_UNDEFINED;
+		uint32_t			 queue_family		= VK_QUEUE_FAMILY_IGNORED; // Ignored until the resource is first used.
+		uint32_t			 releasing_family	= VK_QUEUE_FAMILY_IGNORED;
+		VkImageLayout		 pre_release_layout = VK_IMAGE_LAYOUT_UNDEFINED;
 	};
 
 	// This struct is essentially a globally unique vtable for all Vulkan functions that are either device-independent, need to
@@ -44,6 +66,7 @@ namespace vt::vulkan
 		INSTANCE_FUNC(vkEnumeratePhysicalDevices)
 		INSTANCE_FUNC(vkGetDeviceProcAddr)
 		INSTANCE_FUNC(vkGetPhysicalDeviceFeatures)
+		INSTANCE_FUNC(vkGetPhysicalDeviceFeatures2KHR)
 		INSTANCE_FUNC(vkGetPhysicalDeviceMemoryProperties)
 		INSTANCE_FUNC(vkGetPhysicalDeviceProperties)
 		INSTANCE_FUNC(vkGetPhysicalDeviceQueueFamilyProperties)
@@ -58,17 +81,18 @@ namespace vt::vulkan
 	};
 
 	// This struct is essentially a custom vtable for all the Vulkan functions associated with a specific Vulkan device as well
-	// as providing the device, physical device and allocator itself. It loads the device-specific functions right from the
-	// device driver. This way is recommended since using the global function prototypes and implicit dynamic linking requires
-	// the Vulkan shared library to dispatch manually to the right device driver, which is entirely avoidable overhead. Keeping
-	// pointers to it around is safe, since a specific instance of this table is only destroyed when the VkDevice is destroyed
-	// and it exists in its own heap allocation.
+	// as providing the device, physical device, allocator and queue families itself. It loads the device-specific functions
+	// right from the device driver. This way is recommended since using the global function prototypes and implicit dynamic
+	// linking requires the Vulkan shared library to dispatch manually to the right device driver, which is entirely avoidable
+	// overhead. Keeping pointers to it around is safe, since a specific instance of this table is only destroyed when the
+	// VkDevice is destroyed and it exists in its own heap allocation.
 	export struct DeviceApiTable : NoCopyNoMove
 	{
 		PFN_vkGetDeviceProcAddr const vkGetDeviceProcAddr;
 		VkPhysicalDevice const		  adapter;
 		VkDevice const				  device;
 		VmaAllocator				  allocator;
+		QueueFamilies				  queue_families;
 
 #define DEVICE_FUNC(FUNC) PFN_##FUNC const FUNC = reinterpret_cast<PFN_##FUNC>(vkGetDeviceProcAddr(device, #FUNC));
 
@@ -149,9 +173,11 @@ namespace vt::vulkan
 		DEVICE_FUNC(vkGetFenceStatus)
 		DEVICE_FUNC(vkGetImageMemoryRequirements)
 		DEVICE_FUNC(vkGetPipelineCacheData)
+		DEVICE_FUNC(vkGetSemaphoreCounterValueKHR)
 		DEVICE_FUNC(vkGetSwapchainImagesKHR)
 		DEVICE_FUNC(vkInvalidateMappedMemoryRanges)
 		DEVICE_FUNC(vkMapMemory)
+		DEVICE_FUNC(vkMergePipelineCaches)
 		DEVICE_FUNC(vkQueuePresentKHR)
 		DEVICE_FUNC(vkQueueSubmit)
 		DEVICE_FUNC(vkQueueWaitIdle)
@@ -161,6 +187,7 @@ namespace vt::vulkan
 		DEVICE_FUNC(vkUnmapMemory)
 		DEVICE_FUNC(vkUpdateDescriptorSets)
 		DEVICE_FUNC(vkWaitForFences)
+		DEVICE_FUNC(vkWaitSemaphoresKHR)
 
 		DeviceApiTable(PFN_vkGetDeviceProcAddr vkGetDeviceProcAddr, VkPhysicalDevice adapter, VkDevice device) :
 			vkGetDeviceProcAddr(vkGetDeviceProcAddr), adapter(adapter), device(device)
@@ -8,6 +8,7 @@ export module vt.Graphics.Vulkan.Image;
 import vt.Core.LookupTable;
 import vt.Graphics.AssetResourceSpecification;
 import vt.Graphics.Vulkan.Handle;
+import vt.Graphics.Vulkan.TransientHeap;
 
 namespace vt::vulkan
 {
@@ -216,7 +217,8 @@ namespace vt::vulkan
 			flags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 		if(usage & DepthStencil)
 			flags |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-		if(usage & Transient)
+		// Vulkan only allows attachments to be transient, but other transient images can still share memory.
+		if(usage & Transient && !(usage & (CopySrc | CopyDst | Sampled | Storage)))
 			flags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
 		if(usage & InputAttachment)
 			flags |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
@@ -318,13 +320,45 @@ namespace vt::vulkan
 	export class VulkanImage
 	{
 	public:
-		VulkanImage(ImageSpecification const& spec, DeviceApiTable const& api, VmaAllocator allocator)
+		VulkanImage(ImageSpecification const& spec, DeviceApiTable const& api, VmaAllocator allocator) :
+			aspect(IMAGE_ASPECT_FLAGS_LOOKUP[spec.format])
 		{
 			initialize_image(spec, allocator);
 			image.get_deleter().api = &api;
 			initialize_image_view(spec, api);
 		}
 
+		// Places the image into the transient heap at the given offset instead of giving it its own memory.
+		VulkanImage(ImageSpecification const& spec, DeviceApiTable const& api, VulkanTransientHeap const& heap, size_t offset) :
+			aspect(IMAGE_ASPECT_FLAGS_LOOKUP[spec.format])
+		{
+			auto image_info = fill_image_info(spec);
+			auto result		= api.vkCreateImage(api.device, &image_info, nullptr, std::out_ptr(image));
+			VT_CHECK_RESULT(result, "Failed to create placed Vulkan image.");
+			image.get_deleter().api = &api;
+
+			VkMemoryRequirements requirements;
+			api.vkGetImageMemoryRequirements(api.device, image.get(), &requirements);
+			VT_ENSURE(heap.supports(requirements), "The memory type of the transient heap is unsuitable for this image.");
+
+			result = vmaBindImageMemory2(api.allocator, heap.get_allocation(), offset, image.get(), nullptr);
+			VT_CHECK_RESULT(result, "Failed to bind Vulkan image to transient heap.");
+			initialize_image_view(spec, api);
+		}
+
+		static MemoryRequirements get_memory_requirements(ImageSpecification const& spec, DeviceApiTable const& api)
+		{
+			auto	image_info = fill_image_info(spec);
+			VkImage image;
+			auto	result = api.vkCreateImage(api.device, &image_info, nullptr, &image);
+			VT_CHECK_RESULT(result, "Failed to create Vulkan image for querying memory requirements.");
+
+			VkMemoryRequirements requirements;
+			api.vkGetImageMemoryRequirements(api.device, image, &requirements);
+			api.vkDestroyImage(api.device, image, nullptr);
+			return {requirements.size, requirements.alignment, requirements.memoryTypeBits};
+		}
+
 		VkImage get_handle() const
 		{
 			return image.get();
@@ -340,13 +374,24 @@ namespace vt::vulkan
 			return image.get_deleter().image_view;
 		}
 
+		VkImageAspectFlags get_aspect() const
+		{
+			return aspect;
+		}
+
+		// The state is tracked by command lists as they record accesses of the image.
+		ResourceState& get_state() const
+		{
+			return state;
+		}
+
 	private:
 		struct ImageDeleter
 		{
 			using pointer = VkImage;
 
 			DeviceApiTable const* api;
-			VmaAllocation		  allocation;
+			VmaAllocation		  allocation; // Null for images placed into transient heaps.
 			VkImageView			  image_view;
 
 			void operator()(VkImage image) const
@@ -357,21 +402,13 @@ namespace vt::vulkan
 		};
 		using UniqueVkImage = std::unique_ptr<VkImage, ImageDeleter>;
 
-		UniqueVkImage image;
+		UniqueVkImage		  image;
+		VkImageAspectFlags	  aspect;
+		mutable ResourceState state;
 
-		void initialize_image(ImageSpecification const& spec, VmaAllocator allocator)
+		static VkImageCreateInfo fill_image_info(ImageSpecification const& spec)
 		{
-			VmaAllocationCreateInfo const allocation_info {
-				.flags			= 0,
-				.usage			= VMA_MEMORY_USAGE_GPU_ONLY,
-				.requiredFlags	= 0,
-				.preferredFlags = 0,
-				.memoryTypeBits = 0,
-				.pool			= nullptr,
-				.pUserData		= nullptr,
-				.priority		= 0,
-			};
-			VkImageCreateInfo const image_info {
+			return {
 				.sType	   = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
 				.flags	   = derive_image_creation_flags(spec.dimension),
 				.imageType = IMAGE_DIMENSION_LOOKUP[spec.dimension],
@@ -391,6 +428,22 @@ namespace vt::vulkan
 				.pQueueFamilyIndices   = nullptr,
 				.initialLayout		   = VK_IMAGE_LAYOUT_UNDEFINED,
 			};
+		}
+
+		void initialize_image(ImageSpecification const& spec, VmaAllocator allocator)
+		{
+			auto image_info = fill_image_info(spec);
+
+			VmaAllocationCreateInfo const allocation_info {
+				.flags			= 0,
+				.usage			= VMA_MEMORY_USAGE_GPU_ONLY,
+				.requiredFlags	= 0,
+				.preferredFlags = 0,
+				.memoryTypeBits = 0,
+				.pool			= nullptr,
+				.pUserData		= nullptr,
+				.priority		= 0,
+			};
 			auto result = vmaCreateImage(allocator, &image_info, &allocation_info, std::out_ptr(image),
 										 &image.get_deleter().allocation, nullptr);
 			VT_CHECK_RESULT(result, "Failed to create Vulkan image.");
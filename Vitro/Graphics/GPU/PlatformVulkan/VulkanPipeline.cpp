@@ -17,20 +17,20 @@ import vt.Graphics.Vulkan.Sampler;
 
 namespace vt::vulkan
 {
-	constexpr inline auto VERTEX_DATA_TYPE_LOOKUP = [] {
-		LookupTable<VertexDataType, VkFormat> _;
-		using enum VertexDataType;
-
-		_[Position]			   = VK_FORMAT_R32G32B32A32_SFLOAT;
-		_[TransformedPosition] = _[Position];
-		_[TextureCoordinates]  = _[Position];
-		_[Normal]			   = _[Position];
-		_[Binormal]			   = _[Position];
-		_[Tangent]			   = _[Position];
-		_[Color]			   = _[Position];
-		_[PointSize]		   = VK_FORMAT_R32_SFLOAT;
-		_[BlendWeight]		   = VK_FORMAT_R32_SFLOAT;
-		_[BlendIndices]		   = VK_FORMAT_R32_UINT;
+	constexpr inline auto VERTEX_FORMAT_LOOKUP = [] {
+		LookupTable<VertexFormat, VkFormat> _;
+		using enum VertexFormat;
+
+		_[Float]		= VK_FORMAT_R32_SFLOAT;
+		_[Float2]		= VK_FORMAT_R32G32_SFLOAT;
+		_[Float3]		= VK_FORMAT_R32G32B32_SFLOAT;
+		_[Float4]		= VK_FORMAT_R32G32B32A32_SFLOAT;
+		_[Half2]		= VK_FORMAT_R16G16_SFLOAT;
+		_[Half4]		= VK_FORMAT_R16G16B16A16_SFLOAT;
+		_[UInt]			= VK_FORMAT_R32_UINT;
+		_[UNormRgba8]	= VK_FORMAT_R8G8B8A8_UNORM;
+		_[UNormRgb10A2] = VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+		_[SNorm16x2]	= VK_FORMAT_R16G16_SNORM;
 		return _;
 	}();
 
@@ -288,10 +288,10 @@ namespace vt::vulkan
 					vertex_attributes.emplace_back(VkVertexInputAttributeDescription {
 						.location = location++,
 						.binding  = binding,
-						.format	  = VERTEX_DATA_TYPE_LOOKUP[attribute.type],
+						.format	  = VERTEX_FORMAT_LOOKUP[get_vertex_attribute_format(attribute)],
 						.offset	  = size,
 					});
-					size += static_cast<uint32_t>(get_vertex_data_type_size(attribute.type));
+					size += static_cast<uint32_t>(get_vertex_attribute_size(attribute));
 				}
 
 				vertex_bindings.emplace_back(VkVertexInputBindingDescription {
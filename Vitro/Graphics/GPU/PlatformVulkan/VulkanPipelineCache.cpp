@@ -0,0 +1,165 @@
+module;
+#include "VitroCore/Macros.hpp"
+#include "VulkanAPI.hpp"
+
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+export module vt.Graphics.Vulkan.PipelineCache;
+
+import vt.Core.Array;
+import vt.Core.FlatHashMap;
+import vt.Graphics.Vulkan.Handle;
+import vt.Trace.Log;
+
+namespace vt::vulkan
+{
+	// Persists compiled pipelines between runs in a file per GPU and driver version. Each thread that makes pipelines gets
+	// its own cache seeded with the data loaded from disk, so that threads don't contend for the lock inside the driver's
+	// cache. The thread caches are merged whenever the cache is saved, which happens on destruction at the latest.
+	export class PipelineCache
+	{
+	public:
+		PipelineCache(DeviceApiTable const& api, VkPhysicalDeviceProperties const& properties) :
+			api(&api), path(make_path(properties)), initial_data(load(properties))
+		{}
+
+		~PipelineCache()
+		{
+			try
+			{
+				save();
+			}
+			catch(std::exception const& e)
+			{
+				Log().error("Failed to save Vulkan pipeline cache: ", e.what());
+			}
+		}
+
+		// Returns the cache to be used for making pipelines on the calling thread.
+		VkPipelineCache get_for_current_thread()
+		{
+			std::lock_guard lock(mutex);
+
+			auto thread = std::this_thread::get_id();
+			auto cache	= thread_caches.find(thread);
+			if(cache == thread_caches.end())
+				cache = thread_caches.try_emplace(thread, make_cache(initial_data)).first;
+
+			return cache->second.get();
+		}
+
+		// Merges the caches of all threads and writes the result to disk. Can be called periodically, also while other threads
+		// make pipelines.
+		void save()
+		{
+			auto merged = make_cache(initial_data);
+			{
+				std::lock_guard lock(mutex);
+				if(thread_caches.empty())
+					return;
+
+				std::vector<VkPipelineCache> sources;
+				sources.reserve(thread_caches.size());
+				for(auto& [thread, cache] : thread_caches)
+					sources.emplace_back(cache.get());
+
+				auto result = api->vkMergePipelineCaches(api->device, merged.get(), count(sources), sources.data());
+				VT_CHECK_RESULT(result, "Failed to merge Vulkan pipeline caches.");
+			}
+
+			size_t size;
+			auto   result = api->vkGetPipelineCacheData(api->device, merged.get(), &size, nullptr);
+			VT_CHECK_RESULT(result, "Failed to query Vulkan pipeline cache size.");
+
+			std::vector<char> data(size);
+			result = api->vkGetPipelineCacheData(api->device, merged.get(), &size, data.data());
+			VT_CHECK_RESULT(result, "Failed to get Vulkan pipeline cache data.");
+
+			// Writes to a temporary file first, so that a crash while writing cannot leave a truncated cache behind.
+			auto temp_path = path;
+			temp_path += ".tmp";
+			{
+				std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+				file.write(data.data(), static_cast<std::streamsize>(size));
+				VT_ENSURE(file.good(), "Failed to write Vulkan pipeline cache file.");
+			}
+			std::filesystem::rename(temp_path, path);
+		}
+
+		// Returns whether valid cache data from a previous run was found.
+		bool is_warm() const noexcept
+		{
+			return !initial_data.empty();
+		}
+
+	private:
+		DeviceApiTable const*								api;
+		std::filesystem::path								path;
+		std::vector<char>									initial_data;
+		std::mutex											mutex;
+		FlatHashMap<std::thread::id, UniqueVkPipelineCache>	thread_caches;
+
+		// The pipeline cache header contains no driver version, so the file name keys the cache by it instead.
+		static std::filesystem::path make_path(VkPhysicalDeviceProperties const& properties)
+		{
+			return "VulkanPipelineCache_" + std::to_string(properties.vendorID) + '_' + std::to_string(properties.deviceID) +
+				   '_' + std::to_string(properties.driverVersion) + ".bin";
+		}
+
+		std::vector<char> load(VkPhysicalDeviceProperties const& properties) const
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if(!file)
+			{
+				Log().info("No Vulkan pipeline cache found, pipelines will be compiled from scratch.");
+				return {};
+			}
+
+			std::vector<char> data(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(data.data(), static_cast<std::streamsize>(data.size()));
+			if(!file || !is_compatible(data, properties))
+			{
+				Log().warn("Discarding invalid or incompatible Vulkan pipeline cache.");
+				return {};
+			}
+
+			Log().info("Loaded Vulkan pipeline cache of ", data.size(), " bytes.");
+			return data;
+		}
+
+		// Drivers are supposed to reject incompatible data themselves, but not all of them do so reliably.
+		static bool is_compatible(std::vector<char> const& data, VkPhysicalDeviceProperties const& properties)
+		{
+			VkPipelineCacheHeaderVersionOne header;
+			if(data.size() < sizeof header)
+				return false;
+
+			std::memcpy(&header, data.data(), sizeof header);
+			return header.headerSize >= sizeof header && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+				   header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+				   std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+		}
+
+		UniqueVkPipelineCache make_cache(std::vector<char> const& data) const
+		{
+			VkPipelineCacheCreateInfo const cache_info {
+				.sType			 = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+				.initialDataSize = data.size(),
+				.pInitialData	 = data.data(),
+			};
+			UniqueVkPipelineCache cache;
+
+			auto result = api->vkCreatePipelineCache(api->device, &cache_info, nullptr, std::out_ptr(cache, *api));
+			VT_CHECK_RESULT(result, "Failed to create Vulkan pipeline cache.");
+			return cache;
+		}
+	};
+}
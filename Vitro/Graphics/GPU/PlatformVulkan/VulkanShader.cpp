@@ -6,6 +6,7 @@ module;
 export module vt.Graphics.Vulkan.Shader;
 
 import vt.Core.Array;
+import vt.Core.ContentHash;
 import vt.Graphics.Vulkan.Handle;
 
 namespace vt::vulkan
@@ -20,6 +21,7 @@ namespace vt::vulkan
 			Array<char> bytecode(file.tellg());
 			file.seekg(0);
 			file.read(bytecode.data(), bytecode.size());
+			content_hash = hash_content(bytecode.data(), bytecode.size());
 
 			VkShaderModuleCreateInfo const shader_info {
 				.sType	  = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
@@ -35,7 +37,13 @@ namespace vt::vulkan
 			return shader.get();
 		}
 
+		uint64_t get_content_hash() const
+		{
+			return content_hash;
+		}
+
 	private:
 		UniqueVkShaderModule shader;
+		uint64_t			 content_hash;
 	};
 }
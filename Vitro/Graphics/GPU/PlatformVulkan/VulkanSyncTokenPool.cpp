@@ -15,6 +15,41 @@ import vt.Trace.Log;
 
 namespace vt::vulkan
 {
+	// Tracks the progress of a queue with a timeline semaphore, like the fence of a D3D12 queue. Every submission signals the
+	// next value, so a sync token only consists of the semaphore and that value, and waiting for it needs no lookup.
+	export class QueueTimeline
+	{
+	public:
+		QueueTimeline(DeviceApiTable const& api)
+		{
+			VkSemaphoreTypeCreateInfoKHR const type_info {
+				.sType		   = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+				.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+				.initialValue  = 0,
+			};
+			VkSemaphoreCreateInfo const semaphore_info {
+				.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+				.pNext = &type_info,
+			};
+			auto result = api.vkCreateSemaphore(api.device, &semaphore_info, nullptr, std::out_ptr(semaphore, api));
+			VT_CHECK_RESULT(result, "Failed to create Vulkan timeline semaphore for queue.");
+		}
+
+		// Returns the token for the next submission, which must signal the semaphore with the token's value.
+		SyncToken make_next_token()
+		{
+			return {
+				nullptr,
+				semaphore.get(),
+				++last_value,
+			};
+		}
+
+	private:
+		UniqueVkSemaphore semaphore;
+		uint64_t		  last_value = 0;
+	};
+
 	// Struct combining fences and semaphores into a unified type. The reset count acts as a versioning mechanism.
 	struct UniqueSyncToken
 	{
@@ -48,6 +83,8 @@ namespace vt::vulkan
 		}
 	};
 
+	// Hands out binary semaphores paired with fences. Without timeline semaphores, every submission uses one of these. With
+	// them, they are only needed for acquiring swap chain images and presenting, which don't support timeline semaphores.
 	export class SyncTokenPool
 	{
 	public:
@@ -88,6 +125,7 @@ namespace vt::vulkan
 			auto new_token = tokens.emplace(tokens.begin() + current_index, api, 0);
 			Log().warn("The Vulkan sync token pool was grown. It is possible too much work is being submitted to the GPU.");
 
+			++new_token->resets; // Tokens with a reset count of zero are treated as default-initialized.
 			advance_index();
 			return new_token->get_unowned();
 		}
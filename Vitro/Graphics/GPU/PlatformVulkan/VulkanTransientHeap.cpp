@@ -0,0 +1,73 @@
+module;
+#include "VitroCore/Macros.hpp"
+#include "VulkanAPI.hpp"
+
+#include <memory>
+export module vt.Graphics.Vulkan.TransientHeap;
+
+import vt.Graphics.AssetResourceSpecification;
+import vt.Graphics.Vulkan.Handle;
+
+namespace vt::vulkan
+{
+	export class VulkanTransientHeap
+	{
+	public:
+		VulkanTransientHeap(TransientHeapSpecification const& spec, DeviceApiTable const& api)
+		{
+			// Vulkan has no restrictions on the kind of resources in one allocation, only on its memory type. A device-local
+			// type suitable for all resources to be placed is taken, and resources placed into it check whether it suits them.
+			VT_ENSURE(spec.memory_types != 0, "No memory type suits all resources to be placed into the transient heap.");
+			VkMemoryRequirements const requirements {
+				.size			= spec.size,
+				.alignment		= spec.alignment,
+				.memoryTypeBits = spec.memory_types,
+			};
+			VmaAllocationCreateInfo const allocation_info {
+				.flags			= 0,
+				.usage			= VMA_MEMORY_USAGE_GPU_ONLY,
+				.requiredFlags	= 0,
+				.preferredFlags = 0,
+				.memoryTypeBits = 0,
+				.pool			= nullptr,
+				.pUserData		= nullptr,
+				.priority		= 0,
+			};
+			VmaAllocationInfo info;
+
+			auto result = vmaAllocateMemory(api.allocator, &requirements, &allocation_info, std::out_ptr(allocation), &info);
+			VT_CHECK_RESULT(result, "Failed to allocate Vulkan transient heap.");
+
+			allocation.get_deleter().allocator = api.allocator;
+			memory_type						   = info.memoryType;
+		}
+
+		VmaAllocation get_allocation() const
+		{
+			return allocation.get();
+		}
+
+		// Checks whether a resource with the given memory requirements can be placed into the heap.
+		bool supports(VkMemoryRequirements const& requirements) const
+		{
+			return requirements.memoryTypeBits & 1 << memory_type;
+		}
+
+	private:
+		struct AllocationDeleter
+		{
+			using pointer = VmaAllocation;
+
+			VmaAllocator allocator;
+
+			void operator()(VmaAllocation allocation) const
+			{
+				vmaFreeMemory(allocator, allocation);
+			}
+		};
+		using UniqueVmaAllocation = std::unique_ptr<VmaAllocation, AllocationDeleter>;
+
+		UniqueVmaAllocation allocation;
+		uint32_t			memory_type;
+	};
+}
@@ -1,8 +1,12 @@
 module;
 #include "VitroCore/Macros.hpp"
+
+#include <cstdint>
 export module vt.Graphics.RenderPass;
 
+import vt.Core.ContentHash;
 import vt.Graphics.DynamicGpuApi;
+import vt.Graphics.RenderPassSpecification;
 import vt.Graphics.VT_GPU_API_MODULE.RenderPass;
 
 #if VT_DYNAMIC_GPU_API
@@ -14,6 +18,45 @@ namespace vt
 	using PlatformRenderPass = ResourceVariant<VT_GPU_API_VARIANT_ARGS(RenderPass)>;
 	export class RenderPass : public PlatformRenderPass
 	{
-		using PlatformRenderPass::PlatformRenderPass;
+	public:
+		// This constructor is for internal use only.
+		RenderPass(PlatformRenderPass&& platform_render_pass, RenderPassSpecification const& spec) :
+			PlatformRenderPass(std::move(platform_render_pass)), compatibility_hash(hash_compatibility(spec))
+		{}
+
+		// Render passes with equal compatibility hashes can use the same pipelines.
+		uint64_t get_compatibility_hash() const
+		{
+			return compatibility_hash;
+		}
+
+	private:
+		uint64_t compatibility_hash;
+
+		// Load and store operations and layouts don't affect compatibility, so only formats, sample counts and the usage of
+		// attachments by subpasses are hashed.
+		static uint64_t hash_compatibility(RenderPassSpecification const& spec)
+		{
+			ContentHasher hasher;
+			hasher.add(spec.attachments.size());
+			for(auto& attachment : spec.attachments)
+			{
+				hasher.add(attachment.format.get());
+				hasher.add(attachment.sample_count);
+			}
+
+			auto add_indices = [&](Subpass::AttachmentIndexList const& indices) {
+				hasher.add(indices.size());
+				hasher.add_bytes(indices.data(), indices.size());
+			};
+			hasher.add(spec.subpasses.size());
+			for(auto& subpass : spec.subpasses)
+			{
+				add_indices(subpass.input_attachments);
+				add_indices(subpass.output_attachments);
+				add_indices(subpass.preserve_attachments);
+			}
+			return hasher.get();
+		}
 	};
 }
@@ -1,7 +1,11 @@
 module;
 #include "VitroCore/Macros.hpp"
+
+#include <cstdint>
+#include <utility>
 export module vt.Graphics.RootSignature;
 
+import vt.Core.ContentHash;
 import vt.Graphics.DescriptorSetLayout;
 import vt.Graphics.DynamicGpuApi;
 import vt.Graphics.VT_GPU_API_MODULE.RootSignature;
@@ -15,6 +19,31 @@ namespace vt
 	using PlatformRootSignature = ResourceVariant<VT_GPU_API_VARIANT_ARGS(RootSignature)>;
 	export class RootSignature : public PlatformRootSignature
 	{
-		using PlatformRootSignature::PlatformRootSignature;
+	public:
+		// This constructor is for internal use only.
+		RootSignature(PlatformRootSignature&& platform_root_signature, RootSignatureSpecification const& spec) :
+			PlatformRootSignature(std::move(platform_root_signature)), layout_hash(hash_layout(spec))
+		{}
+
+		// Root signatures with equal layout hashes are defined identically, which lets them use the same pipelines, even if
+		// they were made by different renderers.
+		uint64_t get_layout_hash() const
+		{
+			return layout_hash;
+		}
+
+	private:
+		uint64_t layout_hash;
+
+		static uint64_t hash_layout(RootSignatureSpecification const& spec)
+		{
+			ContentHasher hasher;
+			hasher.add(spec.push_constants_byte_size.get());
+			hasher.add(spec.push_constants_visibility.get());
+			hasher.add(spec.layouts.size());
+			for(auto& layout : spec.layouts)
+				hasher.add(layout.get_content_hash());
+			return hasher.get();
+		}
 	};
 }
@@ -1,5 +1,7 @@
 module;
 #include "VitroCore/Macros.hpp"
+
+#include <cstdint>
 export module vt.Graphics.Shader;
 
 import vt.Graphics.DynamicGpuApi;
@@ -14,6 +16,19 @@ namespace vt
 	using PlatformShader = ResourceVariant<VT_GPU_API_VARIANT_ARGS(Shader)>;
 	export class Shader : public PlatformShader
 	{
-		using PlatformShader::PlatformShader;
+	public:
+		// This constructor is for internal use only.
+		Shader(PlatformShader&& platform_shader, uint64_t content_hash) :
+			PlatformShader(std::move(platform_shader)), content_hash(content_hash)
+		{}
+
+		// Shaders loaded from identical bytecode have equal content hashes, regardless of where they were loaded from.
+		uint64_t get_content_hash() const
+		{
+			return content_hash;
+		}
+
+	private:
+		uint64_t content_hash;
 	};
 }
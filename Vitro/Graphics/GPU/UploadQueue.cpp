@@ -0,0 +1,245 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <numeric>
+#include <optional>
+#include <vector>
+export module vt.Graphics.UploadQueue;
+
+import vt.Graphics.AbstractCommandList;
+import vt.Graphics.AbstractDevice;
+import vt.Graphics.AssetResource;
+import vt.Graphics.AssetResourceSpecification;
+import vt.Graphics.CommandList;
+import vt.Graphics.Handle;
+
+namespace vt
+{
+	// Copies data from the CPU into buffers and images through a persistently mapped staging buffer that is used as a ring.
+	// Uploads are recorded into one copy command list until they are submitted together, which render graphs do once per
+	// frame when they execute. The CPU only waits for the GPU when the ring has no room left for an upload. Not thread-safe.
+	export class UploadQueue
+	{
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = 32 * 1024 * 1024;
+
+		UploadQueue(AbstractDevice& device, size_t capacity = DEFAULT_CAPACITY) :
+			device(device), staging(make_staging_buffer(device, capacity)), capacity(capacity)
+		{
+			mapped = static_cast<char*>(device.map(staging));
+		}
+
+		~UploadQueue()
+		{
+			for(auto& submission : in_flight)
+				device.wait_for_workload(submission.token);
+
+			device.unmap(staging);
+		}
+
+		// Copies the data into the buffer at the given offset. Afterwards, the buffer is prepared for the given access on the
+		// queue of the given command type, which must require the same access before its next use of the buffer, and wait for
+		// the submission of the upload. Until then, the buffer must not be moved or be in use by the GPU.
+		void upload_buffer(Buffer&		dst,
+						   size_t		dst_offset,
+						   void const*	data,
+						   size_t		size,
+						   BufferAccess next_access,
+						   CommandType	next_queue)
+		{
+			size_t const offset = allocate(size, BUFFER_UPLOAD_ALIGNMENT);
+			std::memcpy(mapped + offset, data, size);
+
+			get_recording_list()->copy_buffer_region(staging, dst, offset, dst_offset, size);
+			add_release(buffer_releases, dst, next_access, next_queue);
+		}
+
+		// Copies tightly packed texel data into one mip of a 2D image or of an element of a 2D texture array, with the same
+		// rules as for buffers.
+		void upload_image(Image&	  dst,
+						  void const* data,
+						  ImageLayout next_layout,
+						  CommandType next_queue,
+						  unsigned	  mip		  = 0,
+						  unsigned	  array_index = 0)
+		{
+			// Rows of block-compressed formats are rows of blocks.
+			auto const	   format	  = dst.get_format();
+			unsigned const extent	  = get_texel_block_extent(format);
+			size_t const   block_size = get_bits_per_texel(format) * extent * extent / 8;
+			size_t const   row_size	  = (std::max(dst.get_width() >> mip, 1) + extent - 1) / extent * block_size;
+			size_t const   row_count  = (std::max(dst.get_height() >> mip, 1) + extent - 1) / extent;
+			size_t const   row_pitch  = align_up(row_size, std::lcm(BUFFER_IMAGE_ROW_PITCH_ALIGNMENT, block_size));
+			size_t const   offset	  = allocate(row_pitch * row_count, std::lcm(BUFFER_IMAGE_OFFSET_ALIGNMENT, block_size));
+
+			auto src = static_cast<char const*>(data);
+			for(size_t row = 0; row != row_count; ++row)
+				std::memcpy(mapped + offset + row * row_pitch, src + row * row_size, row_size);
+
+			BufferImageCopyRegion const region {
+				.src_offset		 = offset,
+				.row_pitch		 = row_pitch,
+				.dst_mip		 = mip,
+				.dst_array_index = array_index,
+			};
+			get_recording_list()->copy_buffer_region_to_image(staging, dst, region);
+			add_release(image_releases, dst, next_layout, next_queue);
+		}
+
+		// Submits all uploads since the last submission in one command list. Every submission using the uploaded resources
+		// must wait for the returned token. If nothing was uploaded since, nothing is submitted and no token is returned.
+		std::optional<SyncToken> submit()
+		{
+			if(!recording)
+				return std::nullopt;
+
+			auto& cmd = *recording;
+			for(auto& release : buffer_releases)
+				release_resource(cmd, release);
+			for(auto& release : image_releases)
+				release_resource(cmd, release);
+			cmd->end();
+
+			auto token = device.submit_copy_commands(cmd->get_handle());
+			in_flight.emplace_back(std::move(cmd), token, head);
+			recording.reset();
+			buffer_releases.clear();
+			image_releases.clear();
+			return token;
+		}
+
+	private:
+		// Keeps the data of each upload aligned for any type it might contain.
+		static constexpr size_t BUFFER_UPLOAD_ALIGNMENT = 16;
+
+		struct Submission
+		{
+			CopyCommandList cmd;
+			SyncToken		token;
+			size_t			end; // Position in the ring up to which the uploads of the submission reach.
+		};
+
+		// Queue ownership is only released once per submission, after all copies into the resource.
+		template<typename T, typename State> struct Release
+		{
+			T*			resource;
+			State		state;
+			CommandType next_queue;
+		};
+
+		AbstractDevice&							   device;
+		Buffer									   staging;
+		char*									   mapped;
+		size_t									   capacity;
+		size_t									   head = 0; // Position after the last upload, wrapping at the capacity.
+		size_t									   tail = 0; // Position up to which all uploads are done.
+		std::optional<CopyCommandList>			   recording;
+		std::deque<Submission>					   in_flight;
+		std::vector<CopyCommandList>			   idle_lists;
+		std::vector<Release<Buffer, BufferAccess>> buffer_releases;
+		std::vector<Release<Image, ImageLayout>>   image_releases;
+
+		static Buffer make_staging_buffer(AbstractDevice& device, size_t capacity)
+		{
+			BufferSpecification const spec {
+				.size	= capacity,
+				.stride = 1,
+				.usage	= BufferUsage::CopySrc | BufferUsage::Upload,
+			};
+			return device.make_buffer(spec);
+		}
+
+		static size_t align_up(size_t value, size_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		// Returns the offset of a range in the ring that no uploads in flight overlap, waiting for them if necessary.
+		size_t allocate(size_t size, size_t alignment)
+		{
+			VT_ENSURE(size <= capacity, "Upload is larger than the staging ring of the upload queue.");
+
+			retire_done_submissions();
+			while(true)
+			{
+				if(in_flight.empty() && !recording)
+					head = tail = 0; // Nothing uses the ring, so uploads can start over at its beginning.
+
+				size_t const offset	 = head % capacity;
+				size_t		 aligned = align_up(offset, alignment);
+				if(aligned + size > capacity)
+					aligned = capacity; // Uploads can't wrap around, so the rest of the ring is skipped.
+
+				size_t const begin = head - offset + aligned;
+				if(begin + size - tail <= capacity)
+				{
+					head = begin + size;
+					return begin % capacity;
+				}
+
+				// The ring is full. If only uploads that aren't submitted yet take it up, they have to be submitted first.
+				if(in_flight.empty())
+					(void)submit();
+
+				device.wait_for_workload(in_flight.front().token);
+				retire_oldest_submission();
+			}
+		}
+
+		void retire_done_submissions()
+		{
+			while(!in_flight.empty() && device.is_workload_done(in_flight.front().token))
+				retire_oldest_submission();
+		}
+
+		void retire_oldest_submission()
+		{
+			auto& oldest = in_flight.front();
+			tail		 = oldest.end;
+			idle_lists.emplace_back(std::move(oldest.cmd));
+			in_flight.pop_front();
+		}
+
+		CopyCommandList& get_recording_list()
+		{
+			if(recording)
+				return *recording;
+
+			if(idle_lists.empty())
+				recording.emplace(device.make_copy_command_list());
+			else
+			{
+				recording.emplace(std::move(idle_lists.back()));
+				idle_lists.pop_back();
+			}
+			auto& cmd = *recording;
+			cmd->reset();
+			cmd->begin();
+			return cmd;
+		}
+
+		template<typename T, typename State>
+		static void add_release(std::vector<Release<T, State>>& releases, T& resource, State state, CommandType next_queue)
+		{
+			auto release = std::find_if(releases.begin(), releases.end(), [&](Release<T, State> const& existing) {
+				return existing.resource == &resource;
+			});
+			if(release == releases.end())
+				releases.emplace_back(&resource, state, next_queue);
+			else
+				*release = {&resource, state, next_queue};
+		}
+
+		template<typename T, typename State>
+		static void release_resource(CopyCommandList& cmd, Release<T, State> const& release)
+		{
+			if(release.next_queue == CommandType::Copy)
+				cmd->require(*release.resource, release.state);
+			else
+				cmd->transition(*release.resource, release.state, release.next_queue);
+		}
+	};
+}
@@ -3,9 +3,10 @@ module;
 
 #include <algorithm>
 #include <atomic>
-#include <mutex>
+#include <cstdint>
+#include <limits>
 #include <string>
-#include <unordered_map>
+#include <thread>
 export module vt.Graphics.GraphicsSystem;
 
 import vt.App.AppContextBase;
@@ -13,10 +14,15 @@ import vt.App.EventListener;
 import vt.App.ObjectEvent;
 import vt.App.Window;
 import vt.App.WindowEvent;
+import vt.Core.FlatHashMap;
+import vt.Core.Rect;
+import vt.Core.SmallList;
+import vt.Core.SpscQueue;
 import vt.Core.Tick;
 import vt.Core.Version;
 import vt.Graphics.Device;
 import vt.Graphics.Driver;
+import vt.Graphics.DynamicBufferAllocator;
 import vt.Graphics.DynamicGpuApi;
 import vt.Graphics.Handle;
 import vt.Graphics.WindowContext;
@@ -30,9 +36,11 @@ namespace vt
 
 	public:
 		GraphicsSystem(bool				  enable_driver_debug_layer,
+					   bool				  render_stress_scene,
 					   std::string const& app_name,
 					   Version			  app_version,
 					   Version			  engine_version) :
+			render_stress_scene(render_stress_scene),
 			driver(enable_driver_debug_layer, app_name, app_version, engine_version),
 			device(driver->make_device(select_adapter())),
 			render_thread(&GraphicsSystem::run_rendering, this)
@@ -43,6 +51,8 @@ namespace vt
 
 			if(enable_driver_debug_layer)
 				Log().info("GPU driver debug layers enabled.");
+			if(render_stress_scene)
+				Log().info("Rendering the stress scene.");
 		}
 
 		~GraphicsSystem()
@@ -51,13 +61,35 @@ namespace vt
 		}
 
 	private:
-		std::unordered_map<Window*, WindowContext> window_contexts; // Iterator stability is needed, hence unordered_map.
-
+		// Changes to the set of window contexts requested by the event thread and applied by the render thread between frames.
+		struct WindowContextCommand
+		{
+			enum class Type : uint8_t
+			{
+				Create,
+				Move,
+				Destroy,
+				Resize,
+			};
+			Type	type;
+			Window* window;
+			Window* new_window = nullptr; // Only used by moves.
+			Extent	size	   = {};	  // Only used by resizes.
+		};
+		static constexpr size_t MAX_PENDING_WINDOW_CONTEXT_COMMANDS = 64;
+
+		StableFlatHashMap<Window*, WindowContext> window_contexts; // Reference stability is needed, hence the stable variant.
+
+		// Only the event thread submits commands, so it alone keeps count of them.
+		SpscQueue<WindowContextCommand, MAX_PENDING_WINDOW_CONTEXT_COMMANDS> window_context_commands;
+		uint64_t															 submitted_commands = 0;
+		std::atomic<uint64_t>												 applied_commands	= 0;
+
+		bool			 render_stress_scene;
 		DynamicGpuApi	 dynamic_gpu_api;
 		Driver			 driver;
 		Device			 device;
 		std::atomic_bool should_run = true;
-		std::mutex		 context_access_mutex;
 		std::jthread	 render_thread;
 		Tick			 tick;
 
@@ -73,66 +105,123 @@ namespace vt
 
 		void run_rendering()
 		{
-			uint64_t previous_time = Tick::measure_time();
+			uint64_t			 previous_time = Tick::measure_time();
+			SmallList<SyncToken> frame_tokens;
 			while(should_run)
 			{
 				tick.update(previous_time);
+				apply_window_context_commands();
 
-				std::lock_guard lock(context_access_mutex);
+				frame_tokens.clear();
 				for(auto& [window, context] : window_contexts)
-					context.execute_frame(tick, *window, device);
+					frame_tokens.emplace_back(context.execute_frame(tick, *window, device));
+
+				// Every window context renders with the dynamic buffers of the same frame.
+				device.get_dynamic_buffer_allocator().move_to_next_frame(frame_tokens);
 			}
+
+			// Nothing will be applied anymore, so the event thread must not wait for it.
+			applied_commands = std::numeric_limits<uint64_t>::max();
+			applied_commands.notify_all();
 		}
 
-		void on_window_resize(WindowSizeEvent& window_size_event)
+		void apply_window_context_commands()
 		{
-			auto& [window, context] = *window_contexts.find(&window_size_event.window);
-
-			// We're disabling resize here from the event thread, but we'll re-enable it on the other thread after handling the
-			// resize.
-			window->disable_resize();
-			context.invalidate_swap_chain(window_size_event);
+			size_t applied = window_context_commands.consume_all([&](WindowContextCommand const& command) {
+				switch(command.type)
+				{
+					case WindowContextCommand::Type::Create:
+						window_contexts.try_emplace(command.window, *command.window, device, render_stress_scene);
+						break;
+					case WindowContextCommand::Type::Move:
+						window_contexts.replace_key(command.window, command.new_window);
+						break;
+					case WindowContextCommand::Type::Destroy:
+						// Flush entire device because context destroys renderer, which might use multiple queues.
+						device->flush();
+						window_contexts.erase(command.window);
+						break;
+					case WindowContextCommand::Type::Resize:
+					{
+						auto context = window_contexts.find(command.window);
+						if(context != window_contexts.end())
+							context->second.invalidate_swap_chain(command.size);
+					}
+				}
+			});
+			if(applied != 0)
+			{
+				applied_commands.fetch_add(applied, std::memory_order_release);
+				applied_commands.notify_all();
+			}
 		}
 
-		void on_window_object_construct(ObjectConstructEvent<Window>& window_constructed)
+		void submit_window_context_command(WindowContextCommand const& command)
 		{
-			std::lock_guard lock(context_access_mutex);
-
-			auto& window = window_constructed.object;
-			window_contexts.try_emplace(&window, window, device);
+			window_context_commands.emplace(command);
+			++submitted_commands;
 		}
 
-		void on_window_object_move_construct(ObjectMoveConstructEvent<Window>& window_moved)
+		// Blocks the event thread until the render thread no longer refers to windows that are about to be moved from or
+		// destroyed. Rendering itself is never blocked by the event thread.
+		void wait_for_window_context_commands()
 		{
-			std::lock_guard lock(context_access_mutex);
-			replace_key_for_window_context(window_moved.moved, window_moved.constructed);
+			uint64_t applied;
+			while((applied = applied_commands.load(std::memory_order_acquire)) < submitted_commands)
+				applied_commands.wait(applied);
 		}
 
-		void on_window_object_destroy(ObjectDestroyEvent<Window>& window_destroyed)
+		void on_window_resize(WindowSizeEvent& window_size_event)
 		{
-			std::lock_guard lock(context_access_mutex);
-			destroy_window_context(window_destroyed.object);
+			// We're disabling resize here from the event thread, but we'll re-enable it on the other thread after handling the
+			// resize.
+			window_size_event.window.disable_resize();
+			submit_window_context_command({
+				.type	= WindowContextCommand::Type::Resize,
+				.window = &window_size_event.window,
+				.size	= window_size_event.size,
+			});
 		}
 
-		void on_window_object_move_assign(ObjectMoveAssignEvent<Window>& window_moved)
+		void on_window_object_construct(ObjectConstructEvent<Window>& window_constructed)
 		{
-			std::lock_guard lock(context_access_mutex);
+			submit_window_context_command({
+				.type	= WindowContextCommand::Type::Create,
+				.window = &window_constructed.object,
+			});
+		}
 
-			destroy_window_context(window_moved.left);
-			replace_key_for_window_context(window_moved.right, window_moved.left);
+		void on_window_object_move_construct(ObjectMoveConstructEvent<Window>& window_moved)
+		{
+			submit_window_context_command({
+				.type		= WindowContextCommand::Type::Move,
+				.window		= &window_moved.moved,
+				.new_window = &window_moved.constructed,
+			});
+			wait_for_window_context_commands();
 		}
 
-		void destroy_window_context(Window& window)
+		void on_window_object_destroy(ObjectDestroyEvent<Window>& window_destroyed)
 		{
-			device->flush(); // Flush entire device because context destroys renderer, which might use multiple queues.
-			window_contexts.erase(&window);
+			submit_window_context_command({
+				.type	= WindowContextCommand::Type::Destroy,
+				.window = &window_destroyed.object,
+			});
+			wait_for_window_context_commands();
 		}
 
-		void replace_key_for_window_context(Window& old_window, Window& new_window)
+		void on_window_object_move_assign(ObjectMoveAssignEvent<Window>& window_moved)
 		{
-			auto node  = window_contexts.extract(&old_window);
-			node.key() = &new_window;
-			window_contexts.insert(std::move(node));
+			submit_window_context_command({
+				.type	= WindowContextCommand::Type::Destroy,
+				.window = &window_moved.left,
+			});
+			submit_window_context_command({
+				.type		= WindowContextCommand::Type::Move,
+				.window		= &window_moved.right,
+				.new_window = &window_moved.left,
+			});
+			wait_for_window_context_commands();
 		}
 	};
 }
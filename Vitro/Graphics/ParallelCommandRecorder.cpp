@@ -0,0 +1,85 @@
+module;
+#include <algorithm>
+#include <vector>
+export module vt.Graphics.ParallelCommandRecorder;
+
+import vt.Core.JobSystem;
+import vt.Core.SmallList;
+import vt.Graphics.AbstractCommandList;
+import vt.Graphics.CommandList;
+import vt.Graphics.Device;
+import vt.Graphics.Handle;
+import vt.Graphics.RenderPass;
+import vt.Graphics.RenderTarget;
+
+namespace vt
+{
+	// Records the commands of one subpass on multiple threads. Owns one secondary command list per thread, each with its own
+	// command allocator, so recording needs no synchronization. Like any command list, one instance is needed per frame in
+	// flight, since recording resets the lists.
+	export class ParallelCommandRecorder
+	{
+	public:
+		ParallelCommandRecorder(Device& device)
+		{
+			unsigned const thread_count = JobSystem::get_worker_count() + 1;
+
+			secondary_lists.reserve(thread_count);
+			for(unsigned i = 0; i != thread_count; ++i)
+				secondary_lists.emplace_back(device->make_secondary_render_command_list());
+		}
+
+		// Splits the items into contiguous ranges and calls the record function with a begun secondary command list and the
+		// bounds of a range. The secondary command lists are executed by the primary command list in the order of their ranges,
+		// which gives the same result as recording all items in order. The primary command list must have begun the subpass
+		// with secondary contents. At most the given number of threads record, which allows measuring how recording scales.
+		template<typename F>
+		void record(AbstractRenderCommandList& primary,
+					RenderPass const&		   render_pass,
+					unsigned				   subpass_index,
+					RenderTarget const&		   render_target,
+					size_t					   item_count,
+					unsigned				   thread_count,
+					F const&				   record_items)
+		{
+			if(item_count == 0)
+				return;
+
+			size_t const useful_lists = (item_count + MIN_ITEMS_PER_LIST - 1) / MIN_ITEMS_PER_LIST;
+			size_t const list_count	  = std::min({secondary_lists.size(), useful_lists, std::max<size_t>(thread_count, 1)});
+
+			JobSystem::parallel_for(
+				0, list_count,
+				[&](size_t index) {
+					size_t const begin = index * item_count / list_count;
+					size_t const end   = (index + 1) * item_count / list_count;
+
+					auto& list = secondary_lists[index];
+					list->reset();
+					list->begin_secondary(render_pass, subpass_index, render_target);
+					record_items(list, begin, end);
+					list->end();
+				},
+				1);
+
+			SmallList<CommandListHandle> handles;
+			handles.reserve(list_count);
+			for(size_t i = 0; i != list_count; ++i)
+				handles.emplace_back(secondary_lists[i]->get_handle());
+
+			primary.execute_secondary_commands(handles);
+		}
+
+		// The most threads that can record at once, which is one per worker plus the calling thread.
+		unsigned get_max_thread_count() const noexcept
+		{
+			return static_cast<unsigned>(secondary_lists.size());
+		}
+
+	private:
+		// Below this, recording another command list costs more than the parallelism gains.
+		static constexpr size_t MIN_ITEMS_PER_LIST = 256;
+
+		std::vector<RenderCommandList> secondary_lists;
+	};
+}
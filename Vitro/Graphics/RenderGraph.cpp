@@ -0,0 +1,971 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+export module vt.Graphics.RenderGraph;
+
+import vt.Core.Enum;
+import vt.Core.SmallList;
+import vt.Core.Tick;
+import vt.Graphics.AbstractCommandList;
+import vt.Graphics.AssetResource;
+import vt.Graphics.AssetResourceSpecification;
+import vt.Graphics.CommandList;
+import vt.Graphics.Device;
+import vt.Graphics.Handle;
+import vt.Graphics.RingBuffer;
+
+namespace vt
+{
+	// Refers to an image declared in a render graph. Only valid until the graph is executed.
+	export struct GraphImage
+	{
+		unsigned index = UINT_MAX;
+	};
+
+	// Refers to a buffer declared in a render graph. Only valid until the graph is executed.
+	export struct GraphBuffer
+	{
+		unsigned index = UINT_MAX;
+	};
+
+	// The command lists that finish a frame and are submitted along with the presentation of the swap chain image, and the
+	// workloads on other queues that they have to wait for.
+	export struct FrameSubmission
+	{
+		SmallList<CommandListHandle> cmds;
+		SmallList<SyncToken>		 gpu_wait_tokens;
+	};
+
+	export struct RenderGraphPassStats
+	{
+		std::string name;
+		CommandType queue;
+		Tick		record_time; // Time spent in the callback that records the pass.
+	};
+
+	// Describes the last frame executed by a render graph. Resource sizes are estimated from their specifications, so they
+	// leave out padding and alignment that the driver may add.
+	export struct RenderGraphStats
+	{
+		std::vector<RenderGraphPassStats> passes; // In execution order.
+		unsigned						  culled_pass_count = 0;
+		unsigned						  submission_count	= 0;
+		unsigned						  barrier_count		= 0;
+		size_t							  transient_bytes	= 0; // Memory all transient resources would need on their own.
+		size_t							  allocated_bytes	= 0; // Memory of the objects the transient resources share.
+
+		size_t get_bytes_saved_by_aliasing() const
+		{
+			return transient_bytes - allocated_bytes;
+		}
+	};
+
+	// Builds the work of a frame from passes that declare which virtual resources they read and write. On execution, passes
+	// whose results are never used are culled, and the rest are ordered so that consecutive passes on the same queue can be
+	// recorded into one command list. Barriers and queue ownership transfers follow from the declared accesses, and command
+	// lists on different queues wait for each other with sync tokens. Transient resources whose lifetimes don't overlap share
+	// one object with the same specification, or if they have a transient usage, memory in a transient heap. The graph must
+	// be executed exactly once per frame, because it cycles through its command lists and transient resources like other
+	// per-frame resources.
+	export class RenderGraph
+	{
+		static constexpr unsigned NONE = UINT_MAX;
+
+		struct Access
+		{
+			BufferAccess buffer_access = {};
+			ImageLayout	 layout		   = ImageLayout::Undefined;
+			ImageLayout	 final_layout  = ImageLayout::Undefined;
+			bool		 is_attachment = false;
+			bool		 is_write	   = false;
+			unsigned	 resource	   = NONE;
+		};
+
+	public:
+		// Declares the resource accesses of a pass. Accesses must be declared in the order in which the pass records them.
+		class PassBuilder
+		{
+		public:
+			void read(GraphBuffer buffer, BufferAccess access)
+			{
+				add_access(buffer.index, false, {.buffer_access = access});
+			}
+
+			void write(GraphBuffer buffer, BufferAccess access)
+			{
+				add_access(buffer.index, true, {.buffer_access = access});
+			}
+
+			void read(GraphImage image, ImageLayout layout)
+			{
+				add_access(image.index, false, {.layout = layout, .final_layout = layout});
+			}
+
+			void write(GraphImage image, ImageLayout layout)
+			{
+				add_access(image.index, true, {.layout = layout, .final_layout = layout});
+			}
+
+			// Declares that a render pass uses the image as an attachment in the given layout and leaves it in the final
+			// layout. The initial layout of the attachment in the render pass must be either the given layout or undefined.
+			void attach(GraphImage image, ImageLayout layout, ImageLayout final_layout)
+			{
+				VT_ASSERT(graph.passes[pass_index].queue == CommandType::Render, "Only render passes can use attachments.");
+				add_access(image.index, true, {.layout = layout, .final_layout = final_layout, .is_attachment = true});
+			}
+
+			// Keeps the pass from being culled, which is needed if it has effects outside of the graph, such as rendering to
+			// a swap chain image.
+			void mark_side_effects()
+			{
+				graph.passes[pass_index].has_side_effects = true;
+			}
+
+		private:
+			friend RenderGraph;
+
+			RenderGraph& graph;
+			unsigned	 pass_index;
+
+			PassBuilder(RenderGraph& graph, unsigned pass_index) : graph(graph), pass_index(pass_index)
+			{}
+
+			void add_access(unsigned resource, bool is_write, Access access)
+			{
+				VT_ASSERT(resource < graph.resources.size(), "Invalid render graph resource.");
+
+				access.resource = resource;
+				access.is_write = is_write;
+				graph.passes[pass_index].accesses.emplace_back(access);
+				graph.track_dependency(pass_index, resource, is_write);
+			}
+		};
+
+		// Gives the callbacks that record passes the objects that back virtual resources.
+		class Resources
+		{
+		public:
+			Image& get(GraphImage image) const
+			{
+				return *graph.resources[image.index].image;
+			}
+
+			Buffer& get(GraphBuffer buffer) const
+			{
+				return *graph.resources[buffer.index].buffer;
+			}
+
+		private:
+			friend RenderGraph;
+
+			RenderGraph const& graph;
+
+			Resources(RenderGraph const& graph) : graph(graph)
+			{}
+		};
+
+		RenderGraph(Device& device) : device(device)
+		{}
+
+		// Declares an image that only lives within the current frame and is made by the graph.
+		GraphImage create_image(std::string name, ImageSpecification const& spec)
+		{
+			auto& resource		= resources.emplace_back(std::move(name));
+			resource.image_spec = spec;
+			return {count_resources() - 1};
+		}
+
+		// Declares a buffer that only lives within the current frame and is made by the graph.
+		GraphBuffer create_buffer(std::string name, BufferSpecification const& spec)
+		{
+			auto& resource		 = resources.emplace_back(std::move(name));
+			resource.buffer_spec = spec;
+			return {count_resources() - 1};
+		}
+
+		// Declares an image that outlives the frame. Passes writing to it are never culled. Its state carries over between
+		// frames, so other command lists using it must declare their accesses too. After its last use in the frame it is
+		// handed back to the queue of its first use, where command lists outside the graph and later frames can acquire it.
+		GraphImage import_image(std::string name, Image& image)
+		{
+			auto& resource = resources.emplace_back(std::move(name));
+			resource.image = &image;
+			return {count_resources() - 1};
+		}
+
+		// Declares a buffer that outlives the frame, with the same rules as imported images.
+		GraphBuffer import_buffer(std::string name, Buffer& buffer)
+		{
+			auto& resource	= resources.emplace_back(std::move(name));
+			resource.buffer = &buffer;
+			return {count_resources() - 1};
+		}
+
+		// Adds a pass executed on the queue of the given command type. The setup function is called immediately with a
+		// builder to declare accesses. The record function is called during execution if the pass is not culled.
+		template<CommandType TYPE>
+		void add_pass(std::string											 name,
+					  std::invocable<PassBuilder&> auto&&					 setup,
+					  std::invocable<AbstractCommandList<TYPE>&, Resources const&> auto&& record)
+		{
+			passes.emplace_back(PassNode {
+				.name  = std::move(name),
+				.queue = TYPE,
+				.record =
+					[record](AbstractCopyCommandList& cmd, Resources const& resources) {
+						record(static_cast<AbstractCommandList<TYPE>&>(cmd), resources);
+					},
+			});
+			PassBuilder builder(*this, count_passes() - 1);
+			setup(builder);
+		}
+
+		// Culls, schedules and records all passes, then submits everything except for the command lists that finish the
+		// frame, which are returned for submission with the presentation. Clears all passes and resources declared so far.
+		FrameSubmission execute()
+		{
+			auto& frame = frames.current();
+
+			stats = {};
+			cull_passes();
+			schedule_passes();
+			bind_resources(frame);
+			auto batches	= form_batches();
+			auto submission = record_and_submit(frame, batches);
+
+			std::erase_if(frame.images, [](PooledImage const& pooled) { return !pooled.is_bound(); });
+			std::erase_if(frame.buffers, [](PooledBuffer const& pooled) { return !pooled.is_bound(); });
+			for(auto& pooled : frame.images)
+				if(!pooled.offset)
+					stats.allocated_bytes += estimate_size(pooled.spec);
+			for(auto& pooled : frame.buffers)
+				if(!pooled.offset)
+					stats.allocated_bytes += pooled.spec.size;
+			for(auto& heap : frame.heaps)
+				if(heap)
+					stats.allocated_bytes += heap->get_size();
+
+			passes.clear();
+			resources.clear();
+			order.clear();
+			memory_handoffs.clear();
+			frames.move_to_next_frame();
+			return submission;
+		}
+
+		RenderGraphStats const& get_stats() const
+		{
+			return stats;
+		}
+
+	private:
+		using RecordFunction = std::function<void(AbstractCopyCommandList&, Resources const&)>;
+
+		struct PassNode
+		{
+			std::string			name;
+			CommandType			queue;
+			RecordFunction		record;
+			SmallList<Access>	accesses;
+			SmallList<unsigned> dependencies;
+			bool				has_side_effects = false;
+			bool				is_live			 = false;
+			unsigned			position		 = NONE; // Index in the execution order.
+			unsigned			batch			 = NONE;
+		};
+
+		// Refers to an access of a resource in execution order.
+		struct Use
+		{
+			unsigned	  position;
+			Access const* access;
+		};
+
+		struct ResourceNode
+		{
+			std::string						   name;
+			std::optional<ImageSpecification>  image_spec;
+			std::optional<BufferSpecification> buffer_spec;
+			Image*							   image	   = nullptr;
+			Buffer*							   buffer	   = nullptr;
+			unsigned						   last_writer = NONE;
+			SmallList<unsigned>				   readers_since_write;
+			SmallList<Use>					   uses;
+			std::optional<size_t>			   offset; // Set if the resource is placed into a transient heap.
+
+			ResourceNode(std::string name) : name(std::move(name))
+			{}
+
+			bool is_transient() const
+			{
+				return image_spec || buffer_spec;
+			}
+
+			bool has_transient_usage() const
+			{
+				if(image_spec)
+					return image_spec->usage.get() & ImageUsage::Transient;
+				else
+					return buffer_spec && buffer_spec->usage.get() & BufferUsage::Transient;
+			}
+
+			TransientHeapContents get_heap_contents() const
+			{
+				if(image_spec)
+					return get_transient_heap_contents(image_spec->usage);
+				else
+					return TransientHeapContents::Buffers;
+			}
+		};
+
+		// A transient object along with everything accessing it in the current frame, in execution order. At the end of a
+		// frame it is handed back to the queue that used it first, so that the same queue can acquire it in a later frame.
+		template<typename T, typename Spec> struct Pooled
+		{
+			T					  object;
+			Spec				  spec;
+			CommandType			  home_queue;
+			std::optional<size_t> offset;			// Set if the object is placed into the transient heap of the frame.
+			unsigned			  free_from = NONE; // First position after the last use by a resource bound in this frame.
+			SmallList<Use>		  uses;
+
+			bool is_bound() const
+			{
+				return free_from != NONE;
+			}
+		};
+		using PooledImage  = Pooled<Image, ImageSpecification>;
+		using PooledBuffer = Pooled<Buffer, BufferSpecification>;
+
+		// Heaps are declared first so that they outlive the objects placed into them.
+		struct FrameResources
+		{
+			std::optional<TransientHeap>	heaps[size_from_enum_max<TransientHeapContents>()];
+			std::vector<CopyCommandList>	copy_lists;
+			std::vector<ComputeCommandList> compute_lists;
+			std::vector<RenderCommandList>	render_lists;
+			std::vector<PooledImage>		images;
+			std::vector<PooledBuffer>		buffers;
+		};
+
+		// A range of a transient heap that a resource occupies during its lifetime.
+		struct Placement
+		{
+			unsigned resource;
+			size_t	 offset;
+			size_t	 size;
+			unsigned first; // Position of the first use.
+			unsigned last;	// Position of the last use.
+		};
+
+		// Memory requirements depend only on the specification, so they are remembered to save querying them every frame.
+		template<typename Spec> struct CachedRequirements
+		{
+			Spec			   spec;
+			MemoryRequirements requirements;
+		};
+
+		struct Batch
+		{
+			CommandType			queue;
+			SmallList<unsigned> positions;
+			SmallList<unsigned> waits; // Earlier batches on other queues.
+		};
+
+		Device&												 device;
+		std::vector<PassNode>								 passes;
+		std::vector<ResourceNode>							 resources;
+		std::vector<unsigned>								 order;			  // Indices of live passes in execution order.
+		std::vector<std::pair<unsigned, unsigned>>			 memory_handoffs; // Positions of the last and next use of memory.
+		RingBuffer<FrameResources>							 frames;
+		RenderGraphStats									 stats;
+		std::vector<CachedRequirements<ImageSpecification>>	 image_requirements;
+		std::vector<CachedRequirements<BufferSpecification>> buffer_requirements;
+
+		unsigned count_passes() const
+		{
+			return static_cast<unsigned>(passes.size());
+		}
+
+		unsigned count_resources() const
+		{
+			return static_cast<unsigned>(resources.size());
+		}
+
+		// Reads depend on the last write, writes on the last write and all reads since then.
+		void track_dependency(unsigned pass_index, unsigned resource_index, bool is_write)
+		{
+			auto& resource	   = resources[resource_index];
+			auto& dependencies = passes[pass_index].dependencies;
+
+			auto add = [&](unsigned dependency) {
+				if(dependency != NONE && dependency != pass_index &&
+				   std::find(dependencies.begin(), dependencies.end(), dependency) == dependencies.end())
+					dependencies.emplace_back(dependency);
+			};
+			add(resource.last_writer);
+			if(!is_write)
+			{
+				resource.readers_since_write.emplace_back(pass_index);
+				return;
+			}
+
+			for(auto reader : resource.readers_since_write)
+				add(reader);
+			resource.readers_since_write.clear();
+			resource.last_writer = pass_index;
+		}
+
+		// Passes are live if they have side effects or write to imported resources, or if a live pass depends on them. Since
+		// dependencies always point to earlier passes, one backwards sweep finds all of them.
+		void cull_passes()
+		{
+			for(auto& pass : passes)
+				for(auto& access : pass.accesses)
+					if(access.is_write && !resources[access.resource].is_transient())
+						pass.is_live = true;
+
+			for(auto& pass : passes | std::views::reverse)
+			{
+				pass.is_live |= pass.has_side_effects;
+				if(pass.is_live)
+					for(auto dependency : pass.dependencies)
+						passes[dependency].is_live = true;
+			}
+
+			for(auto& pass : passes)
+				if(!pass.is_live)
+					++stats.culled_pass_count;
+		}
+
+		// Orders live passes topologically, preferring to stay on the queue of the previous pass so that fewer command lists
+		// and submissions are needed. Among passes on the preferred queue, the one declared first goes first.
+		void schedule_passes()
+		{
+			SmallList<unsigned> remaining_dependencies;
+			remaining_dependencies.reserve(passes.size());
+			for(auto& pass : passes)
+				remaining_dependencies.emplace_back(static_cast<unsigned>(pass.dependencies.size()));
+
+			SmallList<unsigned> ready;
+			for(unsigned i = 0; i != count_passes(); ++i)
+				if(passes[i].is_live && remaining_dependencies[i] == 0)
+					ready.emplace_back(i);
+
+			std::optional<CommandType> previous_queue;
+			while(!ready.empty())
+			{
+				auto next = ready.begin();
+				for(auto it = ready.begin(); it != ready.end(); ++it)
+				{
+					bool const next_on_queue = passes[*next].queue == previous_queue;
+					bool const it_on_queue	 = passes[*it].queue == previous_queue;
+					if(it_on_queue != next_on_queue ? it_on_queue : *it < *next)
+						next = it;
+				}
+				unsigned const index = *next;
+				ready.erase(next);
+
+				passes[index].position = static_cast<unsigned>(order.size());
+				order.emplace_back(index);
+				previous_queue = passes[index].queue;
+
+				for(unsigned i = index + 1; i != count_passes(); ++i)
+				{
+					auto& dependencies = passes[i].dependencies;
+					if(passes[i].is_live && std::find(dependencies.begin(), dependencies.end(), index) != dependencies.end())
+						if(--remaining_dependencies[i] == 0)
+							ready.emplace_back(i);
+				}
+			}
+		}
+
+		// Binds each transient resource to a pooled object with the same specification that is not used by another resource
+		// during its lifetime. Resources with a transient usage are additionally placed into a heap first, where they must
+		// also have the same offset as the object. A pooled object is only bound again in a new frame if the resource starts on
+		// its home queue.
+		void bind_resources(FrameResources& frame)
+		{
+			for(unsigned position = 0; position != order.size(); ++position)
+				for(auto& access : passes[order[position]].accesses)
+					resources[access.resource].uses.emplace_back(position, &access);
+
+			for(auto& pooled : frame.images)
+				pooled.free_from = NONE;
+			for(auto& pooled : frame.buffers)
+				pooled.free_from = NONE;
+
+			SmallList<unsigned> transients;
+			for(unsigned i = 0; i != count_resources(); ++i)
+				if(resources[i].is_transient() && !resources[i].uses.empty())
+					transients.emplace_back(i);
+
+			std::sort(transients.begin(), transients.end(), [&](unsigned left, unsigned right) {
+				return resources[left].uses.front().position < resources[right].uses.front().position;
+			});
+			place_resources(frame, transients);
+
+			for(auto index : transients)
+			{
+				auto& resource = resources[index];
+				if(resource.image_spec)
+				{
+					auto& pooled   = bind_to_pool(frame.images, resource, *resource.image_spec, frame);
+					resource.image = &pooled.object;
+				}
+				else
+				{
+					auto& pooled	= bind_to_pool(frame.buffers, resource, *resource.buffer_spec, frame);
+					resource.buffer = &pooled.object;
+				}
+			}
+		}
+
+		// Places resources with a transient usage at the lowest offset in the heap for their kind where they don't overlap
+		// any resource in use at the same time. Heaps that are too small are made anew along with all objects in them.
+		void place_resources(FrameResources& frame, SmallList<unsigned> const& transients)
+		{
+			std::vector<Placement> placements[size_from_enum_max<TransientHeapContents>()];
+			size_t				   alignments[size_from_enum_max<TransientHeapContents>()] {};
+			uint32_t			   memory_types[size_from_enum_max<TransientHeapContents>()];
+			std::fill(std::begin(memory_types), std::end(memory_types), UINT32_MAX);
+			for(auto index : transients)
+			{
+				auto& resource = resources[index];
+				if(!resource.has_transient_usage())
+				{
+					stats.transient_bytes += resource.image_spec ? estimate_size(*resource.image_spec)
+																 : resource.buffer_spec->size.get();
+					continue;
+				}
+				auto requirements = resource.image_spec ? get_memory_requirements(*resource.image_spec)
+														: get_memory_requirements(*resource.buffer_spec);
+				stats.transient_bytes += requirements.size;
+
+				auto const contents = static_cast<size_t>(resource.get_heap_contents());
+				alignments[contents]	= std::max(alignments[contents], requirements.alignment);
+				memory_types[contents] &= requirements.memory_types;
+
+				auto&  heap_placements = placements[contents];
+				size_t offset		   = find_free_offset(heap_placements, requirements, resource.uses.front().position);
+				resource.offset		   = offset;
+				heap_placements.emplace_back(index, offset, requirements.size, resource.uses.front().position,
+											 resource.uses.back().position);
+			}
+
+			for(size_t i = 0; i != std::size(placements); ++i)
+			{
+				size_t heap_size = 0;
+				for(auto& placement : placements[i])
+					heap_size = std::max(heap_size, placement.offset + placement.size);
+
+				auto& heap = frame.heaps[i];
+				if(heap_size == 0 || (heap && heap->get_size() >= heap_size && heap->supports(alignments[i], memory_types[i])))
+					continue;
+
+				auto contents	= static_cast<TransientHeapContents>(i);
+				auto is_in_heap = [=](auto const& pooled) {
+					if constexpr(std::same_as<std::remove_cvref_t<decltype(pooled)>, PooledImage>)
+						return pooled.offset && get_transient_heap_contents(pooled.spec.usage) == contents;
+					else
+						return pooled.offset && contents == TransientHeapContents::Buffers;
+				};
+				std::erase_if(frame.images, is_in_heap);
+				std::erase_if(frame.buffers, is_in_heap);
+				heap.reset();
+				heap = device->make_transient_heap({
+					.size		  = heap_size,
+					.contents	  = contents,
+					.alignment	  = alignments[i],
+					.memory_types = memory_types[i],
+				});
+			}
+		}
+
+		// Finds the lowest offset at which the resource overlaps no placement still in use when it is first used. Placements
+		// whose memory it overlaps are handed over to it, which queues have to wait for.
+		size_t find_free_offset(std::vector<Placement> const& placements, MemoryRequirements requirements, unsigned first)
+		{
+			SmallList<Placement const*> occupied;
+			for(auto& placement : placements)
+				if(placement.last >= first)
+					occupied.emplace_back(&placement);
+
+			std::sort(occupied.begin(), occupied.end(), [](Placement const* left, Placement const* right) {
+				return left->offset < right->offset;
+			});
+
+			size_t offset = 0;
+			for(auto placement : occupied)
+			{
+				if(offset + requirements.size <= placement->offset)
+					break;
+
+				size_t const end = placement->offset + placement->size;
+				offset			 = std::max(offset, align_up(end, requirements.alignment));
+			}
+
+			for(auto& placement : placements)
+				if(placement.last < first && placement.offset < offset + requirements.size &&
+				   offset < placement.offset + placement.size)
+					memory_handoffs.emplace_back(placement.last, first);
+
+			return offset;
+		}
+
+		static size_t align_up(size_t value, size_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		MemoryRequirements get_memory_requirements(ImageSpecification const& spec)
+		{
+			return get_cached_requirements(image_requirements, spec);
+		}
+
+		MemoryRequirements get_memory_requirements(BufferSpecification const& spec)
+		{
+			return get_cached_requirements(buffer_requirements, spec);
+		}
+
+		template<typename Spec>
+		MemoryRequirements get_cached_requirements(std::vector<CachedRequirements<Spec>>& cache, Spec const& spec)
+		{
+			for(auto& cached : cache)
+				if(has_same_specification(cached.spec, spec))
+					return cached.requirements;
+
+			return cache.emplace_back(spec, device->get_memory_requirements(spec)).requirements;
+		}
+
+		template<typename T, typename Spec>
+		Pooled<T, Spec>& bind_to_pool(std::vector<Pooled<T, Spec>>& pool,
+									  ResourceNode const&			resource,
+									  Spec const&					spec,
+									  FrameResources const&			frame)
+		{
+			auto const	first		= resource.uses.front().position;
+			auto const	first_queue = passes[order[first]].queue;
+			auto const	last		= resource.uses.back().position;
+			auto const& uses		= resource.uses;
+
+			auto fits = [&](Pooled<T, Spec> const& pooled) {
+				if(!has_same_specification(pooled.spec, spec) || pooled.offset != resource.offset)
+					return false;
+				if(pooled.is_bound())
+					return pooled.free_from <= first;
+				return pooled.home_queue == first_queue;
+			};
+			auto it = std::find_if(pool.begin(), pool.end(), fits);
+			if(it == pool.end())
+			{
+				if(resource.offset)
+				{
+					auto& heap	 = *frame.heaps[static_cast<size_t>(resource.get_heap_contents())];
+					auto  object = make_object(spec, heap, *resource.offset);
+					it			 = pool.insert(pool.end(), {std::move(object), spec, first_queue, resource.offset});
+				}
+				else
+					it = pool.insert(pool.end(), {make_object(spec), spec, first_queue});
+			}
+
+			if(!it->is_bound())
+			{
+				it->home_queue = first_queue;
+				it->uses.clear();
+			}
+			it->free_from = last + 1;
+			it->uses.insert(it->uses.end(), uses.begin(), uses.end());
+			return *it;
+		}
+
+		Image make_object(ImageSpecification const& spec)
+		{
+			return device->make_image(spec);
+		}
+
+		Buffer make_object(BufferSpecification const& spec)
+		{
+			return device->make_buffer(spec);
+		}
+
+		Image make_object(ImageSpecification const& spec, TransientHeap const& heap, size_t offset)
+		{
+			return device->make_placed_image(spec, heap, offset);
+		}
+
+		Buffer make_object(BufferSpecification const& spec, TransientHeap const& heap, size_t offset)
+		{
+			return device->make_placed_buffer(spec, heap, offset);
+		}
+
+		static bool has_same_specification(ImageSpecification const& left, ImageSpecification const& right)
+		{
+			return left.expanse.width == right.expanse.width && left.expanse.height == right.expanse.height &&
+				   left.expanse.depth == right.expanse.depth && left.dimension == right.dimension &&
+				   left.format == right.format && left.mip_count == right.mip_count &&
+				   left.sample_count == right.sample_count && left.usage == right.usage;
+		}
+
+		static bool has_same_specification(BufferSpecification const& left, BufferSpecification const& right)
+		{
+			return left.size == right.size && left.stride == right.stride && left.usage == right.usage;
+		}
+
+		static size_t estimate_size(ImageSpecification const& spec)
+		{
+			size_t	 bits	= 0;
+			unsigned width	= spec.expanse.width;
+			unsigned height = spec.expanse.height;
+			unsigned depth	= spec.dimension == ImageDimension::Image3D ? spec.expanse.depth : 1;
+			for(unsigned mip = 0; mip != spec.mip_count; ++mip)
+			{
+				bits += size_t(width) * height * depth;
+				width  = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+				depth  = std::max(depth / 2, 1u);
+			}
+			unsigned const layers = spec.dimension == ImageDimension::Image3D ? 1 : spec.expanse.depth;
+			return bits * layers * spec.sample_count * get_bits_per_texel(spec.format) / 8;
+		}
+
+		// Groups consecutive passes on the same queue into batches. A batch waits for batches on other queues that its passes
+		// depend on, or that hand a resource or the memory of a transient heap over to it.
+		std::pmr::vector<Batch> form_batches()
+		{
+			std::pmr::vector<Batch> batches(&frames.current_arena());
+			for(unsigned position = 0; position != order.size(); ++position)
+			{
+				auto& pass = passes[order[position]];
+				if(batches.empty() || batches.back().queue != pass.queue)
+					batches.emplace_back(pass.queue);
+
+				batches.back().positions.emplace_back(position);
+				pass.batch = static_cast<unsigned>(batches.size() - 1);
+			}
+
+			auto add_wait = [&](unsigned earlier_position, unsigned later_position) {
+				auto& earlier = passes[order[earlier_position]];
+				auto& later	  = passes[order[later_position]];
+				auto& waits	  = batches[later.batch].waits;
+				if(earlier.queue != later.queue && std::find(waits.begin(), waits.end(), earlier.batch) == waits.end())
+					waits.emplace_back(earlier.batch);
+			};
+			for(auto index : order)
+				for(auto dependency : passes[index].dependencies)
+					add_wait(passes[dependency].position, passes[index].position);
+
+			for_each_use_list([&](SmallList<Use> const& uses) {
+				for(size_t i = 1; i < uses.size(); ++i)
+					add_wait(uses[i - 1].position, uses[i].position);
+			});
+			for(auto [last_position, next_position] : memory_handoffs)
+				add_wait(last_position, next_position);
+
+			return batches;
+		}
+
+		// Calls the function with the uses of every object that the resources of this frame are bound to.
+		void for_each_use_list(auto function)
+		{
+			auto& frame = frames.current();
+			for(auto& pooled : frame.images)
+				if(pooled.is_bound())
+					function(pooled.uses);
+			for(auto& pooled : frame.buffers)
+				if(pooled.is_bound())
+					function(pooled.uses);
+			for(auto& resource : resources)
+				if(!resource.is_transient())
+					function(resource.uses);
+		}
+
+		FrameSubmission record_and_submit(FrameResources& frame, std::pmr::vector<Batch>& batches)
+		{
+			// Presentation is submitted on the render queue, so a frame must end with a render command list. It waits for the
+			// last batch on the other queues, so that the frame is only done once its command lists and heaps can be reused.
+			if(batches.empty() || batches.back().queue != CommandType::Render)
+				batches.emplace_back(CommandType::Render);
+
+			auto& final_waits = batches.back().waits;
+			for(auto queue : {CommandType::Copy, CommandType::Compute})
+			{
+				auto last = std::find_if(batches.rbegin(), batches.rend(), [=](Batch const& batch) {
+					return batch.queue == queue;
+				});
+				if(last == batches.rend())
+					continue;
+
+				unsigned const index = static_cast<unsigned>(batches.rend() - last - 1);
+				if(std::find(final_waits.begin(), final_waits.end(), index) == final_waits.end())
+					final_waits.emplace_back(index);
+			}
+
+			// Uploads made since the last frame are submitted first. The first batch on each queue waits for them in case it
+			// or a later batch on the same queue reads them.
+			auto const			 upload_token		  = device.get_upload_queue().submit();
+			bool				 waited_for_upload[3] = {};
+			unsigned			 used_lists[3]		  = {};
+			SmallList<SyncToken> tokens;
+			FrameSubmission		 submission;
+			for(unsigned i = 0; i != batches.size(); ++i)
+			{
+				auto& batch = batches[i];
+				auto  cmd	= take_command_list(frame, batch.queue, used_lists);
+				cmd->reset();
+				cmd->begin();
+				for(auto position : batch.positions)
+					record_pass(*cmd, position);
+				cmd->end();
+				stats.barrier_count += cmd->count_barriers();
+
+				SmallList<SyncToken> waits;
+				if(upload_token && !std::exchange(waited_for_upload[static_cast<unsigned>(batch.queue)], true))
+					waits.emplace_back(*upload_token);
+				for(auto wait : batch.waits)
+					waits.emplace_back(tokens[wait]);
+
+				if(i == batches.size() - 1)
+				{
+					submission.cmds.emplace_back(cmd->get_handle());
+					submission.gpu_wait_tokens = std::move(waits);
+					break;
+				}
+				tokens.emplace_back(submit(batch.queue, cmd->get_handle(), waits));
+				++stats.submission_count;
+			}
+			return submission;
+		}
+
+		AbstractCopyCommandList* take_command_list(FrameResources& frame, CommandType queue, unsigned (&used_lists)[3])
+		{
+			auto& used = used_lists[static_cast<unsigned>(queue)];
+			switch(queue)
+			{
+				case CommandType::Copy:
+					if(used == frame.copy_lists.size())
+						frame.copy_lists.emplace_back(device->make_copy_command_list());
+					return frame.copy_lists[used++].operator->();
+				case CommandType::Compute:
+					if(used == frame.compute_lists.size())
+						frame.compute_lists.emplace_back(device->make_compute_command_list());
+					return frame.compute_lists[used++].operator->();
+				case CommandType::Render:
+					if(used == frame.render_lists.size())
+						frame.render_lists.emplace_back(device->make_render_command_list());
+					return frame.render_lists[used++].operator->();
+			}
+			VT_UNREACHABLE();
+		}
+
+		SyncToken submit(CommandType queue, CommandListHandle cmd, ConstSpan<SyncToken> waits)
+		{
+			switch(queue)
+			{
+				case CommandType::Copy: return device->submit_copy_commands(cmd, waits);
+				case CommandType::Compute: return device->submit_compute_commands(cmd, waits);
+				case CommandType::Render: return device->submit_render_commands(cmd, waits);
+			}
+			VT_UNREACHABLE();
+		}
+
+		void record_pass(AbstractCopyCommandList& cmd, unsigned position)
+		{
+			auto& pass = passes[order[position]];
+			for(auto& access : pass.accesses)
+			{
+				auto& resource = resources[access.resource];
+				if(resource.offset && resource.uses.front().access == &access)
+				{
+					if(resource.image)
+						cmd.alias(*resource.image);
+					else
+						cmd.alias(*resource.buffer);
+				}
+
+				if(resource.image)
+					cmd.require(*resource.image, access.layout);
+				else
+					cmd.require(*resource.buffer, access.buffer_access);
+			}
+
+			uint64_t start = Tick::measure_time();
+			Tick	 record_time;
+			pass.record(cmd, Resources(*this));
+			record_time.update(start);
+			stats.passes.emplace_back(pass.name, pass.queue, record_time);
+
+			for(auto& access : pass.accesses)
+				if(access.is_attachment)
+				{
+					auto& render_cmd = static_cast<AbstractRenderCommandList&>(cmd);
+					render_cmd.assume_attachment_layout(*resources[access.resource].image, access.final_layout);
+				}
+
+			release_resources(cmd, pass, position);
+		}
+
+		// Hands resources over to the queue of their next use if that is another queue. After their last use in the frame,
+		// transient objects are handed back to their home queue and imported resources to the queue of their first use.
+		void release_resources(AbstractCopyCommandList& cmd, PassNode const& pass, unsigned position)
+		{
+			auto release = [&](SmallList<Use> const& uses, CommandType home_queue, auto const& object) {
+				auto it = std::find_if(uses.begin(), uses.end(), [&](Use use) { return use.position > position; });
+
+				Access const* next_access;
+				CommandType	  next_queue;
+				if(it != uses.end())
+				{
+					next_access = it->access;
+					next_queue	= passes[order[it->position]].queue;
+				}
+				else
+				{
+					next_access = uses.front().access;
+					next_queue	= home_queue;
+				}
+
+				if(next_queue == pass.queue)
+					return;
+
+				if constexpr(std::same_as<decltype(object), Image const&>)
+					cmd.transition(object, next_access->layout, next_queue);
+				else
+					cmd.transition(object, next_access->buffer_access, next_queue);
+			};
+
+			auto& frame = frames.current();
+			for(auto& pooled : frame.images)
+				if(pooled.is_bound() && uses_at(pooled.uses, position))
+					release(pooled.uses, pooled.home_queue, pooled.object);
+			for(auto& pooled : frame.buffers)
+				if(pooled.is_bound() && uses_at(pooled.uses, position))
+					release(pooled.uses, pooled.home_queue, pooled.object);
+			for(auto& resource : resources)
+				if(!resource.is_transient() && uses_at(resource.uses, position))
+				{
+					auto const first_queue = passes[order[resource.uses.front().position]].queue;
+					if(resource.image)
+						release(resource.uses, first_queue, *resource.image);
+					else
+						release(resource.uses, first_queue, *resource.buffer);
+				}
+		}
+
+		static bool uses_at(SmallList<Use> const& uses, unsigned position)
+		{
+			return std::any_of(uses.begin(), uses.end(), [=](Use use) { return use.position == position; });
+		}
+	};
+}
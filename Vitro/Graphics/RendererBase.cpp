@@ -5,10 +5,10 @@ export module vt.Graphics.RendererBase;
 
 import vt.Core.FixedList;
 import vt.Core.Rect;
-import vt.Core.SmallList;
 import vt.Core.Tick;
 import vt.Graphics.Device;
 import vt.Graphics.Handle;
+import vt.Graphics.RenderGraph;
 import vt.Graphics.RenderPass;
 import vt.Graphics.RenderTarget;
 import vt.Graphics.RenderTargetSpecification;
@@ -22,7 +22,7 @@ namespace vt
 		virtual ~RendererBase() = default;
 
 		// For internal use only.
-		SmallList<CommandListHandle> render(Tick tick, SwapChain& swap_chain)
+		FrameSubmission render(Tick tick, SwapChain& swap_chain)
 		{
 			// Create swap chain render targets lazily.
 			if(shared_targets.empty())
@@ -66,8 +66,9 @@ namespace vt
 		RendererBase(Device& device) : device(device)
 		{}
 
-		// Execute renderer-specific rendering. The final batch of command lists is returned for submission here.
-		virtual SmallList<CommandListHandle> render(Tick tick, RenderTarget const& render_target) = 0;
+		// Execute renderer-specific rendering. The final batch of command lists is returned for submission here, along with
+		// the tokens of workloads on other queues that it has to wait for.
+		virtual FrameSubmission render(Tick tick, RenderTarget const& render_target) = 0;
 
 		// Gets the specification describing the components of the render target that is rendered to last in a renderer.
 		virtual SharedRenderTargetSpecification specify_shared_render_target() const = 0;
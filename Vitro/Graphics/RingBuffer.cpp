@@ -1,15 +1,18 @@
 module;
+#include <memory>
 #include <utility>
 export module vt.Graphics.RingBuffer;
 
 import vt.Core.FixedList;
+import vt.Core.FrameArena;
 
 namespace vt
 {
 	export constexpr inline unsigned MAX_FRAMES_IN_FLIGHT = 3;
 
 	// Implements a simple ring-buffer-like data structure that holds a globally defined number of instances of T and allows
-	// switching between them.
+	// switching between them. Each frame also has an arena for transient allocations, which is reset when its frame comes up
+	// again.
 	export template<typename T> class RingBuffer
 	{
 	public:
@@ -32,6 +35,13 @@ namespace vt
 		void move_to_next_frame()
 		{
 			index = (index + 1) % frame_resources.size();
+			arenas[index].reset();
+		}
+
+		// Memory resource for containers that only live until the current frame comes up again.
+		FrameArena& current_arena() noexcept
+		{
+			return arenas[index];
 		}
 
 		T& get_previous() noexcept
@@ -53,6 +63,7 @@ namespace vt
 
 	private:
 		FixedList<T, MAX_FRAMES_IN_FLIGHT> frame_resources;
-		unsigned						   index = 0;
+		std::unique_ptr<FrameArena[]>	   arenas = std::make_unique<FrameArena[]>(MAX_FRAMES_IN_FLIGHT); // Keeps this movable.
+		unsigned						   index  = 0;
 	};
 }
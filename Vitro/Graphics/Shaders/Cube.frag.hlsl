@@ -2,8 +2,7 @@
 
 struct PushConstants
 {
-	float4	 triangle_color;
-	float4x4 mvp;
+	float4 triangle_color;
 };
 PUSH_CONST(PushConstants, constants);
 
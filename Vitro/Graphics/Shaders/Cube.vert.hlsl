@@ -1,11 +1,10 @@
 #include "Vitro.hlsli"
 
-struct PushConstants
+struct DrawConstants
 {
-	float4	 triangle_color;
 	float4x4 mvp;
 };
-PUSH_CONST(PushConstants, constants);
+ConstantBuffer<DrawConstants> draw_constants : register(b0);
 
 struct VertexIn
 {
@@ -23,7 +22,7 @@ VertexOut main(VertexIn vertex_in)
 {
 	VertexOut vertex_out;
 
-	vertex_out.position = mul(constants.mvp, vertex_in.position);
+	vertex_out.position = mul(draw_constants.mvp, vertex_in.position);
 	vertex_out.color	= vertex_in.color;
 
 	return vertex_out;
@@ -0,0 +1,19 @@
+#include "Vitro.hlsli"
+
+struct PushConstants
+{
+	float4 placement;
+	float4 color;
+};
+PUSH_CONST(PushConstants, constants);
+
+struct VertexOut
+{
+	float4 position : SV_Position;
+	float4 color : COLOR;
+};
+
+float4 main(VertexOut vertex_out) : SV_Target
+{
+	return vertex_out.color * constants.color;
+}
@@ -0,0 +1,38 @@
+#include "Vitro.hlsli"
+
+struct DrawConstants
+{
+	float4x4 mvp;
+};
+ConstantBuffer<DrawConstants> draw_constants : register(b0);
+
+struct PushConstants
+{
+	float4 placement; // Position in xyz and scale in w.
+	float4 color;
+};
+PUSH_CONST(PushConstants, constants);
+
+struct VertexIn
+{
+	float4 position : POSITION0;
+	float4 color : COLOR;
+};
+
+struct VertexOut
+{
+	float4 position : SV_Position;
+	float4 color : COLOR;
+};
+
+VertexOut main(VertexIn vertex_in)
+{
+	VertexOut vertex_out;
+
+	float3 position = vertex_in.position.xyz * constants.placement.w + constants.placement.xyz;
+
+	vertex_out.position = mul(draw_constants.mvp, float4(position, 1));
+	vertex_out.color	= vertex_in.color;
+
+	return vertex_out;
+}
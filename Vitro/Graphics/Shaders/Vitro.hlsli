@@ -15,3 +15,14 @@
 	#error No macro defined that indicates the target GPU API.
 
 #endif
+
+// Inverse of vt::encode_octahedral, for normals stored in the SNorm16x2 vertex format.
+float3 decode_octahedral(float2 oct)
+{
+	float3 normal = float3(oct, 1 - abs(oct.x) - abs(oct.y));
+	float  fold	  = saturate(-normal.z);
+	// step yields 1 for non-negative components, which flips the sign of the fold. Vector ternaries and select don't
+	// compile under both FXC and HLSL 2021.
+	normal.xy += fold * (1 - 2 * step(0, normal.xy));
+	return normalize(normal);
+}
@@ -0,0 +1,460 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <vector>
+export module vt.Graphics.StressRenderer;
+
+import vt.App.EventListener;
+import vt.App.Input;
+import vt.App.WindowEvent;
+import vt.Core.Half;
+import vt.Core.Packing;
+import vt.Core.Rect;
+import vt.Core.Ref;
+import vt.Core.SmallList;
+import vt.Core.Tick;
+import vt.Core.Transform;
+import vt.Core.Vector;
+import vt.Core.VectorStream;
+import vt.Graphics.AbstractDevice;
+import vt.Graphics.AssetResource;
+import vt.Graphics.Camera;
+import vt.Graphics.CommandList;
+import vt.Graphics.AbstractCommandList;
+import vt.Graphics.Culling;
+import vt.Graphics.DeletionQueue;
+import vt.Graphics.DescriptorBinding;
+import vt.Graphics.DescriptorSet;
+import vt.Graphics.DescriptorSetLayout;
+import vt.Graphics.Device;
+import vt.Graphics.DynamicBufferAllocator;
+import vt.Graphics.ParallelCommandRecorder;
+import vt.Graphics.RendererBase;
+import vt.Graphics.RenderGraph;
+import vt.Graphics.RenderPass;
+import vt.Graphics.RenderTarget;
+import vt.Graphics.RingBuffer;
+import vt.Graphics.RootSignature;
+import vt.Graphics.Shader;
+import vt.Graphics.UploadQueue;
+import vt.Trace.Log;
+
+namespace vt
+{
+	// Draws a grid of 50,000 cubes with one draw each, which makes recording the draws on one thread the bottleneck. The draws
+	// are recorded through a ParallelCommandRecorder, whose thread count doubles every few seconds until it wraps around, so
+	// that the logged recording times show how recording scales with threads.
+	export class StressRenderer : public RendererBase, public EventListener
+	{
+	public:
+		StressRenderer(Device& device, Extent shared_render_target_size, ImageFormat shared_render_target_format) :
+			RendererBase(device),
+			cam({-3, 0, -3}, {3, 0, 3}, project_perspective(0.4f * 3.14f, shared_render_target_size, 1.0f, 1000.f)),
+			final_render_pass(make_final_render_pass(shared_render_target_format)),
+			graph(device),
+			context(device)
+		{
+			initialize_cube_grid();
+			initialize_root_signature();
+			initialize_draw_constant_descriptors();
+			initialize_vertex_and_index_buffers();
+			initialize_depth_image(shared_render_target_size);
+			initialize_render_pipeline(); // Last, since the destructor only runs to release it once construction succeeded.
+
+			register_event_handlers<&StressRenderer::on_mouse_move>();
+		}
+
+		// Window contexts flush the device before destroying their renderer, so the pipeline is no longer in use.
+		~StressRenderer() override
+		{
+			device.release_pipeline(render_pipeline);
+		}
+
+	protected:
+		FrameSubmission render(Tick tick, RenderTarget const& render_target) override
+		{
+			auto& current = context.current();
+
+			current.deletion_queue.delete_all();
+
+			Float4 clear_color = 0.5f + 0.5f * cos(time / 1000.0f + Float3 {0, 2, 4});
+			clear_color.a	   = 1;
+			time += tick * 1000;
+
+			update_cam(tick);
+
+			// Written before recording, since passes might be recorded on other threads.
+			auto&		   allocator	  = device.get_dynamic_buffer_allocator();
+			unsigned const mvp_offset	  = allocator.push(cam.get_view_projection());
+			auto&		   draw_constants = draw_constant_sets[allocator.get_current_frame_index()];
+			auto&		   pipeline		  = device.get_resource(render_pipeline);
+
+			Float4 cube_color = 0.5f + 0.5f * cos(time / 1000.0f + Float3 {3, 1.5, 0});
+			cube_color.a	  = 1;
+
+			visible_cubes.clear();
+			cull_boxes(Frustum::from_camera(cam), cube_centers, cube_extents, visible_cubes);
+
+			auto vertex_buffer = graph.import_buffer("Vertices", vertex_buffers[0]);
+			auto index_buffer  = graph.import_buffer("Indices", index_buffers[0]);
+			auto depth_image   = graph.import_image("Depth", depth_images[0]);
+			graph.add_pass<CommandType::Render>(
+				"Forward",
+				[&](RenderGraph::PassBuilder& pass) {
+					pass.read(vertex_buffer, BufferAccess::Vertex);
+					pass.read(index_buffer, BufferAccess::Index);
+					pass.attach(depth_image, ImageLayout::DepthStencilAttachment, ImageLayout::DepthStencilAttachment);
+					pass.mark_side_effects(); // Renders to the swap chain image.
+				},
+				[&](AbstractRenderCommandList& cmd, RenderGraph::Resources const& resources) {
+					ClearValue clear_value[] {
+						ClearValue {
+							.color = clear_color,
+						},
+						ClearValue {
+							.depth = 1.0f,
+						},
+					};
+					cmd.begin_render_pass(final_render_pass, render_target, clear_value, SubpassContents::Secondary);
+
+					// Secondary command lists inherit no state, so each one sets up everything before its share of the draws.
+					auto record_cubes = [&](RenderCommandList& list, size_t begin, size_t end) {
+						list->bind_render_root_signature(root_signatures[0]);
+						list->bind_render_pipeline(pipeline);
+						list->bind_render_descriptors(draw_constants, mvp_offset);
+
+						Viewport viewport {
+							.width	= static_cast<float>(render_target.get_width()),
+							.height = static_cast<float>(render_target.get_height()),
+						};
+						list->set_viewports(viewport);
+
+						Rectangle scissor {
+							.width	= render_target.get_width(),
+							.height = render_target.get_height(),
+						};
+						list->set_scissors(scissor);
+
+						size_t offset = 0;
+						list->bind_vertex_buffers(0, resources.get(vertex_buffer), offset);
+						list->bind_index_buffer(resources.get(index_buffer), 0);
+
+						for(size_t i = begin; i != end; ++i)
+						{
+							unsigned const		cube = visible_cubes[i];
+							CubeConstants const constants {
+								.placement = cube_placements[cube],
+								.color	   = cube_color,
+							};
+							list->push_render_constants(0, sizeof constants, &constants);
+							list->draw_indexed(36, 1, 0, 0, 0);
+						}
+					};
+					auto const start = std::chrono::steady_clock::now();
+					current.recorder.record(cmd, final_render_pass, 0, render_target, visible_cubes.size(),
+											recording_thread_count, record_cubes);
+					log_recording_time(start, current.recorder.get_max_thread_count());
+					cmd.end_render_pass();
+				});
+
+			context.move_to_next_frame();
+			return graph.execute();
+		}
+
+		SharedRenderTargetSpecification specify_shared_render_target() const override
+		{
+			return {
+				.depth_stencil_attachment = &depth_images[0],
+				.render_pass			  = final_render_pass,
+				.shared_img_dst_index	  = 0,
+			};
+		}
+
+		void on_render_target_resize(Extent size) override
+		{
+			depth_images.clear();
+			initialize_depth_image(size);
+		}
+
+	private:
+		static constexpr unsigned CUBE_GRID_WIDTH  = 50;
+		static constexpr unsigned CUBE_GRID_HEIGHT = 20;
+		static constexpr unsigned CUBE_GRID_DEPTH  = 50;
+		static constexpr float	  CUBE_SPACING	   = 4;
+		static constexpr unsigned FRAMES_PER_THREAD_COUNT = 300;
+
+		struct CubeConstants
+		{
+			Float4 placement; // Position in xyz and scale in w.
+			Float4 color;
+		};
+
+		Camera							 cam;
+		RenderPass						 final_render_pass;
+		std::vector<DescriptorSetLayout> descriptor_set_layouts;
+		std::vector<RootSignature>		 root_signatures;
+		SmallList<DescriptorSet>		 draw_constant_sets; // One per dynamic buffer, since each frame has its own.
+		RenderPipelineHandle			 render_pipeline; // Shared with other renderers that use an equal pipeline.
+		std::vector<Buffer>				 vertex_buffers;
+		std::vector<Buffer>				 index_buffers;
+		std::vector<Image>				 depth_images;
+		std::vector<Float4>				 cube_placements;
+		Float3Stream					 cube_centers; // Bounds of the cubes for culling, in the same order as the placements.
+		Float3Stream					 cube_extents;
+		std::vector<unsigned>			 visible_cubes; // Indices of the cubes that intersect the view frustum this frame.
+		float							 time					= 0;
+		std::atomic<int>				 mouse_movement_x		= 0; // Mouse movement since the camera was last updated.
+		std::atomic<int>				 mouse_movement_y		= 0;
+		unsigned						 recording_thread_count	= 1;
+		unsigned						 timed_frames			= 0; // Frames recorded with the current thread count so far.
+		double							 recording_time			= 0; // Milliseconds spent recording those frames.
+		RenderGraph						 graph;
+
+		struct FrameResources
+		{
+			DeletionQueue			deletion_queue;
+			ParallelCommandRecorder recorder;
+
+			FrameResources(Device& device) : recorder(device)
+			{}
+		};
+		RingBuffer<FrameResources> context;
+
+		void initialize_cube_grid()
+		{
+			unsigned const cube_count = CUBE_GRID_WIDTH * CUBE_GRID_HEIGHT * CUBE_GRID_DEPTH;
+			cube_placements.reserve(cube_count);
+			cube_centers.reserve(cube_count);
+			cube_extents.reserve(cube_count);
+
+			for(unsigned x = 0; x != CUBE_GRID_WIDTH; ++x)
+				for(unsigned y = 0; y != CUBE_GRID_HEIGHT; ++y)
+					for(unsigned z = 0; z != CUBE_GRID_DEPTH; ++z)
+					{
+						float const	 height = (static_cast<float>(y) - CUBE_GRID_HEIGHT / 2) * CUBE_SPACING;
+						Float3 const center {x * CUBE_SPACING, height, z * CUBE_SPACING};
+						cube_placements.emplace_back(Float4 {center.x, center.y, center.z, 1});
+						cube_centers.push_back(center);
+						cube_extents.push_back({1, 1, 1}); // The cube mesh spans -1 to 1 on every axis.
+					}
+		}
+
+		RenderPass make_final_render_pass(ImageFormat swap_chain_format)
+		{
+			Subpass subpass {
+				.output_attachments = {0, 1},
+			};
+			RenderPassSpecification const spec {
+				.attachments {
+					AttachmentSpecification {
+						.format			= swap_chain_format,
+						.load_op		= ImageLoadOp::Clear,
+						.store_op		= ImageStoreOp::Store,
+						.initial_layout = ImageLayout::Undefined,
+						.final_layout	= ImageLayout::Presentable,
+					},
+					AttachmentSpecification {
+						.format			= ImageFormat::D32Float,
+						.load_op		= ImageLoadOp::Clear,
+						.store_op		= ImageStoreOp::Store,
+						.initial_layout = ImageLayout::Undefined,
+						.final_layout	= ImageLayout::DepthStencilAttachment,
+					},
+				},
+				.subpasses = subpass,
+			};
+			return device->make_render_pass(spec);
+		}
+
+		void initialize_root_signature()
+		{
+			DescriptorBinding const draw_constants_binding {
+				.shader_register = 0,
+				.type			 = DescriptorType::DynamicUniformBuffer,
+			};
+			DescriptorSetLayoutSpecification const layout_spec {
+				.bindings	= draw_constants_binding,
+				.visibility = ShaderStage::Vertex,
+			};
+			descriptor_set_layouts.emplace_back(device->make_descriptor_set_layout(layout_spec));
+
+			RootSignatureSpecification const root_sig_spec {
+				.push_constants_byte_size  = sizeof(CubeConstants),
+				.push_constants_visibility = ShaderStage::All,
+				.layouts				   = descriptor_set_layouts,
+			};
+			root_signatures.emplace_back(device->make_root_signature(root_sig_spec));
+		}
+
+		void initialize_draw_constant_descriptors()
+		{
+			auto& allocator = device.get_dynamic_buffer_allocator();
+			for(unsigned i = 0; i != MAX_FRAMES_IN_FLIGHT; ++i)
+			{
+				unsigned const variable_count = 0;
+
+				auto  sets = device->make_descriptor_sets(descriptor_set_layouts[0], &variable_count);
+				auto& set  = draw_constant_sets.emplace_back(std::move(sets[0]));
+
+				CRef<Buffer> const	   buffer = allocator.get_buffer(i);
+				DescriptorUpdate const update {
+					.set			= set,
+					.first_register = 0,
+					.type			= DescriptorType::DynamicUniformBuffer,
+					.dynamic_range	= sizeof(Float4x4),
+					.buffers		= buffer,
+				};
+				device->update_descriptors(update);
+			}
+		}
+
+		void initialize_render_pipeline()
+		{
+			auto vertex_shader	 = device->make_shader("StressCube.vert." VT_SHADER_EXTENSION);
+			auto fragment_shader = device->make_shader("StressCube.frag." VT_SHADER_EXTENSION);
+
+			RenderPipelineSpecification const pipe_spec {
+				.root_signature	 = root_signatures[0],
+				.render_pass	 = final_render_pass,
+				.vertex_shader	 = vertex_shader,
+				.fragment_shader = &fragment_shader,
+				.vertex_buffer_bindings {
+					VertexBufferBinding {
+						.attributes {
+							VertexAttribute {
+								.type	= VertexDataType::Position,
+								.format = VertexFormat::Half4,
+							},
+							VertexAttribute {
+								.type	= VertexDataType::Color,
+								.format = VertexFormat::UNormRgba8,
+							},
+						},
+					},
+				},
+				.primitive_topology = PrimitiveTopology::TriangleList,
+				.subpass_index		= 0,
+				.rasterizer {
+					.cull_mode	   = CullMode::Back,
+					.winding_order = WindingOrder::Clockwise,
+				},
+				.blend {
+					.attachment_states = {1},
+				},
+			};
+			render_pipeline = device.acquire_render_pipeline(pipe_spec);
+		}
+
+		void initialize_vertex_and_index_buffers()
+		{
+			struct Vertex
+			{
+				Half4	 position;
+				uint32_t color;
+			};
+			auto make_vertex = [](Float4 position, Float4 color) {
+				return Vertex {to_half(position), pack_unorm_rgba8(color)};
+			};
+			Vertex vertices[] {
+				make_vertex({-1, -1, -1, 1}, {0, 0, 0, 1}), make_vertex({-1, 1, -1, 1}, {0, 1, 0, 1}),
+				make_vertex({1, 1, -1, 1}, {1, 1, 0, 1}),	make_vertex({1, -1, -1, 1}, {1, 0, 0, 1}),
+				make_vertex({-1, -1, 1, 1}, {0, 0, 1, 1}),	make_vertex({-1, 1, 1, 1}, {0, 1, 1, 1}),
+				make_vertex({1, 1, 1, 1}, {1, 1, 1, 1}),	make_vertex({1, -1, 1, 1}, {1, 0, 1, 1}),
+			};
+			uint32_t indices[] {0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6, 4, 5, 1, 4, 1, 0,
+								3, 2, 6, 3, 6, 7, 1, 5, 6, 1, 6, 2, 4, 0, 3, 4, 3, 7};
+
+			BufferSpecification const vertex_buffer_spec {
+				.size	= sizeof vertices,
+				.stride = sizeof(Vertex),
+				.usage	= BufferUsage::CopyDst | BufferUsage::Vertex,
+			};
+			auto& vertex_buffer = vertex_buffers.emplace_back(device->make_buffer(vertex_buffer_spec));
+
+			BufferSpecification const index_buffer_spec {
+				.size	= sizeof indices,
+				.stride = sizeof(uint32_t),
+				.usage	= BufferUsage::CopyDst | BufferUsage::Index,
+			};
+			auto& index_buffer = index_buffers.emplace_back(device->make_buffer(index_buffer_spec));
+
+			// The render graph makes the first frame wait for the uploads, so there is no need to wait for them here.
+			auto& upload_queue = device.get_upload_queue();
+			upload_queue.upload_buffer(vertex_buffer, 0, vertices, sizeof vertices, BufferAccess::Vertex, CommandType::Render);
+			upload_queue.upload_buffer(index_buffer, 0, indices, sizeof indices, BufferAccess::Index, CommandType::Render);
+		}
+
+		void initialize_depth_image(Extent size)
+		{
+			ImageSpecification const spec {
+				.expanse   = {size.width, size.height},
+				.dimension = ImageDimension::Image2D,
+				.format	   = ImageFormat::D32Float,
+				.mip_count = 1,
+				.usage	   = ImageUsage::DepthStencil,
+			};
+			depth_images.emplace_back(device->make_image(spec));
+		}
+
+		// Logs the average recording time once enough frames were timed, then moves on to the next thread count.
+		void log_recording_time(std::chrono::steady_clock::time_point start, unsigned max_thread_count)
+		{
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+			recording_time += elapsed.count();
+			if(++timed_frames != FRAMES_PER_THREAD_COUNT)
+				return;
+
+			Log().info("Recorded ", visible_cubes.size(), " cube draws with ", recording_thread_count, " threads in ",
+					   recording_time / timed_frames, " ms per frame on average.");
+
+			timed_frames   = 0;
+			recording_time = 0;
+			if(recording_thread_count == max_thread_count)
+				recording_thread_count = 1;
+			else
+				recording_thread_count = std::min(recording_thread_count * 2, max_thread_count);
+		}
+
+		// Mouse movement is applied here instead of in the event handler, so that the camera is only ever touched by the
+		// render thread.
+		void update_cam(Tick tick)
+		{
+			cam.yaw(radians(0.25f * static_cast<float>(mouse_movement_x.exchange(0, std::memory_order_relaxed))));
+			cam.pitch(radians(0.25f * static_cast<float>(mouse_movement_y.exchange(0, std::memory_order_relaxed))));
+
+			float move_speed = 5 * tick;
+
+			if(Input::is_down(KeyCode::A))
+				cam.translate({-move_speed, 0, 0});
+			if(Input::is_down(KeyCode::D))
+				cam.translate({move_speed, 0, 0});
+
+			if(Input::is_down(KeyCode::Q))
+				cam.translate({0, -move_speed, 0});
+			if(Input::is_down(KeyCode::E))
+				cam.translate({0, move_speed, 0});
+
+			if(Input::is_down(KeyCode::S))
+				cam.translate({0, 0, -move_speed});
+			if(Input::is_down(KeyCode::W))
+				cam.translate({0, 0, move_speed});
+
+			if(Input::is_down(KeyCode::R))
+				cam.set_position({-3, 0, -3});
+
+			if(Input::is_down(KeyCode::F))
+				cam.roll(-tick);
+			if(Input::is_down(KeyCode::G))
+				cam.roll(tick);
+		}
+
+		void on_mouse_move(MouseMoveEvent& event)
+		{
+			mouse_movement_x.fetch_add(event.direction.x, std::memory_order_relaxed);
+			mouse_movement_y.fetch_add(event.direction.y, std::memory_order_relaxed);
+		}
+	};
+}
@@ -5,7 +5,6 @@ module;
 export module vt.Graphics.WindowContext;
 
 import vt.App.Window;
-import vt.App.WindowEvent;
 import vt.Core.Rect;
 import vt.Core.Tick;
 import vt.Graphics.Device;
@@ -13,6 +12,7 @@ import vt.Graphics.ForwardRenderer;
 import vt.Graphics.Handle;
 import vt.Graphics.RendererBase;
 import vt.Graphics.RingBuffer;
+import vt.Graphics.StressRenderer;
 import vt.Graphics.SwapChain;
 
 namespace vt
@@ -20,12 +20,13 @@ namespace vt
 	export class WindowContext
 	{
 	public:
-		WindowContext(Window& window, Device& device) :
+		WindowContext(Window& window, Device& device, bool render_stress_scene) :
 			swap_chain(device->make_swap_chain(window)),
-			renderer(std::make_unique<ForwardRenderer>(device, window.client_area().extent(), swap_chain->get_format()))
+			renderer(make_renderer(device, window.client_area().extent(), render_stress_scene))
 		{}
 
-		void execute_frame(Tick tick, Window& window, Device& device)
+		// Returns the token of the last submission of the frame.
+		SyncToken execute_frame(Tick tick, Window& window, Device& device)
 		{
 			auto& current_token = buffered_final_submit_tokens.current();
 			if(swap_chain_invalid)
@@ -36,16 +37,19 @@ namespace vt
 			auto present_token = swap_chain->request_frame();
 			if(present_token)
 			{
-				auto final_commands = renderer->render(tick, swap_chain);
-				current_token		= device->submit_for_present(final_commands, swap_chain, *present_token);
+				auto frame = renderer->render(tick, swap_chain);
+				frame.gpu_wait_tokens.emplace_back(*present_token);
+				current_token = device->submit_for_present(frame.cmds, swap_chain, frame.gpu_wait_tokens);
 			}
+			auto submit_token = current_token;
 			buffered_final_submit_tokens.move_to_next_frame();
+			return submit_token;
 		}
 
-		void invalidate_swap_chain(WindowSizeEvent& window_size_event)
+		void invalidate_swap_chain(Extent new_window_size)
 		{
 			swap_chain_invalid = true;
-			window_size		   = window_size_event.size;
+			window_size		   = new_window_size;
 		}
 
 	private:
@@ -55,6 +59,14 @@ namespace vt
 		std::atomic_bool			  swap_chain_invalid = false;
 		Extent						  window_size;
 
+		std::unique_ptr<RendererBase> make_renderer(Device& device, Extent size, bool render_stress_scene) const
+		{
+			if(render_stress_scene)
+				return std::make_unique<StressRenderer>(device, size, swap_chain->get_format());
+			else
+				return std::make_unique<ForwardRenderer>(device, size, swap_chain->get_format());
+		}
+
 		void recreate_swap_chain_state(Device& device, Window& window)
 		{
 			device->flush_render_queue();
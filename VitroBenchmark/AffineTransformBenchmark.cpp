@@ -0,0 +1,94 @@
+module;
+#include <vector>
+export module vttool.Benchmark.AffineTransform;
+
+import vt.Core.AffineTransform;
+import vt.Core.Matrix;
+import vt.Core.Quaternion;
+import vt.Core.Vector;
+import vttool.Benchmark.Harness;
+
+namespace vt::tool
+{
+	constexpr inline size_t TRANSFORM_COUNT = 1 << 14;
+
+	// Spreads rotations, scales and translations so that no two transforms are alike.
+	std::vector<AffineTransform> make_transforms(bool rigid)
+	{
+		std::vector<AffineTransform> transforms;
+		transforms.reserve(TRANSFORM_COUNT);
+		for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+		{
+			float const f = static_cast<float>(i);
+
+			Float3 const axis		 = normalize(Float3 {1.0f, f * 0.01f, 0.5f});
+			Float3 const scale		 = rigid ? Float3 {1, 1, 1} : Float3 {1.0f + f * 0.001f, 2.0f, 0.5f + f * 0.0001f};
+			Float3 const translation = {f, -f * 0.5f, 3.0f};
+			transforms.emplace_back(AffineTransform::from_components(translation, Quaternion::from_axis_angle(axis, f * 0.001f),
+																	 scale));
+		}
+		return transforms;
+	}
+
+	export void run_affine_transform_benchmarks()
+	{
+		print_section("Affine transforms, per transform (Float4x4 baseline -> AffineTransform)");
+
+		auto const transforms = make_transforms(false);
+
+		std::vector<Float4x4> matrices;
+		matrices.reserve(TRANSFORM_COUNT);
+		for(auto& transform : transforms)
+			matrices.emplace_back(transform.to_matrix());
+
+		std::vector<AffineTransform> transform_results(TRANSFORM_COUNT);
+		std::vector<Float4x4>		 matrix_results(TRANSFORM_COUNT);
+
+		auto general = measure(TRANSFORM_COUNT, [&] {
+			for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+				matrix_results[i] = inverse(matrices[i]);
+			keep(matrix_results.data());
+		});
+		auto closed_form = measure(TRANSFORM_COUNT, [&] {
+			for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+				transform_results[i] = inverse(transforms[i]);
+			keep(transform_results.data());
+		});
+		report_comparison("inverse", general, closed_form);
+
+		// Rigid transforms are timed against the general inverse of the same transforms, not against the scaled ones above.
+		auto const rigid_transforms = make_transforms(true);
+		for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+			matrices[i] = rigid_transforms[i].to_matrix();
+
+		general = measure(TRANSFORM_COUNT, [&] {
+			for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+				matrix_results[i] = inverse(matrices[i]);
+			keep(matrix_results.data());
+		});
+		auto rigid = measure(TRANSFORM_COUNT, [&] {
+			for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+				transform_results[i] = inverse_rigid(rigid_transforms[i]);
+			keep(transform_results.data());
+		});
+		report_comparison("inverse_rigid", general, rigid);
+
+		for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+			matrices[i] = transforms[i].to_matrix();
+
+		auto const matrix_step	  = matrices[1];
+		auto const transform_step = transforms[1];
+
+		auto full = measure(TRANSFORM_COUNT, [&] {
+			for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+				matrix_results[i] = matrices[i] * matrix_step;
+			keep(matrix_results.data());
+		});
+		auto affine = measure(TRANSFORM_COUNT, [&] {
+			for(size_t i = 0; i != TRANSFORM_COUNT; ++i)
+				transform_results[i] = transforms[i] * transform_step;
+			keep(transform_results.data());
+		});
+		report_comparison("product", full, affine);
+	}
+}
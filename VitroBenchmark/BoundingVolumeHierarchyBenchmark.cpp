@@ -0,0 +1,118 @@
+module;
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+export module vttool.Benchmark.BoundingVolumeHierarchy;
+
+import vt.Core.BoundingVolumeHierarchy;
+import vt.Core.Rect;
+import vt.Core.Transform;
+import vt.Core.Vector;
+import vt.Graphics.Camera;
+import vt.Graphics.Culling;
+import vttool.Benchmark.Harness;
+
+namespace vt::tool
+{
+	constexpr inline size_t	  PRIMITIVE_COUNT = 100000;
+	constexpr inline unsigned RAY_COUNT		  = 1024;
+	constexpr inline float	  SCENE_SIZE	  = 1000;
+
+	// Scatters boxes of varying size through a cube, seeded so that every run measures the same scene.
+	std::vector<Aabb> make_primitives()
+	{
+		std::minstd_rand					  random(42);
+		std::uniform_real_distribution<float> position(-SCENE_SIZE / 2, SCENE_SIZE / 2);
+		std::uniform_real_distribution<float> extent(0.25f, 2.0f);
+
+		std::vector<Aabb> primitives(PRIMITIVE_COUNT);
+		for(auto& primitive : primitives)
+		{
+			Float3 const center {position(random), position(random), position(random)};
+			Float3 const half_size {extent(random), extent(random), extent(random)};
+			primitive = {center - half_size, center + half_size};
+		}
+		return primitives;
+	}
+
+	// Slab test for the baseline, which checks every primitive instead of descending the hierarchy.
+	std::optional<RayHit> cast_ray_linear(std::vector<Aabb> const& primitives, Ray const& ray)
+	{
+		Float3 const inv_dir = 1.0f / ray.direction;
+
+		std::optional<RayHit> closest;
+		for(unsigned i = 0; i != primitives.size(); ++i)
+		{
+			Float3 const t0 = (primitives[i].min - ray.origin) * inv_dir;
+			Float3 const t1 = (primitives[i].max - ray.origin) * inv_dir;
+
+			float const entry = std::max({std::min(t0.x, t1.x), std::min(t0.y, t1.y), std::min(t0.z, t1.z), 0.0f});
+			float const exit  = std::min({std::max(t0.x, t1.x), std::max(t0.y, t1.y), std::max(t0.z, t1.z)});
+			if(entry <= exit && (!closest || entry < closest->distance))
+				closest = RayHit {i, entry};
+		}
+		return closest;
+	}
+
+	export void run_bounding_volume_hierarchy_benchmarks()
+	{
+		print_section("Bounding volume hierarchy over 100k boxes (linear baseline -> hierarchy)");
+
+		auto const primitives = make_primitives();
+
+		BoundingVolumeHierarchy hierarchy;
+
+		auto const build = measure(PRIMITIVE_COUNT, [&] {
+			hierarchy.build(primitives);
+			keep(&hierarchy);
+		});
+		report("build, per primitive", build);
+
+		Camera const  camera({0, 0, 0}, {1, 0.2f, 1}, project_perspective(1.2f, Extent {1920, 1080}, 1.0f, 300.0f));
+		Frustum const frustum = Frustum::from_camera(camera);
+
+		std::vector<unsigned> visible;
+		visible.reserve(PRIMITIVE_COUNT);
+
+		auto const linear_frustum = measure(1, [&] {
+			visible.clear();
+			for(unsigned i = 0; i != PRIMITIVE_COUNT; ++i)
+				if(primitives[i].intersects(frustum.planes))
+					visible.push_back(i);
+			keep(visible.data());
+		});
+		auto const hierarchy_frustum = measure(1, [&] {
+			visible.clear();
+			cull_hierarchy(frustum, hierarchy, visible);
+			keep(visible.data());
+		});
+		report_comparison("query_frustum, per query", linear_frustum, hierarchy_frustum);
+
+		std::minstd_rand					  random(7);
+		std::uniform_real_distribution<float> direction(-1, 1);
+
+		std::vector<Ray> rays(RAY_COUNT);
+		for(auto& ray : rays)
+			ray = {{0, 0, 0}, normalize(Float3 {direction(random), direction(random), direction(random)})};
+
+		std::vector<std::optional<RayHit>> hits(RAY_COUNT);
+
+		// The linear scan is too slow to repeat for every ray within the minimum duration, so it only casts a sample.
+		unsigned const linear_ray_count = RAY_COUNT / 16;
+
+		auto const linear_ray = measure(linear_ray_count, [&] {
+			for(unsigned i = 0; i != linear_ray_count; ++i)
+				hits[i] = cast_ray_linear(primitives, rays[i]);
+			keep(hits.data());
+		});
+		auto const hierarchy_ray = measure(RAY_COUNT, [&] {
+			for(unsigned i = 0; i != RAY_COUNT; ++i)
+				hits[i] = hierarchy.cast_ray(rays[i]);
+			keep(hits.data());
+		});
+		report_comparison("cast_ray, per ray", linear_ray, hierarchy_ray);
+	}
+}
@@ -0,0 +1,71 @@
+module;
+#include <cstdio>
+#include <vector>
+export module vttool.Benchmark.Culling;
+
+import vt.Core.Rect;
+import vt.Core.Transform;
+import vt.Core.Vector;
+import vt.Core.VectorStream;
+import vt.Graphics.Camera;
+import vt.Graphics.Culling;
+import vttool.Benchmark.Harness;
+
+namespace vt::tool
+{
+	constexpr inline unsigned BOX_GRID_WIDTH = 100;
+	constexpr inline unsigned BOX_GRID_DEPTH = 1000;
+	constexpr inline size_t	  BOX_COUNT		 = BOX_GRID_WIDTH * BOX_GRID_DEPTH;
+
+	export void run_culling_benchmarks()
+	{
+		print_section("Frustum culling of 100k boxes, per box (Frustum::intersects -> cull_boxes)");
+
+		// The camera looks along the long side of the grid, so that a part of the boxes is inside and the rest is spread
+		// around every plane of the frustum.
+		Camera const  camera({0, 0, -10}, {0, 0, 1}, project_perspective(1.2f, Extent {1920, 1080}, 1.0f, 500.0f));
+		Frustum const frustum = Frustum::from_camera(camera);
+
+		std::vector<BoundingBox> boxes;
+		Float3Stream			 centers;
+		Float3Stream			 extents;
+		boxes.reserve(BOX_COUNT);
+		centers.reserve(BOX_COUNT);
+		extents.reserve(BOX_COUNT);
+		for(unsigned x = 0; x != BOX_GRID_WIDTH; ++x)
+		{
+			for(unsigned z = 0; z != BOX_GRID_DEPTH; ++z)
+			{
+				Float3 const center {static_cast<float>(x) * 4 - 200, static_cast<float>(x % 7) - 3, static_cast<float>(z)};
+				Float3 const extent {0.5f, 0.5f, 0.5f};
+
+				boxes.push_back({center, extent});
+				centers.push_back(center);
+				extents.push_back(extent);
+			}
+		}
+
+		std::vector<unsigned> visible;
+		visible.reserve(BOX_COUNT);
+
+		auto const scalar = measure(BOX_COUNT, [&] {
+			visible.clear();
+			for(unsigned i = 0; i != BOX_COUNT; ++i)
+				if(frustum.intersects(boxes[i]))
+					visible.push_back(i);
+			keep(visible.data());
+		});
+		size_t const scalar_visible_count = visible.size();
+
+		auto const simd = measure(BOX_COUNT, [&] {
+			visible.clear();
+			cull_boxes(frustum, centers, extents, visible);
+			keep(visible.data());
+		});
+		report_comparison("cull_boxes", scalar, simd);
+
+		if(visible.size() != scalar_visible_count)
+			std::printf("Warning: cull_boxes found %zu visible boxes, but Frustum::intersects found %zu.\n", visible.size(),
+						scalar_visible_count);
+	}
+}
@@ -0,0 +1,91 @@
+module;
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+export module vttool.Benchmark.FlatHashMap;
+
+import vt.Core.FlatHashMap;
+import vttool.Benchmark.Harness;
+
+namespace vt::tool
+{
+	constexpr inline size_t ELEMENT_COUNT = 1 << 16;
+
+	struct MapTimings
+	{
+		double insert;
+		double find_hit;
+		double find_miss;
+		double erase;
+	};
+
+	// Runs the same operations on any map with the interface of std::unordered_map.
+	template<typename Map> MapTimings time_map(std::vector<uint64_t> const& keys, std::vector<uint64_t> const& absent)
+	{
+		MapTimings timings;
+
+		timings.insert = measure(ELEMENT_COUNT, [&] {
+			Map map;
+			for(auto key : keys)
+				map.try_emplace(key, key);
+			keep(&map);
+		});
+
+		Map map;
+		for(auto key : keys)
+			map.try_emplace(key, key);
+
+		timings.find_hit = measure(ELEMENT_COUNT, [&] {
+			uint64_t sum = 0;
+			for(auto key : keys)
+				sum += map.find(key)->second;
+			keep(&sum);
+		});
+		timings.find_miss = measure(ELEMENT_COUNT, [&] {
+			size_t found = 0;
+			for(auto key : absent)
+				found += map.find(key) != map.end();
+			keep(&found);
+		});
+
+		// Refilling the map is part of every run, so the insertion time is subtracted again.
+		double const erase_and_insert = measure(ELEMENT_COUNT, [&] {
+			Map erased;
+			for(auto key : keys)
+				erased.try_emplace(key, key);
+			for(auto key : keys)
+				erased.erase(key);
+			keep(&erased);
+		});
+		timings.erase = std::max(erase_and_insert - timings.insert, 0.0);
+		return timings;
+	}
+
+	export void run_flat_hash_map_benchmarks()
+	{
+		print_section("Hash maps with 64k integer keys, per operation (std::unordered_map -> FlatHashMap)");
+
+		// Present keys are odd and absent keys are even, so that lookups of absent keys always miss.
+		std::mt19937_64		  random(42);
+		std::vector<uint64_t> keys(ELEMENT_COUNT);
+		std::vector<uint64_t> absent(ELEMENT_COUNT);
+		for(size_t i = 0; i != ELEMENT_COUNT; ++i)
+		{
+			uint64_t const key = random() | 1;
+
+			keys[i]	  = key;
+			absent[i] = key - 1;
+		}
+		std::shuffle(absent.begin(), absent.end(), random);
+
+		auto const standard = time_map<std::unordered_map<uint64_t, uint64_t>>(keys, absent);
+		auto const flat		= time_map<FlatHashMap<uint64_t, uint64_t>>(keys, absent);
+
+		report_comparison("insert", standard.insert, flat.insert);
+		report_comparison("find, present", standard.find_hit, flat.find_hit);
+		report_comparison("find, absent", standard.find_miss, flat.find_miss);
+		report_comparison("erase", standard.erase, flat.erase);
+	}
+}
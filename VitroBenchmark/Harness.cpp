@@ -0,0 +1,57 @@
+module;
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+export module vttool.Benchmark.Harness;
+
+namespace vt::tool
+{
+	// Each measurement repeats its run for at least this long, so that short runs aren't dominated by timer resolution.
+	constexpr inline std::chrono::milliseconds MIN_DURATION(200);
+	constexpr inline int					   MIN_RUNS = 5;
+
+	// Stores the address of a result where the optimizer cannot see it being read, so the work producing it isn't removed.
+	export void keep(void const* result)
+	{
+		static void const* volatile sink;
+		sink = result;
+	}
+
+	// Runs the function repeatedly and returns the fastest time per item in nanoseconds, which is the run least disturbed
+	// by other processes.
+	export template<typename F> double measure(size_t item_count, F&& run)
+	{
+		using namespace std::chrono;
+
+		double	   best		= std::numeric_limits<double>::infinity();
+		auto const deadline = steady_clock::now() + MIN_DURATION;
+		for(int runs = 0; runs < MIN_RUNS || steady_clock::now() < deadline; ++runs)
+		{
+			auto const start = steady_clock::now();
+			run();
+			duration<double, std::nano> const elapsed = steady_clock::now() - start;
+
+			best = std::min(best, elapsed.count() / item_count);
+		}
+		return best;
+	}
+
+	export void print_section(std::string_view name)
+	{
+		std::printf("\n%.*s\n", static_cast<int>(name.size()), name.data());
+	}
+
+	export void report(std::string_view name, double nanoseconds)
+	{
+		std::printf("  %-52.*s %10.2f ns\n", static_cast<int>(name.size()), name.data(), nanoseconds);
+	}
+
+	// Reports both timings along with how many times faster the optimized version is than the baseline.
+	export void report_comparison(std::string_view name, double baseline, double optimized)
+	{
+		std::printf("  %-52.*s %10.2f ns -> %10.2f ns (%.2fx)\n", static_cast<int>(name.size()), name.data(), baseline,
+					optimized, baseline / optimized);
+	}
+}
@@ -0,0 +1,35 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+import vt.Core.JobSystem;
+import vttool.Benchmark.AffineTransform;
+import vttool.Benchmark.BoundingVolumeHierarchy;
+import vttool.Benchmark.Culling;
+import vttool.Benchmark.FlatHashMap;
+import vttool.Benchmark.Vector;
+
+// Runs the benchmarks named on the command line, or all of them if none are named.
+int main(int argc, char* argv[])
+{
+	std::vector<std::string_view> args(argv + 1, argv + argc);
+
+	vt::JobSystem job_system; // Large hierarchies are built through jobs.
+
+	auto is_selected = [&](std::string_view name) {
+		return args.empty() || std::find(args.begin(), args.end(), name) != args.end();
+	};
+	if(is_selected("vector"))
+		vt::tool::run_vector_benchmarks();
+	if(is_selected("affine"))
+		vt::tool::run_affine_transform_benchmarks();
+	if(is_selected("culling"))
+		vt::tool::run_culling_benchmarks();
+	if(is_selected("bvh"))
+		vt::tool::run_bounding_volume_hierarchy_benchmarks();
+	if(is_selected("hashmap"))
+		vt::tool::run_flat_hash_map_benchmarks();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+module;
+#include <vector>
+export module vttool.Benchmark.Vector;
+
+import vt.Core.Matrix;
+import vt.Core.Vector;
+import vttool.Benchmark.Harness;
+
+namespace vt::tool
+{
+	constexpr inline size_t VECTOR_COUNT = 1 << 16;
+
+	// The baselines index components one at a time, which is what every operator did before dispatching to SIMD.
+	template<int D> void add_components(std::vector<Vector<float, D>>& dst, std::vector<Vector<float, D>> const& src)
+	{
+		for(size_t i = 0; i != dst.size(); ++i)
+			for(int d = 0; d != D; ++d)
+				dst[i][d] += src[i][d];
+	}
+
+	template<int D> void scale_components(std::vector<Vector<float, D>>& dst, float scalar)
+	{
+		for(auto& vec : dst)
+			for(int d = 0; d != D; ++d)
+				vec[d] *= scalar;
+	}
+
+	Float4x4 multiply_components(Float4x4 const& left, Float4x4 const& right)
+	{
+		Float4x4 product {};
+		for(int r = 0; r != 4; ++r)
+			for(int c = 0; c != 4; ++c)
+				for(int i = 0; i != 4; ++i)
+					product.rows[r][c] += left.rows[r][i] * right.rows[i][c];
+		return product;
+	}
+
+	template<int D> Vector<float, D> fill(float value)
+	{
+		Vector<float, D> vec;
+		for(int d = 0; d != D; ++d)
+			vec[d] = value;
+		return vec;
+	}
+
+	template<int D> void compare_vector_operators()
+	{
+		std::vector<Vector<float, D>> dst(VECTOR_COUNT, fill<D>(1.0f));
+		std::vector<Vector<float, D>> src(VECTOR_COUNT, fill<D>(0.5f));
+
+		auto scalar = measure(VECTOR_COUNT, [&] {
+			add_components(dst, src);
+			keep(dst.data());
+		});
+		auto simd = measure(VECTOR_COUNT, [&] {
+			for(size_t i = 0; i != VECTOR_COUNT; ++i)
+				dst[i] += src[i];
+			keep(dst.data());
+		});
+		report_comparison(D == 4 ? "Float4 += Float4" : "Float3 += Float3", scalar, simd);
+
+		scalar = measure(VECTOR_COUNT, [&] {
+			scale_components(dst, 0.999f);
+			keep(dst.data());
+		});
+		simd = measure(VECTOR_COUNT, [&] {
+			for(auto& vec : dst)
+				vec *= 0.999f;
+			keep(dst.data());
+		});
+		report_comparison(D == 4 ? "Float4 *= float" : "Float3 *= float", scalar, simd);
+	}
+
+	export void run_vector_benchmarks()
+	{
+		print_section("Vector and matrix operators, per operation (scalar baseline -> operator)");
+
+		compare_vector_operators<3>();
+		compare_vector_operators<4>();
+
+		std::vector<Float4x4> matrices(VECTOR_COUNT / 16, Float4x4 {{{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 1, 2, 3}, {4, 5, 6, 7}}});
+		Float4x4 const		  transform {{{0, 1, 0, 0}, {1, 0, 0, 0}, {0, 0, 1, 0}, {0.1f, 0.2f, 0.3f, 1}}};
+
+		auto scalar = measure(matrices.size(), [&] {
+			for(auto& mat : matrices)
+				mat = multiply_components(mat, transform);
+			keep(matrices.data());
+		});
+		auto simd = measure(matrices.size(), [&] {
+			for(auto& mat : matrices)
+				mat *= transform;
+			keep(matrices.data());
+		});
+		report_comparison("Float4x4 *= Float4x4", scalar, simd);
+	}
+}
@@ -0,0 +1,207 @@
+module;
+#include <format>
+#include <string>
+export module vt.Core.AffineTransform;
+
+import vt.Core.Matrix;
+import vt.Core.Quaternion;
+import vt.Core.Vector;
+
+namespace vt
+{
+	// Affine transform stored as the first three columns of the equivalent Float4x4, whose fourth column is always
+	// (0, 0, 0, 1). Each stored column yields one component of a transformed point as a single 4D dot product, and products
+	// skip the constant column, which saves 28 of the 64 multiply-adds of a Float4x4 product.
+	export struct AffineTransform
+	{
+		Float4 columns[3];
+
+		static constexpr AffineTransform identity() noexcept
+		{
+			return {{
+				{1, 0, 0, 0},
+				{0, 1, 0, 0},
+				{0, 0, 1, 0},
+			}};
+		}
+
+		static constexpr AffineTransform from_translation(Float3 translation) noexcept
+		{
+			return {{
+				{1, 0, 0, translation.x},
+				{0, 1, 0, translation.y},
+				{0, 0, 1, translation.z},
+			}};
+		}
+
+		static constexpr AffineTransform from_scale(Float3 scale) noexcept
+		{
+			return {{
+				{scale.x, 0, 0, 0},
+				{0, scale.y, 0, 0},
+				{0, 0, scale.z, 0},
+			}};
+		}
+
+		static constexpr AffineTransform from_rotation(Quaternion const& rotation) noexcept
+		{
+			return from_linear(to_matrix3(rotation));
+		}
+
+		// Composes scale, then rotation, then translation.
+		static constexpr AffineTransform from_components(Float3 translation, Quaternion const& rotation, Float3 scale) noexcept
+		{
+			auto const rot = to_matrix3(rotation);
+			return from_linear({rot.rows[0] * scale.x, rot.rows[1] * scale.y, rot.rows[2] * scale.z}, translation);
+		}
+
+		static constexpr AffineTransform from_linear(Float3x3 const& linear, Float3 translation = {}) noexcept
+		{
+			auto& l = linear.rows;
+			return {{
+				{l[0].x, l[1].x, l[2].x, translation.x},
+				{l[0].y, l[1].y, l[2].y, translation.y},
+				{l[0].z, l[1].z, l[2].z, translation.z},
+			}};
+		}
+
+		// Discards the fourth column, which must be (0, 0, 0, 1) for the result to be equivalent.
+		static constexpr AffineTransform from_matrix(Float4x4 const& mat) noexcept
+		{
+			auto& m = mat.rows;
+			return {{
+				{m[0].x, m[1].x, m[2].x, m[3].x},
+				{m[0].y, m[1].y, m[2].y, m[3].y},
+				{m[0].z, m[1].z, m[2].z, m[3].z},
+			}};
+		}
+
+		constexpr Float4x4 to_matrix() const noexcept
+		{
+			auto& [x, y, z] = columns;
+			return {{
+				{x.x, y.x, z.x, 0},
+				{x.y, y.y, z.y, 0},
+				{x.z, y.z, z.z, 0},
+				{x.w, y.w, z.w, 1},
+			}};
+		}
+
+		constexpr Float3x3 linear() const noexcept
+		{
+			auto& [x, y, z] = columns;
+			return {{
+				{x.x, y.x, z.x},
+				{x.y, y.y, z.y},
+				{x.z, y.z, z.z},
+			}};
+		}
+
+		constexpr Float3 translation() const noexcept
+		{
+			return {columns[0].w, columns[1].w, columns[2].w};
+		}
+
+		std::string to_string() const
+		{
+			return to_matrix().to_string();
+		}
+
+		constexpr bool operator==(AffineTransform const& that) const noexcept
+		{
+			return columns[0] == that.columns[0] && columns[1] == that.columns[1] && columns[2] == that.columns[2];
+		}
+
+		constexpr bool operator!=(AffineTransform const& that) const noexcept
+		{
+			return !operator==(that);
+		}
+
+		// Like with Float4x4, the result applies this transform first and then the other one.
+		constexpr AffineTransform operator*(AffineTransform const& that) const noexcept
+		{
+			AffineTransform product;
+			for(int c = 0; c != 3; ++c)
+			{
+				auto const& col = that.columns[c];
+
+				product.columns[c] = columns[0] * col.x + columns[1] * col.y + columns[2] * col.z;
+				product.columns[c].w += col.w;
+			}
+			return product;
+		}
+
+		constexpr AffineTransform& operator*=(AffineTransform const& that) noexcept
+		{
+			return *this = *this * that;
+		}
+	};
+
+	// Transforms a position, treating it as having a w component of 1.
+	export constexpr Float3 transform_point(AffineTransform const& transform, Float3 point) noexcept
+	{
+		Float4 const extended {point.x, point.y, point.z, 1};
+		return {dot(extended, transform.columns[0]), dot(extended, transform.columns[1]), dot(extended, transform.columns[2])};
+	}
+
+	// Transforms a direction, treating it as having a w component of 0.
+	export constexpr Float3 transform_direction(AffineTransform const& transform, Float3 direction) noexcept
+	{
+		Float4 const extended {direction.x, direction.y, direction.z, 0};
+		return {dot(extended, transform.columns[0]), dot(extended, transform.columns[1]), dot(extended, transform.columns[2])};
+	}
+
+	// Rows of the inverse transpose of the linear part, i.e. the cofactors divided by the determinant.
+	constexpr Float3x3 inverse_transpose_linear(AffineTransform const& transform) noexcept
+	{
+		auto const [a, b, c] = transform.linear().rows;
+
+		auto const bc = cross(b, c);
+		auto const ca = cross(c, a);
+		auto const ab = cross(a, b);
+
+		float const inv_det = 1.0f / dot(a, bc);
+		return {bc * inv_det, ca * inv_det, ab * inv_det};
+	}
+
+	// Closed-form inverse of any invertible affine transform.
+	export constexpr AffineTransform inverse(AffineTransform const& transform) noexcept
+	{
+		auto const inv_t = inverse_transpose_linear(transform);
+		auto const t	 = transform.translation();
+
+		// The columns of the inverse linear part are the rows of its transpose.
+		AffineTransform inverted;
+		for(int c = 0; c != 3; ++c)
+		{
+			auto const& col = inv_t.rows[c];
+
+			inverted.columns[c] = {col.x, col.y, col.z, -dot(t, col)};
+		}
+		return inverted;
+	}
+
+	// Inverse of a transform that only rotates and translates, which is much cheaper than the general inverse.
+	export constexpr AffineTransform inverse_rigid(AffineTransform const& transform) noexcept
+	{
+		auto const linear = transform.linear();
+		auto const t	  = transform.translation();
+
+		// The inverse of the rotation is its transpose, so the columns of the inverse are the rows of the original.
+		AffineTransform inverted;
+		for(int c = 0; c != 3; ++c)
+		{
+			auto const& row = linear.rows[c];
+
+			inverted.columns[c] = {row.x, row.y, row.z, -dot(t, row)};
+		}
+		return inverted;
+	}
+
+	// Matrix for transforming normals, which stay perpendicular to surfaces under non-uniform scaling. The results should be
+	// renormalized.
+	export constexpr Float3x3 normal_matrix(AffineTransform const& transform) noexcept
+	{
+		return inverse_transpose_linear(transform);
+	}
+}
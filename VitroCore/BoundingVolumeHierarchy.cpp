@@ -0,0 +1,494 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+export module vt.Core.BoundingVolumeHierarchy;
+
+import vt.Core.Array;
+import vt.Core.JobSystem;
+import vt.Core.Vector;
+
+namespace vt
+{
+	export struct Aabb
+	{
+		Float3 min = {std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+					  std::numeric_limits<float>::infinity()};
+		Float3 max = {-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+					  -std::numeric_limits<float>::infinity()};
+
+		void expand(Float3 point) noexcept
+		{
+			min = {std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z)};
+			max = {std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z)};
+		}
+
+		void expand(Aabb const& that) noexcept
+		{
+			expand(that.min);
+			expand(that.max);
+		}
+
+		Float3 center() const noexcept
+		{
+			return (min + max) * 0.5f;
+		}
+
+		Float3 size() const noexcept
+		{
+			return max - min;
+		}
+
+		float surface_area() const noexcept
+		{
+			auto const s = size();
+			return 2 * (s.x * s.y + s.y * s.z + s.z * s.x);
+		}
+
+		bool overlaps(Aabb const& that) const noexcept
+		{
+			return min.x <= that.max.x && max.x >= that.min.x && min.y <= that.max.y && max.y >= that.min.y &&
+				   min.z <= that.max.z && max.z >= that.min.z;
+		}
+
+		// Tests against planes stored as (normal, distance) with normals pointing to the inside.
+		bool intersects(std::span<Float4 const> planes) const noexcept
+		{
+			for(auto& plane : planes)
+			{
+				// The corner furthest along the plane normal decides whether the box is entirely outside.
+				Float3 const corner {
+					plane.x >= 0 ? max.x : min.x,
+					plane.y >= 0 ? max.y : min.y,
+					plane.z >= 0 ? max.z : min.z,
+				};
+				if(plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0)
+					return false;
+			}
+			return true;
+		}
+	};
+
+	export struct Ray
+	{
+		Float3 origin;
+		Float3 direction;
+	};
+
+	export struct RayHit
+	{
+		unsigned primitive;
+		float	 distance;
+	};
+
+	// Hierarchy of axis-aligned bounding boxes over a set of primitives, identified by their index in the array the hierarchy
+	// was built from. Nodes are stored in depth-first order, so the left child of an interior node directly follows it.
+	export class BoundingVolumeHierarchy
+	{
+	public:
+		BoundingVolumeHierarchy() = default;
+
+		explicit BoundingVolumeHierarchy(std::span<Aabb const> primitives)
+		{
+			build(primitives);
+		}
+
+		// Rebuilds the hierarchy from scratch using the surface area heuristic. Large inputs are split into jobs, so the job
+		// system must exist.
+		void build(std::span<Aabb const> primitives)
+		{
+			primitive_bounds.assign(primitives.begin(), primitives.end());
+			primitive_indices.resize(primitives.size());
+			for(unsigned i = 0; i != primitive_indices.size(); ++i)
+				primitive_indices[i] = i;
+
+			nodes.clear();
+			if(!primitives.empty())
+				build_subtree(0, count(primitive_indices), nodes);
+		}
+
+		// Changes the bounds of a primitive. The hierarchy is only correct again after the next call to refit().
+		void update(unsigned primitive, Aabb const& bounds) noexcept
+		{
+			primitive_bounds[primitive] = bounds;
+		}
+
+		// Recomputes all node bounds bottom-up while keeping the topology. This is far cheaper than a rebuild, but the
+		// hierarchy degrades if primitives move far from where they were at build time.
+		void refit() noexcept
+		{
+			// Children always come after their parent, so walking backwards visits children first.
+			for(size_t index = nodes.size(); index-- != 0;)
+			{
+				auto& node = nodes[index];
+
+				Aabb bounds;
+				if(node.is_leaf())
+				{
+					for(unsigned i = node.offset; i != node.offset + node.count; ++i)
+						bounds.expand(primitive_bounds[primitive_indices[i]]);
+				}
+				else
+				{
+					bounds.expand(nodes[index + 1].bounds);
+					bounds.expand(nodes[node.offset].bounds);
+				}
+				node.bounds = bounds;
+			}
+		}
+
+		// Invokes the callback with every primitive whose bounds intersect all planes, which are stored as (normal, distance)
+		// with normals pointing to the inside.
+		void query_frustum(std::span<Float4 const> planes, auto callback) const
+		{
+			traverse(
+				[&](Aabb const& bounds) {
+					return bounds.intersects(planes);
+				},
+				callback);
+		}
+
+		// Invokes the callback with every primitive whose bounds overlap the given box.
+		void query_overlap(Aabb const& box, auto callback) const
+		{
+			traverse(
+				[&](Aabb const& bounds) {
+					return bounds.overlaps(box);
+				},
+				callback);
+		}
+
+		// Finds the closest primitive hit by the ray within the maximum distance, using only primitive bounds.
+		std::optional<RayHit> cast_ray(Ray const& ray, float max_distance = std::numeric_limits<float>::infinity()) const
+		{
+			return cast_ray(ray, max_distance, [](unsigned, Ray const&, float entry_distance) -> std::optional<float> {
+				return entry_distance;
+			});
+		}
+
+		// Finds the closest primitive hit by the ray within the maximum distance. The callback performs the exact intersection
+		// test and receives the primitive index, the ray and the distance at which the ray enters the primitive's bounds.
+		// It returns the distance of the hit, if any.
+		std::optional<RayHit> cast_ray(Ray const& ray, float max_distance, auto intersect) const
+		{
+			if(nodes.empty())
+				return {};
+
+			Float3 const inv_dir = 1.0f / ray.direction;
+
+			std::optional<RayHit> closest;
+
+			unsigned stack[STACK_SIZE];
+			unsigned stack_size = 0;
+			stack[stack_size++] = 0;
+			while(stack_size)
+			{
+				unsigned const index = stack[--stack_size];
+
+				auto& node = nodes[index];
+				if(!hit_distance(node.bounds, ray.origin, inv_dir, max_distance))
+					continue;
+
+				if(node.is_leaf())
+				{
+					for(unsigned i = node.offset; i != node.offset + node.count; ++i)
+					{
+						unsigned primitive = primitive_indices[i];
+
+						auto entry = hit_distance(primitive_bounds[primitive], ray.origin, inv_dir, max_distance);
+						if(!entry)
+							continue;
+
+						auto hit = intersect(primitive, ray, *entry);
+						if(hit && *hit <= max_distance)
+						{
+							max_distance = *hit;
+							closest		 = RayHit {primitive, *hit};
+						}
+					}
+					continue;
+				}
+
+				// Pushing the farther child first makes the nearer one be visited first, which shrinks the search distance
+				// early.
+				unsigned const left	 = index + 1;
+				unsigned const right = node.offset;
+
+				auto left_hit  = hit_distance(nodes[left].bounds, ray.origin, inv_dir, max_distance);
+				auto right_hit = hit_distance(nodes[right].bounds, ray.origin, inv_dir, max_distance);
+				if(left_hit && right_hit)
+				{
+					if(*left_hit <= *right_hit)
+					{
+						stack[stack_size++] = right;
+						stack[stack_size++] = left;
+					}
+					else
+					{
+						stack[stack_size++] = left;
+						stack[stack_size++] = right;
+					}
+				}
+				else if(left_hit)
+					stack[stack_size++] = left;
+				else if(right_hit)
+					stack[stack_size++] = right;
+			}
+			return closest;
+		}
+
+		Aabb const& get_bounds() const noexcept
+		{
+			static constexpr Aabb EMPTY;
+			return nodes.empty() ? EMPTY : nodes[0].bounds;
+		}
+
+		size_t node_count() const noexcept
+		{
+			return nodes.size();
+		}
+
+	private:
+		struct Node
+		{
+			Aabb	 bounds;
+			unsigned offset = 0; // First primitive for leaves, index of the right child for interior nodes.
+			unsigned count	= 0; // Number of primitives for leaves, zero for interior nodes.
+
+			bool is_leaf() const noexcept
+			{
+				return count != 0;
+			}
+		};
+
+		static constexpr unsigned BIN_COUNT			 = 16;
+		static constexpr unsigned MIN_SPLIT_SIZE	 = 5;  // Fewer primitives always form a leaf.
+		static constexpr unsigned MAX_LEAF_SIZE		 = 16; // More primitives are always split, even if a leaf would be cheaper.
+		static constexpr unsigned PARALLEL_THRESHOLD = 16384; // Subtrees with at least this many primitives split into jobs.
+		static constexpr unsigned MAX_DEPTH			 = 64;
+		static constexpr unsigned STACK_SIZE		 = MAX_DEPTH + 1; // At most one pending sibling per level, plus the root.
+		static constexpr float	  TRAVERSAL_COST	 = 1.0f; // Relative to the cost of intersecting one primitive.
+
+		std::vector<Node>	  nodes;
+		std::vector<unsigned> primitive_indices;
+		std::vector<Aabb>	  primitive_bounds;
+
+		// Appends the nodes of the subtree over the given range of primitive indices to the output in depth-first order.
+		void build_subtree(unsigned begin, unsigned end, std::vector<Node>& out, unsigned depth = 0)
+		{
+			unsigned const node_index = count(out);
+			out.emplace_back();
+
+			Aabb bounds, centroid_bounds;
+			for(unsigned i = begin; i != end; ++i)
+			{
+				auto& prim = primitive_bounds[primitive_indices[i]];
+				bounds.expand(prim);
+				centroid_bounds.expand(prim.center());
+			}
+			out[node_index].bounds = bounds;
+
+			unsigned mid = begin;
+			if(end - begin >= MIN_SPLIT_SIZE && depth + 1 < MAX_DEPTH)
+				mid = partition(begin, end, bounds, centroid_bounds);
+
+			if(mid == begin || mid == end)
+			{
+				out[node_index].offset = begin;
+				out[node_index].count  = end - begin;
+				return;
+			}
+
+			if(end - begin >= PARALLEL_THRESHOLD)
+			{
+				// The right subtree is built into its own array, which is appended afterwards with adjusted offsets.
+				std::vector<Node>  right_nodes;
+				std::exception_ptr right_error;
+				JobCounter		   right_build;
+				JobSystem::run(
+					[&] {
+						try
+						{
+							build_subtree(mid, end, right_nodes, depth + 1);
+						}
+						catch(...)
+						{
+							right_error = std::current_exception();
+						}
+					},
+					right_build);
+
+				// The job refers to locals of this call, so it must finish even if building the left subtree throws. Waiting
+				// runs other jobs, so a worker that reaches this point helps build instead of blocking.
+				try
+				{
+					build_subtree(begin, mid, out, depth + 1);
+				}
+				catch(...)
+				{
+					JobSystem::wait(right_build);
+					throw;
+				}
+				JobSystem::wait(right_build);
+				if(right_error)
+					std::rethrow_exception(right_error);
+
+				unsigned const right_index = count(out);
+				for(auto& node : right_nodes)
+					if(!node.is_leaf())
+						node.offset += right_index;
+
+				out.insert(out.end(), right_nodes.begin(), right_nodes.end());
+				out[node_index].offset = right_index;
+			}
+			else
+			{
+				build_subtree(begin, mid, out, depth + 1);
+				out[node_index].offset = count(out);
+				build_subtree(mid, end, out, depth + 1);
+			}
+		}
+
+		// Partitions the primitive indices with a binned surface area heuristic and returns the split position. Returns begin
+		// if keeping all primitives in a leaf is cheaper than any split.
+		unsigned partition(unsigned begin, unsigned end, Aabb const& bounds, Aabb const& centroid_bounds)
+		{
+			auto const extent = centroid_bounds.size();
+
+			int axis = 0;
+			if(extent.y > extent[axis])
+				axis = 1;
+			if(extent.z > extent[axis])
+				axis = 2;
+
+			float const axis_min	= centroid_bounds.min[axis];
+			float const axis_extent = extent[axis];
+			if(axis_extent <= 0) // All centroids coincide, so no plane can separate them; split in the middle instead.
+				return begin + (end - begin) / 2;
+
+			float const scale = BIN_COUNT / axis_extent;
+
+			auto bin_of = [&](unsigned primitive) {
+				auto bin = static_cast<unsigned>((primitive_bounds[primitive].center()[axis] - axis_min) * scale);
+				return std::min(bin, BIN_COUNT - 1);
+			};
+
+			struct Bin
+			{
+				Aabb	 bounds;
+				unsigned count = 0;
+			};
+			Bin bins[BIN_COUNT];
+			for(unsigned i = begin; i != end; ++i)
+			{
+				unsigned primitive = primitive_indices[i];
+
+				auto& bin = bins[bin_of(primitive)];
+				bin.bounds.expand(primitive_bounds[primitive]);
+				++bin.count;
+			}
+
+			// Sweeping from the right first allows evaluating every split plane with a single sweep from the left afterwards.
+			float	 right_areas[BIN_COUNT - 1];
+			unsigned right_counts[BIN_COUNT - 1];
+			Aabb	 right_bounds;
+			unsigned right_count = 0;
+			for(unsigned b = BIN_COUNT - 1; b != 0; --b)
+			{
+				right_bounds.expand(bins[b].bounds);
+				right_count += bins[b].count;
+				right_areas[b - 1]	= right_count ? right_bounds.surface_area() : 0;
+				right_counts[b - 1] = right_count;
+			}
+
+			float	 best_cost	= std::numeric_limits<float>::infinity();
+			unsigned best_split = 0;
+			Aabb	 left_bounds;
+			unsigned left_count = 0;
+			for(unsigned b = 0; b != BIN_COUNT - 1; ++b)
+			{
+				left_bounds.expand(bins[b].bounds);
+				left_count += bins[b].count;
+				if(left_count == 0 || right_counts[b] == 0)
+					continue;
+
+				float cost = left_count * left_bounds.surface_area() + right_counts[b] * right_areas[b];
+				if(cost < best_cost)
+				{
+					best_cost  = cost;
+					best_split = b;
+				}
+			}
+
+			float const leaf_cost  = static_cast<float>(end - begin);
+			float const split_cost = TRAVERSAL_COST + best_cost / bounds.surface_area();
+			if(end - begin <= MAX_LEAF_SIZE && leaf_cost <= split_cost)
+				return begin;
+
+			auto const mid = std::partition(primitive_indices.begin() + begin, primitive_indices.begin() + end,
+											[&](unsigned primitive) {
+												return bin_of(primitive) <= best_split;
+											});
+			return static_cast<unsigned>(mid - primitive_indices.begin());
+		}
+
+		void traverse(auto node_test, auto callback) const
+		{
+			if(nodes.empty())
+				return;
+
+			unsigned stack[STACK_SIZE];
+			unsigned stack_size = 0;
+			stack[stack_size++] = 0;
+			while(stack_size)
+			{
+				unsigned const index = stack[--stack_size];
+
+				auto& node = nodes[index];
+				if(!node_test(node.bounds))
+					continue;
+
+				if(node.is_leaf())
+				{
+					for(unsigned i = node.offset; i != node.offset + node.count; ++i)
+					{
+						unsigned primitive = primitive_indices[i];
+						if(node_test(primitive_bounds[primitive]))
+							callback(primitive);
+					}
+				}
+				else
+				{
+					stack[stack_size++] = node.offset;
+					stack[stack_size++] = index + 1;
+				}
+			}
+		}
+
+		// Returns the distance at which the ray enters the box, if it does so within the maximum distance.
+		static std::optional<float> hit_distance(Aabb const& box, Float3 origin, Float3 inv_dir, float max_distance) noexcept
+		{
+			float t_min = 0;
+			float t_max = max_distance;
+			for(int axis = 0; axis != 3; ++axis)
+			{
+				float t0 = (box.min[axis] - origin[axis]) * inv_dir[axis];
+				float t1 = (box.max[axis] - origin[axis]) * inv_dir[axis];
+				if(t0 > t1)
+					std::swap(t0, t1);
+
+				t_min = std::max(t_min, t0);
+				t_max = std::min(t_max, t1);
+				if(t_min > t_max)
+					return {};
+			}
+			return t_min;
+		}
+	};
+}
@@ -0,0 +1,49 @@
+module;
+#include <cstdint>
+#include <type_traits>
+export module vt.Core.ContentHash;
+
+namespace vt
+{
+	// Incrementally hashes data with 64-bit FNV-1a to identify equal content, such as shader bytecode or specifications of
+	// GPU objects. Hash tables should keep using their own hash functions.
+	export class ContentHasher
+	{
+	public:
+		void add_bytes(void const* data, size_t size) noexcept
+		{
+			auto bytes = static_cast<unsigned char const*>(data);
+			for(size_t i = 0; i != size; ++i)
+			{
+				state ^= bytes[i];
+				state *= PRIME;
+			}
+		}
+
+		// Only scalars are accepted, because padding bytes in class types would make the hash unpredictable.
+		template<typename T>
+		requires std::is_scalar_v<T>
+		void add(T value) noexcept
+		{
+			add_bytes(&value, sizeof value);
+		}
+
+		uint64_t get() const noexcept
+		{
+			return state;
+		}
+
+	private:
+		static constexpr uint64_t OFFSET_BASIS = 0xcbf29ce484222325;
+		static constexpr uint64_t PRIME		   = 0x100000001b3;
+
+		uint64_t state = OFFSET_BASIS;
+	};
+
+	export uint64_t hash_content(void const* data, size_t size) noexcept
+	{
+		ContentHasher hasher;
+		hasher.add_bytes(data, size);
+		return hasher.get();
+	}
+}
@@ -1,31 +1,312 @@
 module;
+#include "VitroCore/Macros.hpp"
+
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <bitset>
-#include <climits>
-#include <string>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
 #include <type_traits>
 #include <utility>
-
-#define MAGIC_ENUM_USING_ALIAS_STRING_VIEW using string_view = std::string_view;
-#define MAGIC_ENUM_RANGE_MIN			   (INT16_MIN + 1)
-#define MAGIC_ENUM_RANGE_MAX			   (INT16_MAX - 1)
-#include <magic_enum/include/magic_enum.hpp>
 export module vt.Core.Enum;
 
 namespace vt
 {
-	export using magic_enum::enum_cast;
-	export using magic_enum::enum_count;
-	export using magic_enum::enum_name;
+	// Specialize this to change the range of numeric values that are reflected for an enum. Only constants within the range
+	// have names. The range is kept small by default, since every value in it costs one template instantiation.
+	export template<typename E> struct EnumRange
+	{
+		static constexpr int MIN = std::is_signed_v<std::underlying_type_t<E>> ? -128 : 0;
+		static constexpr int MAX = 255;
+	};
+
+	// The compiler spells out the value of V in the function signature, which is the name for named enum constants, or a cast
+	// expression otherwise.
+	template<auto V> consteval std::string_view get_value_signature()
+	{
+#if VT_COMPILER_MSVC
+		return __FUNCSIG__;
+#else
+		return __PRETTY_FUNCTION__;
+#endif
+	}
+
+	template<auto V> consteval std::string_view get_enum_constant_name()
+	{
+		auto const signature = get_value_signature<V>();
+#if VT_COMPILER_MSVC
+		size_t const end   = signature.rfind(">(void)");
+		size_t const begin = signature.rfind('<', end) + 1;
+#else
+		size_t const begin = signature.find("V = ") + 4;
+		size_t const end   = signature.find_first_of(";]", begin);
+#endif
+		auto const value = signature.substr(begin, end - begin);
+		if(value.find('(') != value.npos)
+			return {};
+
+		auto const name = value.substr(value.rfind(':') + 1);
+		if(name.empty() || !(name[0] == '_' || (name[0] >= 'A' && name[0] <= 'Z') || (name[0] >= 'a' && name[0] <= 'z')))
+			return {};
+
+		return name;
+	}
+
+	constexpr uint64_t hash_enum_name(std::string_view name) noexcept
+	{
+		uint64_t hash = 0xCBF29CE484222325;
+		for(char c : name)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 0x100000001B3;
+		}
+		return hash;
+	}
+
+	constexpr uint64_t displace_hash(uint64_t hash, uint32_t seed) noexcept
+	{
+		hash ^= seed * 0x9E3779B97F4A7C15;
+		hash ^= hash >> 32;
+		hash *= 0xD6E8FEB86659FD93;
+		return hash ^ (hash >> 32);
+	}
+
+	// Compile-time reflection data of an enum. Names are stored back to back with null terminators and are indexed densely
+	// by numeric value, so looking up a name is a bounds check and two loads.
+	template<typename E>
+	requires std::is_enum_v<E>
+	struct EnumInfo
+	{
+		using Underlying = std::underlying_type_t<E>;
+
+		static constexpr int MIN = std::max<int>(EnumRange<E>::MIN, std::numeric_limits<Underlying>::lowest());
+		static constexpr int MAX = std::min<long long>(EnumRange<E>::MAX, std::numeric_limits<Underlying>::max());
+
+		static constexpr size_t RANGE = MAX - MIN + 1;
+
+		static consteval std::array<std::string_view, RANGE> get_names_in_range()
+		{
+			return []<size_t... INDICES>(std::index_sequence<INDICES...>) {
+				return std::array<std::string_view, RANGE> {
+					get_enum_constant_name<static_cast<E>(MIN + static_cast<int>(INDICES))>()...};
+			}(std::make_index_sequence<RANGE>());
+		}
+
+		static constexpr size_t COUNT = [] {
+			size_t count = 0;
+			for(auto name : get_names_in_range())
+				count += !name.empty();
+			return count;
+		}();
+
+		static constexpr size_t CHAR_COUNT = [] {
+			size_t count = 1; // The first character is the terminator of the empty name given to unnamed values.
+			for(auto name : get_names_in_range())
+				if(!name.empty())
+					count += name.size() + 1;
+			return count;
+		}();
+
+		static constexpr auto CHARS = [] {
+			std::array<char, CHAR_COUNT> chars {};
+
+			size_t offset = 1;
+			for(auto name : get_names_in_range())
+				if(!name.empty())
+				{
+					std::copy(name.begin(), name.end(), chars.begin() + offset);
+					offset += name.size() + 1;
+				}
+			return chars;
+		}();
+
+		struct NameLocation
+		{
+			uint32_t offset = 0;
+			uint32_t length = 0;
+		};
+		static constexpr auto NAME_LOCATIONS = [] {
+			std::array<NameLocation, RANGE> locations {};
+
+			uint32_t offset = 1;
+			auto	 names	= get_names_in_range();
+			for(size_t i = 0; i != RANGE; ++i)
+				if(!names[i].empty())
+				{
+					locations[i] = {offset, static_cast<uint32_t>(names[i].size())};
+					offset += static_cast<uint32_t>(names[i].size()) + 1;
+				}
+			return locations;
+		}();
+
+		static constexpr auto VALUES = [] {
+			std::array<E, COUNT> values {};
+
+			size_t count = 0;
+			auto   names = get_names_in_range();
+			for(size_t i = 0; i != RANGE; ++i)
+				if(!names[i].empty())
+					values[count++] = static_cast<E>(MIN + static_cast<int>(i));
+			return values;
+		}();
+
+		static constexpr std::string_view get_name(size_t index) noexcept
+		{
+			auto location = NAME_LOCATIONS[index];
+			return {CHARS.data() + location.offset, location.length};
+		}
+	};
+
+	// Minimal perfect hash from enum constant names to values, built with the hash-and-displace method: names are grouped
+	// into buckets by hash, and each bucket gets a seed that moves all of its names into free slots of the table.
+	template<typename E> struct EnumNameHash
+	{
+		using Info = EnumInfo<E>;
+
+		static constexpr size_t SLOT_COUNT	 = std::bit_ceil(std::max<size_t>(Info::COUNT, 1)) * 2;
+		static constexpr size_t BUCKET_COUNT = std::bit_ceil(std::max<size_t>(Info::COUNT / 2, 1));
+
+		struct Table
+		{
+			std::array<uint16_t, BUCKET_COUNT> seeds {};
+			std::array<uint16_t, SLOT_COUNT>   slots {}; // One plus the index into the enum values, or zero if empty.
+		};
+
+		static consteval Table make_table()
+		{
+			std::array<uint64_t, Info::COUNT> hashes {};
+			for(size_t i = 0; i != Info::COUNT; ++i)
+			{
+				auto const index = static_cast<size_t>(std::to_underlying(Info::VALUES[i]) - Info::MIN);
+				hashes[i]		 = hash_enum_name(Info::get_name(index));
+			}
+
+			std::array<size_t, BUCKET_COUNT> bucket_sizes {};
+			for(auto hash : hashes)
+				++bucket_sizes[hash & (BUCKET_COUNT - 1)];
+
+			// Placing large buckets first makes it likely to find seeds quickly.
+			std::array<size_t, BUCKET_COUNT> bucket_order {};
+			for(size_t i = 0; i != BUCKET_COUNT; ++i)
+				bucket_order[i] = i;
+			std::sort(bucket_order.begin(), bucket_order.end(), [&](size_t left, size_t right) {
+				return bucket_sizes[left] != bucket_sizes[right] ? bucket_sizes[left] > bucket_sizes[right] : left < right;
+			});
+
+			// Tries to move all names of the bucket into free slots with the given seed.
+			auto try_place = [&](Table& table, size_t bucket, uint16_t seed) {
+				auto slots = table.slots;
+				for(size_t i = 0; i != Info::COUNT; ++i)
+				{
+					if((hashes[i] & (BUCKET_COUNT - 1)) != bucket)
+						continue;
+
+					auto& slot = slots[displace_hash(hashes[i], seed) & (SLOT_COUNT - 1)];
+					if(slot != 0)
+						return false;
+
+					slot = static_cast<uint16_t>(i + 1);
+				}
+				table.seeds[bucket] = seed;
+				table.slots			= slots;
+				return true;
+			};
+
+			Table table;
+			for(size_t bucket : bucket_order)
+			{
+				uint16_t seed = 0;
+				while(bucket_sizes[bucket] != 0 && !try_place(table, bucket, seed))
+					if(++seed == UINT16_MAX) // Seeds are stored as 16 bits, so give up before they would wrap around.
+						throw "Failed to find a perfect hash for the names of this enum.";
+			}
+			return table;
+		}
+
+		static constexpr Table TABLE = make_table();
+	};
+
+	// Returns the name of the enum constant, or an empty string if the value is unnamed or outside the reflected range. The
+	// returned string is null-terminated.
+	export template<typename E>
+	requires std::is_enum_v<E>
+	constexpr std::string_view enum_name(E value) noexcept
+	{
+		using Info = EnumInfo<E>;
+
+		auto const index = static_cast<long long>(std::to_underlying(value)) - Info::MIN;
+		if(index < 0 || index >= static_cast<long long>(Info::RANGE))
+			return {};
+
+		return Info::get_name(static_cast<size_t>(index));
+	}
+
+	// Returns the enum constant with the given name, if there is one.
+	export template<typename E>
+	requires std::is_enum_v<E>
+	constexpr std::optional<E> enum_cast(std::string_view name) noexcept
+	{
+		using Info = EnumInfo<E>;
+		using Hash = EnumNameHash<E>;
+
+		if constexpr(Info::COUNT == 0)
+			return std::nullopt;
+		else
+		{
+			uint64_t const hash = hash_enum_name(name);
+			uint16_t const seed = Hash::TABLE.seeds[hash & (Hash::BUCKET_COUNT - 1)];
+			uint16_t const slot = Hash::TABLE.slots[displace_hash(hash, seed) & (Hash::SLOT_COUNT - 1)];
+			if(slot == 0)
+				return std::nullopt;
+
+			E const value = Info::VALUES[slot - 1];
+			if(enum_name(value) != name)
+				return std::nullopt;
+
+			return value;
+		}
+	}
+
+	// Returns the enum constant with the given numeric value, if it is named.
+	export template<typename E>
+	requires std::is_enum_v<E>
+	constexpr std::optional<E> enum_cast(std::underlying_type_t<E> number) noexcept
+	{
+		E const value = static_cast<E>(number);
+		if(enum_name(value).empty())
+			return std::nullopt;
+
+		return value;
+	}
+
+	export template<typename E>
+	requires std::is_enum_v<E>
+	constexpr size_t enum_count() noexcept
+	{
+		return EnumInfo<E>::COUNT;
+	}
+
+	// Returns all named values of the enum in ascending order.
+	export template<typename E>
+	requires std::is_enum_v<E>
+	constexpr auto const& enum_values() noexcept
+	{
+		return EnumInfo<E>::VALUES;
+	}
 
+	// Returns one past the largest named value of the enum, or zero if it has no named values.
 	export template<typename T>
 	requires std::is_enum_v<T>
 	constexpr size_t size_from_enum_max()
 	{
-		auto values = magic_enum::enum_values<T>();
-		auto max	= std::max_element(values.begin(), values.end());
-		return static_cast<size_t>(*max) + 1;
+		if constexpr(enum_count<T>() == 0)
+			return 0;
+		else
+			return static_cast<size_t>(enum_values<T>().back()) + 1;
 	}
 
 	// A bit array big enough for the enum T, so that you can set a bit for each numeric value of an enum constant.
@@ -98,8 +379,7 @@ namespace vt
 	requires std::is_enum_v<T>
 	consteval size_t min_bit_field_size()
 	{
-		auto values = magic_enum::enum_values<T>();
-		auto max	= *std::max_element(values.begin(), values.end());
+		auto max = std::to_underlying(enum_values<T>().back());
 		if(max == 0)
 			return 1;
 
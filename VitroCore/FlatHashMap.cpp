@@ -0,0 +1,611 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if VT_SIMD_SSE
+	#include <immintrin.h>
+#elif VT_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+export module vt.Core.FlatHashMap;
+
+namespace vt
+{
+	// Control bytes describe the state of each slot. Full slots store the lower 7 bits of the hash, so most mismatching keys
+	// are rejected without touching the slots.
+	constexpr int8_t EMPTY_SLOT	  = -128;
+	constexpr int8_t DELETED_SLOT = -2;
+
+	constexpr size_t GROUP_WIDTH = 16;
+
+	// Positions of the matching control bytes within a group.
+	class GroupMask
+	{
+	public:
+#if VT_SIMD_NEON
+		static constexpr int SHIFT = 2; // NEON masks have four bits per byte, of which only the highest is kept.
+#else
+		static constexpr int SHIFT = 0;
+#endif
+
+		explicit GroupMask(uint64_t bits) noexcept : bits(bits)
+		{}
+
+		explicit operator bool() const noexcept
+		{
+			return bits != 0;
+		}
+
+		size_t lowest() const noexcept
+		{
+			return static_cast<size_t>(std::countr_zero(bits)) >> SHIFT;
+		}
+
+		void remove_lowest() noexcept
+		{
+			bits &= bits - 1;
+		}
+
+	private:
+		uint64_t bits;
+	};
+
+	// Compares a group of control bytes against a value at once.
+	class Group
+	{
+	public:
+		explicit Group(int8_t const* ctrl) noexcept
+		{
+#if VT_SIMD_SSE
+			bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ctrl));
+#elif VT_SIMD_NEON
+			bytes = vld1q_s8(ctrl);
+#else
+			std::memcpy(bytes, ctrl, GROUP_WIDTH);
+#endif
+		}
+
+		GroupMask match(int8_t value) const noexcept
+		{
+#if VT_SIMD_SSE
+			return GroupMask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value)))));
+#elif VT_SIMD_NEON
+			return to_mask(vceqq_s8(bytes, vdupq_n_s8(value)));
+#else
+			uint64_t bits = 0;
+			for(size_t i = 0; i != GROUP_WIDTH; ++i)
+				bits |= static_cast<uint64_t>(bytes[i] == value) << i;
+			return GroupMask(bits);
+#endif
+		}
+
+		GroupMask match_empty() const noexcept
+		{
+			return match(EMPTY_SLOT);
+		}
+
+		// Empty and deleted are the only states below -1.
+		GroupMask match_empty_or_deleted() const noexcept
+		{
+#if VT_SIMD_SSE
+			return GroupMask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), bytes))));
+#elif VT_SIMD_NEON
+			return to_mask(vcltq_s8(bytes, vdupq_n_s8(-1)));
+#else
+			uint64_t bits = 0;
+			for(size_t i = 0; i != GROUP_WIDTH; ++i)
+				bits |= static_cast<uint64_t>(bytes[i] < -1) << i;
+			return GroupMask(bits);
+#endif
+		}
+
+	private:
+#if VT_SIMD_SSE
+		__m128i bytes;
+#elif VT_SIMD_NEON
+		int8x16_t bytes;
+
+		static GroupMask to_mask(uint8x16_t comparison) noexcept
+		{
+			uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(comparison), 4);
+			return GroupMask(vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888);
+		}
+#else
+		int8_t bytes[GROUP_WIDTH];
+#endif
+	};
+
+	// Standard hashes of pointers and integers are often the identity, so the bits are mixed before being split into the
+	// probe position and the control byte.
+	constexpr size_t mix_hash(size_t hash) noexcept
+	{
+		uint64_t h = hash;
+		h		   = (h ^ (h >> 32)) * 0x9E3779B97F4A7C15;
+		return static_cast<size_t>(h ^ (h >> 29));
+	}
+
+	// Open-addressing hash map in the style of a Swiss table. Slots are probed one group of control bytes at a time, using
+	// SIMD comparisons where available. When STABLE is true, elements are allocated individually, so that references to them
+	// stay valid through rehashing, like with std::unordered_map, at the cost of one indirection.
+	template<typename K, typename V, typename Hash, typename Equal, bool STABLE> class BasicFlatHashMap
+	{
+		template<bool CONST> class Iterator;
+
+	public:
+		using key_type		 = K;
+		using mapped_type	 = V;
+		using value_type	 = std::pair<K const, V>;
+		using size_type		 = size_t;
+		using hasher		 = Hash;
+		using key_equal		 = Equal;
+		using iterator		 = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		BasicFlatHashMap() = default;
+
+		BasicFlatHashMap(BasicFlatHashMap&& that) noexcept :
+			ctrl(std::exchange(that.ctrl, nullptr)),
+			slots(std::exchange(that.slots, nullptr)),
+			capacity(std::exchange(that.capacity, 0)),
+			count(std::exchange(that.count, 0)),
+			growth_left(std::exchange(that.growth_left, 0))
+		{}
+
+		~BasicFlatHashMap()
+		{
+			destroy_all();
+			deallocate();
+		}
+
+		BasicFlatHashMap& operator=(BasicFlatHashMap&& that) noexcept
+		{
+			if(this != &that)
+			{
+				destroy_all();
+				deallocate();
+				ctrl		= std::exchange(that.ctrl, nullptr);
+				slots		= std::exchange(that.slots, nullptr);
+				capacity	= std::exchange(that.capacity, 0);
+				count		= std::exchange(that.count, 0);
+				growth_left = std::exchange(that.growth_left, 0);
+			}
+			return *this;
+		}
+
+		template<typename... Ts> std::pair<iterator, bool> try_emplace(K const& key, Ts&&... args)
+		{
+			size_t const hash = mix_hash(Hash()(key));
+
+			size_t index = find_index(key, hash);
+			if(index != capacity)
+				return {iterator(this, index), false};
+
+			// The slot is only marked as full once the element exists, so that a throwing constructor leaves the map unchanged.
+			index = prepare_insert(hash);
+			construct_slot(index, std::piecewise_construct, std::forward_as_tuple(key),
+						   std::forward_as_tuple(std::forward<Ts>(args)...));
+			finish_insert(index, hash);
+			return {iterator(this, index), true};
+		}
+
+		template<typename M> std::pair<iterator, bool> insert_or_assign(K const& key, M&& value)
+		{
+			auto result = try_emplace(key, std::forward<M>(value));
+			if(!result.second)
+				result.first->second = std::forward<M>(value);
+			return result;
+		}
+
+		std::pair<iterator, bool> insert(value_type const& value)
+		{
+			return try_emplace(value.first, value.second);
+		}
+
+		std::pair<iterator, bool> insert(value_type&& value)
+		{
+			return try_emplace(value.first, std::move(value.second));
+		}
+
+		V& operator[](K const& key)
+		{
+			return try_emplace(key).first->second;
+		}
+
+		V& at(K const& key) noexcept
+		{
+			size_t const index = find_index(key);
+			VT_ASSERT(index != capacity, "Key not found.");
+			return get(index).second;
+		}
+
+		V const& at(K const& key) const noexcept
+		{
+			size_t const index = find_index(key);
+			VT_ASSERT(index != capacity, "Key not found.");
+			return get(index).second;
+		}
+
+		iterator find(K const& key) noexcept
+		{
+			return iterator(this, find_index(key));
+		}
+
+		const_iterator find(K const& key) const noexcept
+		{
+			return const_iterator(this, find_index(key));
+		}
+
+		bool contains(K const& key) const noexcept
+		{
+			return find_index(key) != capacity;
+		}
+
+		size_t erase(K const& key)
+		{
+			size_t const index = find_index(key);
+			if(index == capacity)
+				return 0;
+
+			erase_index(index);
+			return 1;
+		}
+
+		iterator erase(const_iterator position)
+		{
+			erase_index(position.index);
+			return iterator(this, next_full(position.index + 1));
+		}
+
+		// Changes the key of an element without moving or copying its value. Returns false if the old key is absent or the
+		// new key is already present.
+		bool replace_key(K const& old_key, K const& new_key) requires STABLE
+		{
+			if(!contains(old_key) || contains(new_key))
+				return false;
+
+			// Preparing the insertion may rehash, so it happens before the element is taken out of its old slot.
+			size_t const new_hash  = mix_hash(Hash()(new_key));
+			size_t const new_index = prepare_insert(new_hash);
+			size_t const old_index = find_index(old_key);
+
+			auto node = std::move(slots[old_index]);
+			std::destroy_at(slots + old_index);
+			set_ctrl(old_index, DELETED_SLOT);
+			--count;
+
+			// Keys are const within the element, so the key object is replaced rather than assigned to.
+			K* key = const_cast<K*>(&node->first);
+			std::destroy_at(key);
+			std::construct_at(key, new_key);
+
+			std::construct_at(slots + new_index, std::move(node));
+			finish_insert(new_index, new_hash);
+			return true;
+		}
+
+		void clear() noexcept
+		{
+			destroy_all();
+			if(capacity != 0)
+				std::memset(ctrl, EMPTY_SLOT, capacity + GROUP_WIDTH);
+			count		= 0;
+			growth_left = max_load(capacity);
+		}
+
+		void reserve(size_t element_count)
+		{
+			size_t new_capacity = GROUP_WIDTH;
+			while(max_load(new_capacity) < element_count)
+				new_capacity *= 2;
+
+			if(new_capacity > capacity)
+				rehash(new_capacity);
+		}
+
+		iterator begin() noexcept
+		{
+			return iterator(this, next_full(0));
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(this, next_full(0));
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(this, capacity);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(this, capacity);
+		}
+
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		bool empty() const noexcept
+		{
+			return count == 0;
+		}
+
+	private:
+		using Slot = std::conditional_t<STABLE, std::unique_ptr<value_type>, value_type>;
+
+		// The control bytes of the first group are mirrored past the end, so that groups can be loaded at every position
+		// without wrapping around.
+		int8_t* ctrl		= nullptr;
+		Slot*	slots		= nullptr;
+		size_t	capacity	= 0; // Always zero or a power of two no smaller than the group width.
+		size_t	count		= 0;
+		size_t	growth_left = 0; // Number of empty slots that may still be filled before rehashing.
+
+		template<bool CONST> class Iterator
+		{
+			using Map = std::conditional_t<CONST, BasicFlatHashMap const, BasicFlatHashMap>;
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type		= std::pair<K const, V>;
+			using difference_type	= ptrdiff_t;
+			using pointer			= std::conditional_t<CONST, value_type const*, value_type*>;
+			using reference			= std::conditional_t<CONST, value_type const&, value_type&>;
+
+			Iterator() = default;
+
+			template<bool OTHER>
+			Iterator(Iterator<OTHER> const& that) noexcept requires(CONST && !OTHER) : map(that.map), index(that.index)
+			{}
+
+			reference operator*() const noexcept
+			{
+				return map->get(index);
+			}
+
+			pointer operator->() const noexcept
+			{
+				return &map->get(index);
+			}
+
+			Iterator& operator++() noexcept
+			{
+				index = map->next_full(index + 1);
+				return *this;
+			}
+
+			Iterator operator++(int) noexcept
+			{
+				auto old = *this;
+				++*this;
+				return old;
+			}
+
+			bool operator==(Iterator const& that) const noexcept
+			{
+				return index == that.index;
+			}
+
+		private:
+			friend class BasicFlatHashMap;
+			template<bool> friend class Iterator;
+
+			Map*   map	 = nullptr;
+			size_t index = 0;
+
+			Iterator(Map* map, size_t index) noexcept : map(map), index(index)
+			{}
+		};
+
+		static constexpr size_t max_load(size_t slot_count) noexcept
+		{
+			return slot_count - slot_count / 8;
+		}
+
+		static int8_t get_ctrl_hash(size_t hash) noexcept
+		{
+			return static_cast<int8_t>(hash & 0x7F);
+		}
+
+		value_type& get(size_t index) const noexcept
+		{
+			if constexpr(STABLE)
+				return *slots[index];
+			else
+				return slots[index];
+		}
+
+		template<typename... Ts> void construct_slot(size_t index, Ts&&... args)
+		{
+			if constexpr(STABLE)
+				std::construct_at(slots + index, std::make_unique<value_type>(std::forward<Ts>(args)...));
+			else
+				std::construct_at(slots + index, std::forward<Ts>(args)...);
+		}
+
+		void set_ctrl(size_t index, int8_t value) noexcept
+		{
+			ctrl[index] = value;
+			if(index < GROUP_WIDTH)
+				ctrl[capacity + index] = value;
+		}
+
+		size_t next_full(size_t index) const noexcept
+		{
+			while(index < capacity && ctrl[index] < 0)
+				++index;
+			return std::min(index, capacity);
+		}
+
+		size_t find_index(K const& key) const noexcept
+		{
+			return find_index(key, mix_hash(Hash()(key)));
+		}
+
+		// Returns the capacity if the key is absent.
+		size_t find_index(K const& key, size_t hash) const noexcept
+		{
+			if(capacity == 0)
+				return capacity;
+
+			size_t const mask	= capacity - 1;
+			int8_t const h2		= get_ctrl_hash(hash);
+			size_t		 offset = (hash >> 7) & mask;
+			size_t		 step	= 0;
+			while(true)
+			{
+				Group group(ctrl + offset);
+				for(auto matches = group.match(h2); matches; matches.remove_lowest())
+				{
+					size_t const index = (offset + matches.lowest()) & mask;
+					if(Equal()(get(index).first, key))
+						return index;
+				}
+				if(group.match_empty())
+					return capacity;
+
+				step += GROUP_WIDTH; // Triangular probing visits every group, since the group count is a power of two.
+				offset = (offset + step) & mask;
+			}
+		}
+
+		size_t find_insert_index(size_t hash) const noexcept
+		{
+			size_t const mask	= capacity - 1;
+			size_t		 offset = (hash >> 7) & mask;
+			size_t		 step	= 0;
+			while(true)
+			{
+				auto free = Group(ctrl + offset).match_empty_or_deleted();
+				if(free)
+					return (offset + free.lowest()) & mask;
+
+				step += GROUP_WIDTH;
+				offset = (offset + step) & mask;
+			}
+		}
+
+		// Returns the index of a free slot for the hash, rehashing first if the table is too full. The slot stays free until
+		// finish_insert is called.
+		size_t prepare_insert(size_t hash)
+		{
+			size_t index = capacity == 0 ? 0 : find_insert_index(hash);
+			if(capacity == 0 || (growth_left == 0 && ctrl[index] == EMPTY_SLOT))
+			{
+				// Rehashing at the same capacity suffices if most of the used slots only hold deleted markers.
+				size_t new_capacity = GROUP_WIDTH;
+				if(capacity != 0)
+					new_capacity = count * 2 < max_load(capacity) ? capacity : capacity * 2;
+				rehash(new_capacity);
+				index = find_insert_index(hash);
+			}
+			return index;
+		}
+
+		// Marks the slot as full once its element is constructed.
+		void finish_insert(size_t index, size_t hash) noexcept
+		{
+			if(ctrl[index] == EMPTY_SLOT)
+				--growth_left;
+
+			set_ctrl(index, get_ctrl_hash(hash));
+			++count;
+		}
+
+		void erase_index(size_t index)
+		{
+			std::destroy_at(slots + index);
+			set_ctrl(index, DELETED_SLOT);
+			--count;
+		}
+
+		void rehash(size_t new_capacity)
+		{
+			// Both arrays are owned locally until the members take them over, so that neither leaks if the other can't be
+			// allocated and the map stays untouched.
+			std::unique_ptr<int8_t[]>				 new_ctrl(new int8_t[new_capacity + GROUP_WIDTH]);
+			std::unique_ptr<Slot[], SlotDeallocator> new_slots(std::allocator<Slot>().allocate(new_capacity),
+															   SlotDeallocator {new_capacity});
+			std::memset(new_ctrl.get(), EMPTY_SLOT, new_capacity + GROUP_WIDTH);
+
+			int8_t* const old_ctrl	   = std::exchange(ctrl, new_ctrl.release());
+			Slot* const	  old_slots	   = std::exchange(slots, new_slots.release());
+			size_t const  old_capacity = std::exchange(capacity, new_capacity);
+			growth_left				   = max_load(new_capacity) - count;
+
+			for(size_t i = 0; i != old_capacity; ++i)
+			{
+				if(old_ctrl[i] < 0)
+					continue;
+
+				size_t const hash  = mix_hash(Hash()(get_key(old_slots[i])));
+				size_t const index = find_insert_index(hash);
+				std::construct_at(slots + index, std::move(old_slots[i]));
+				set_ctrl(index, get_ctrl_hash(hash));
+				std::destroy_at(old_slots + i);
+			}
+
+			if(old_capacity != 0)
+			{
+				delete[] old_ctrl;
+				std::allocator<Slot>().deallocate(old_slots, old_capacity);
+			}
+		}
+
+		struct SlotDeallocator
+		{
+			size_t slot_count;
+
+			void operator()(Slot* slots) const noexcept
+			{
+				std::allocator<Slot>().deallocate(slots, slot_count);
+			}
+		};
+
+		static K const& get_key(Slot const& slot) noexcept
+		{
+			if constexpr(STABLE)
+				return slot->first;
+			else
+				return slot.first;
+		}
+
+		void destroy_all() noexcept
+		{
+			for(size_t i = 0; i != capacity; ++i)
+				if(ctrl[i] >= 0)
+					std::destroy_at(slots + i);
+		}
+
+		void deallocate() noexcept
+		{
+			if(capacity == 0)
+				return;
+
+			delete[] ctrl;
+			std::allocator<Slot>().deallocate(slots, capacity);
+			ctrl	 = nullptr;
+			slots	 = nullptr;
+			capacity = 0;
+		}
+	};
+
+	// Hash map with open addressing, meant for lookups on hot paths. Rehashing moves elements, which invalidates references.
+	export template<typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
+	using FlatHashMap = BasicFlatHashMap<K, V, Hash, Equal, false>;
+
+	// Same as FlatHashMap, but references to elements stay valid until they are erased, which allows for non-movable values.
+	export template<typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
+	using StableFlatHashMap = BasicFlatHashMap<K, V, Hash, Equal, true>;
+}
@@ -0,0 +1,184 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+export module vt.Core.FrameArena;
+
+namespace vt
+{
+	std::atomic<uint64_t> next_frame_arena_id = 1; // Zero marks empty thread-local cache entries.
+
+	// Linear allocator for memory that only needs to live for one frame. Every thread allocating from the arena bumps a pointer
+	// through its own chunks, so allocation needs no synchronization after a thread's first allocation. Deallocation does
+	// nothing; all memory is reclaimed at once by reset(). Memory is never returned to the system, and chunks that were
+	// needed in one frame are merged on reset, so steady-state frames do not allocate at all.
+	export class FrameArena : public std::pmr::memory_resource
+	{
+	public:
+		static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		explicit FrameArena(size_t chunk_size = DEFAULT_CHUNK_SIZE) : id(next_frame_arena_id++), chunk_size(chunk_size)
+		{}
+
+		FrameArena(FrameArena const&)			 = delete;
+		FrameArena& operator=(FrameArena const&) = delete;
+
+		// Invalidates all memory allocated from the arena. No thread may allocate from the arena during this call.
+		void reset()
+		{
+			std::lock_guard lock(mutex);
+
+			size_t frame_usage = 0;
+			for(auto& state : thread_states)
+			{
+				frame_usage += state.used_bytes;
+
+				if(state.chunks.size() > 1)
+				{
+					size_t total_size = 0;
+					for(auto& chunk : state.chunks)
+						total_size += chunk.size;
+
+					state.chunks.clear();
+					state.chunks.emplace_back(total_size);
+				}
+				state.chunk_index = 0;
+				state.offset	  = 0;
+				state.used_bytes  = 0;
+			}
+			last_frame_usage = frame_usage;
+			peak_usage		 = std::max(peak_usage, frame_usage);
+		}
+
+		// Bytes allocated across all threads between the last two resets.
+		size_t get_last_frame_usage() const noexcept
+		{
+			return last_frame_usage;
+		}
+
+		// Highest per-frame usage observed by any reset so far, useful for choosing the chunk size.
+		size_t get_peak_usage() const noexcept
+		{
+			return peak_usage;
+		}
+
+	private:
+		struct Chunk
+		{
+			std::unique_ptr<std::byte[]> memory;
+			size_t						 size;
+
+			Chunk(size_t size) : memory(std::make_unique_for_overwrite<std::byte[]>(size)), size(size)
+			{}
+		};
+
+		struct ThreadState
+		{
+			std::thread::id	   owner;
+			std::vector<Chunk> chunks;
+			size_t			   chunk_index = 0;
+			size_t			   offset	   = 0;
+			size_t			   used_bytes  = 0;
+
+			ThreadState(std::thread::id owner) : owner(owner)
+			{}
+		};
+
+		struct CachedState
+		{
+			uint64_t	 arena_id = 0;
+			ThreadState* state	  = nullptr;
+		};
+
+		static constexpr size_t THREAD_CACHE_SIZE = 4;
+
+		uint64_t				id; // Unique across all arenas ever created, so stale thread-local cache entries never match.
+		size_t					chunk_size;
+		std::mutex				mutex;
+		std::deque<ThreadState> thread_states; // Deque keeps states at stable addresses for the thread-local caches.
+		size_t					last_frame_usage = 0;
+		size_t					peak_usage		 = 0;
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			auto& state = get_thread_state();
+
+			while(state.chunk_index != state.chunks.size())
+			{
+				auto& chunk = state.chunks[state.chunk_index];
+
+				void*  ptr		 = chunk.memory.get() + state.offset;
+				size_t remaining = chunk.size - state.offset;
+				if(std::align(alignment, bytes, ptr, remaining))
+				{
+					size_t const new_offset = static_cast<std::byte*>(ptr) - chunk.memory.get() + bytes;
+					state.used_bytes += new_offset - state.offset;
+					state.offset = new_offset;
+					return ptr;
+				}
+				++state.chunk_index;
+				state.offset = 0;
+			}
+
+			// Chunk memory is only aligned to the default new alignment, so there must be room for adjusting the pointer.
+			auto& chunk = state.chunks.emplace_back(std::max(chunk_size, bytes + alignment));
+
+			void*  ptr		 = chunk.memory.get();
+			size_t remaining = chunk.size;
+			std::align(alignment, bytes, ptr, remaining);
+
+			state.offset = static_cast<std::byte*>(ptr) - chunk.memory.get() + bytes;
+			state.used_bytes += state.offset;
+			return ptr;
+		}
+
+		void do_deallocate(void*, size_t, size_t) override
+		{}
+
+		bool do_is_equal(std::pmr::memory_resource const& that) const noexcept override
+		{
+			return this == &that;
+		}
+
+		// Each thread caches its states for the arenas it used last. The cache has a fixed size, so entries are overwritten
+		// round-robin rather than accumulating for every arena the thread ever used. Entries of destroyed arenas dangle, but
+		// are never matched again, since arena IDs are not reused.
+		ThreadState& get_thread_state()
+		{
+			thread_local CachedState cache[THREAD_CACHE_SIZE];
+			thread_local size_t		 next_victim = 0;
+
+			for(auto cached : cache)
+				if(cached.arena_id == id)
+					return *cached.state;
+
+			auto& state		   = find_or_add_thread_state();
+			cache[next_victim] = {id, &state};
+			next_victim		   = (next_victim + 1) % THREAD_CACHE_SIZE;
+			return state;
+		}
+
+		// Looks up the state of the calling thread, which may have been evicted from its cache, or adds a new one.
+		ThreadState& find_or_add_thread_state()
+		{
+			auto const thread = std::this_thread::get_id();
+
+			std::lock_guard lock(mutex);
+			for(auto& state : thread_states)
+				if(state.owner == thread)
+					return state;
+
+			return thread_states.emplace_back(thread);
+		}
+	};
+}
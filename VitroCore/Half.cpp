@@ -0,0 +1,170 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <span>
+
+#if VT_SIMD_F16C
+	#include <immintrin.h>
+#endif
+export module vt.Core.Half;
+
+import vt.Core.Vector;
+
+namespace vt
+{
+	// Rounds to the nearest representable value, with ties to even. Values beyond the half range become infinity.
+	constexpr uint16_t float_to_half_bits(float value) noexcept
+	{
+		uint32_t const bits = std::bit_cast<uint32_t>(value);
+		uint32_t const sign = (bits >> 16) & 0x8000;
+		uint32_t const abs	= bits & 0x7FFFFFFF;
+
+		if(abs >= 0x7F800000) // Infinity or NaN, where NaNs stay quiet NaNs.
+			return static_cast<uint16_t>(sign | 0x7C00 | (abs > 0x7F800000 ? 0x200 : 0));
+
+		if(abs >= 0x477FF000) // Rounds to a value beyond the largest finite half.
+			return static_cast<uint16_t>(sign | 0x7C00);
+
+		if(abs < 0x38800000) // Result is subnormal or zero.
+		{
+			if(abs < 0x33000000) // Less than half of the smallest subnormal half.
+				return static_cast<uint16_t>(sign);
+
+			uint32_t const exponent = abs >> 23;
+			uint32_t const mantissa = (abs & 0x7FFFFF) | 0x800000;
+			uint32_t const shift	= 126 - exponent;
+
+			uint32_t half_mantissa = mantissa >> shift;
+			uint32_t remainder	   = mantissa & ((1u << shift) - 1);
+			uint32_t halfway	   = 1u << (shift - 1);
+			if(remainder > halfway || (remainder == halfway && (half_mantissa & 1)))
+				++half_mantissa;
+			return static_cast<uint16_t>(sign | half_mantissa);
+		}
+
+		uint32_t rebiased = abs - (112u << 23);
+		uint32_t rounded  = rebiased + 0xFFF + ((rebiased >> 13) & 1); // Round to nearest, ties to even.
+		return static_cast<uint16_t>(sign | (rounded >> 13));
+	}
+
+	constexpr float half_bits_to_float(uint16_t half) noexcept
+	{
+		uint32_t const sign		= static_cast<uint32_t>(half & 0x8000) << 16;
+		uint32_t const exponent = (half >> 10) & 0x1F;
+		uint32_t mantissa		= half & 0x3FF;
+
+		if(exponent == 0x1F) // Infinity or NaN.
+			return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+
+		if(exponent != 0)
+			return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+
+		if(mantissa == 0)
+			return std::bit_cast<float>(sign);
+
+		// Subnormal halves are normal floats, so the mantissa is shifted until its leading bit becomes implicit.
+		uint32_t float_exponent = 113;
+		while(!(mantissa & 0x400))
+		{
+			mantissa <<= 1;
+			--float_exponent;
+		}
+		return std::bit_cast<float>(sign | (float_exponent << 23) | ((mantissa & 0x3FF) << 13));
+	}
+
+	// IEEE 754 half-precision floating-point number, meant for storage only. Arithmetic happens after converting to float.
+	export struct Half
+	{
+		uint16_t bits;
+
+		Half() = default;
+
+		constexpr Half(float value) noexcept : bits(float_to_half_bits(value))
+		{}
+
+		static constexpr Half from_bits(uint16_t bits) noexcept
+		{
+			Half half;
+			half.bits = bits;
+			return half;
+		}
+
+		constexpr operator float() const noexcept
+		{
+			return half_bits_to_float(bits);
+		}
+
+		constexpr bool operator==(Half const&) const noexcept = default;
+	};
+
+	export using Half2 = Vector<Half, 2>;
+	export using Half4 = Vector<Half, 4>;
+
+	export Half4 to_half(Float4 vec) noexcept
+	{
+#if VT_SIMD_F16C
+		Half4 half;
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(&half), _mm_cvtps_ph(_mm_loadu_ps(&vec.x), _MM_FROUND_TO_NEAREST_INT));
+		return half;
+#else
+		return {vec.x, vec.y, vec.z, vec.w};
+#endif
+	}
+
+	export Half2 to_half(Float2 vec) noexcept
+	{
+		return {vec.x, vec.y};
+	}
+
+	export Float4 to_float(Half4 vec) noexcept
+	{
+#if VT_SIMD_F16C
+		Float4 result;
+		_mm_storeu_ps(&result.x, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(&vec))));
+		return result;
+#else
+		return {vec.x, vec.y, vec.z, vec.w};
+#endif
+	}
+
+	export Float2 to_float(Half2 vec) noexcept
+	{
+		return {vec.x, vec.y};
+	}
+
+	// Converts a range of floats to halves. The destination must hold at least as many elements as the source.
+	export void convert_to_half(std::span<Half> dst, std::span<float const> src) noexcept
+	{
+		VT_ASSERT(dst.size() >= src.size(), "Destination is too small.");
+
+		size_t i = 0;
+#if VT_SIMD_F16C
+		for(; i + 8 <= src.size(); i += 8)
+		{
+			__m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(&src[i]), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), halves);
+		}
+#endif
+		for(; i != src.size(); ++i)
+			dst[i] = src[i];
+	}
+
+	// Converts a range of halves to floats. The destination must hold at least as many elements as the source.
+	export void convert_to_float(std::span<float> dst, std::span<Half const> src) noexcept
+	{
+		VT_ASSERT(dst.size() >= src.size(), "Destination is too small.");
+
+		size_t i = 0;
+#if VT_SIMD_F16C
+		for(; i + 8 <= src.size(); i += 8)
+		{
+			__m128i halves = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&src[i]));
+			_mm256_storeu_ps(&dst[i], _mm256_cvtph_ps(halves));
+		}
+#endif
+		for(; i != src.size(); ++i)
+			dst[i] = src[i];
+	}
+}
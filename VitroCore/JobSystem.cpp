@@ -0,0 +1,448 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <concurrentqueue/concurrentqueue.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+export module vt.Core.JobSystem;
+
+import vt.Core.ConcurrentQueue;
+import vt.Core.Singleton;
+
+namespace vt
+{
+	export class JobCounter;
+
+	// Type-erased unit of work. Small callables are stored inline, larger ones on the heap.
+	struct Job
+	{
+		static constexpr size_t INLINE_SIZE = 48;
+
+		void (*invoke)(Job& job);
+		JobCounter* counter;
+		alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+
+		template<typename F> void assign(F&& func)
+		{
+			using Func = std::decay_t<F>;
+			if constexpr(sizeof(Func) <= INLINE_SIZE && alignof(Func) <= alignof(std::max_align_t))
+			{
+				std::construct_at(reinterpret_cast<Func*>(storage), std::forward<F>(func));
+				invoke = [](Job& job) {
+					auto& stored = *std::launder(reinterpret_cast<Func*>(job.storage));
+					stored();
+					std::destroy_at(&stored);
+				};
+			}
+			else
+			{
+				std::construct_at(reinterpret_cast<Func**>(storage), new Func(std::forward<F>(func)));
+				invoke = [](Job& job) {
+					std::unique_ptr<Func> stored(*std::launder(reinterpret_cast<Func**>(job.storage)));
+					(*stored)();
+				};
+			}
+		}
+	};
+
+	// Recycles finished jobs on the thread that ran them, so that steady-state job submission does not allocate.
+	class JobCache
+	{
+	public:
+		~JobCache()
+		{
+			for(Job* job : jobs)
+				delete job;
+		}
+
+		Job* acquire()
+		{
+			if(jobs.empty())
+				return new Job;
+
+			Job* job = jobs.back();
+			jobs.pop_back();
+			return job;
+		}
+
+		void release(Job* job)
+		{
+			if(jobs.size() < MAX_CACHED_JOBS)
+				jobs.push_back(job);
+			else
+				delete job;
+		}
+
+	private:
+		static constexpr size_t MAX_CACHED_JOBS = 1024;
+
+		std::vector<Job*> jobs;
+	};
+
+	thread_local JobCache job_cache;
+
+	// Chase-Lev work-stealing deque. The owning thread pushes and pops at the bottom, while any other thread may steal from
+	// the top. Arrays replaced by growing are kept until destruction, since thieves may still read from them.
+	class WorkStealingDeque
+	{
+	public:
+		WorkStealingDeque() : array(arrays.emplace_back(std::make_unique<Array>(INITIAL_CAPACITY)).get())
+		{}
+
+		// Only called by the owning thread.
+		void push(Job* job)
+		{
+			int64_t const bottom_index = bottom.load(std::memory_order_relaxed);
+			int64_t const top_index	   = top.load(std::memory_order_acquire);
+
+			Array* current = array.load(std::memory_order_relaxed);
+			if(bottom_index - top_index > current->capacity - 1)
+				current = grow(current, top_index, bottom_index);
+
+			current->put(bottom_index, job);
+			std::atomic_thread_fence(std::memory_order_release);
+			bottom.store(bottom_index + 1, std::memory_order_relaxed);
+		}
+
+		// Only called by the owning thread.
+		Job* pop()
+		{
+			int64_t const bottom_index = bottom.load(std::memory_order_relaxed) - 1;
+			Array*		  current	   = array.load(std::memory_order_relaxed);
+			bottom.store(bottom_index, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			int64_t top_index = top.load(std::memory_order_relaxed);
+			if(top_index > bottom_index)
+			{
+				bottom.store(bottom_index + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Job* job = current->get(bottom_index);
+			if(top_index == bottom_index) // Last element, which a thief might be taking concurrently.
+			{
+				if(!top.compare_exchange_strong(top_index, top_index + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					job = nullptr;
+
+				bottom.store(bottom_index + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		Job* steal()
+		{
+			int64_t top_index = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t const bottom_index = bottom.load(std::memory_order_acquire);
+			if(top_index >= bottom_index)
+				return nullptr;
+
+			Job* job = array.load(std::memory_order_acquire)->get(top_index);
+			if(!top.compare_exchange_strong(top_index, top_index + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return job;
+		}
+
+	private:
+		static constexpr int64_t INITIAL_CAPACITY = 256;
+
+		struct Array
+		{
+			int64_t							   capacity;
+			std::unique_ptr<std::atomic<Job*>[]> slots;
+
+			Array(int64_t capacity) : capacity(capacity), slots(new std::atomic<Job*>[capacity])
+			{}
+
+			Job* get(int64_t index) const noexcept
+			{
+				return slots[index & (capacity - 1)].load(std::memory_order_relaxed);
+			}
+
+			void put(int64_t index, Job* job) noexcept
+			{
+				slots[index & (capacity - 1)].store(job, std::memory_order_relaxed);
+			}
+		};
+
+		alignas(64) std::atomic<int64_t> top	= 0;
+		alignas(64) std::atomic<int64_t> bottom = 0;
+		std::vector<std::unique_ptr<Array>> arrays;
+		std::atomic<Array*>					array;
+
+		Array* grow(Array* current, int64_t top_index, int64_t bottom_index)
+		{
+			auto& grown = arrays.emplace_back(std::make_unique<Array>(current->capacity * 2));
+			for(int64_t i = top_index; i != bottom_index; ++i)
+				grown->put(i, current->get(i));
+
+			array.store(grown.get(), std::memory_order_release);
+			return grown.get();
+		}
+	};
+
+	// Tracks completion of a group of jobs. Waiting on a counter runs other jobs in the meantime, and jobs can be scheduled
+	// to start once a counter reaches zero. A counter may be reused once it is done.
+	export class JobCounter
+	{
+		friend class JobSystem;
+
+	public:
+		JobCounter() = default;
+
+		JobCounter(JobCounter const&)			 = delete;
+		JobCounter& operator=(JobCounter const&) = delete;
+
+		bool is_done() const noexcept
+		{
+			return pending.load() == 0 && finishing.load() == 0;
+		}
+
+	private:
+		std::atomic<unsigned> pending	= 0;
+		std::atomic<unsigned> finishing = 0; // Keeps waiters from destroying the counter while the last job still uses it.
+		std::mutex			  continuation_mutex;
+		std::vector<Job*>	  continuations;
+	};
+
+	thread_local unsigned current_worker_index = UINT32_MAX;
+
+	// Runs jobs on one worker thread per remaining hardware thread. Every worker owns a work-stealing deque for the jobs it
+	// submits itself, while jobs submitted from other threads go through a shared queue. Idle workers steal from each other.
+	export class JobSystem : public Singleton<JobSystem>
+	{
+	public:
+		JobSystem(unsigned worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1) : deques(worker_count)
+		{
+			workers.reserve(worker_count);
+			for(unsigned i = 0; i != worker_count; ++i)
+				workers.emplace_back(&JobSystem::run_worker, this, i);
+		}
+
+		~JobSystem()
+		{
+			is_running = false;
+			work_signal.fetch_add(1);
+			work_signal.notify_all();
+			for(auto& worker : workers)
+				worker.join();
+		}
+
+		// Schedules the function to run on some thread. The counter is considered done once the function returns.
+		template<typename F> static void run(F&& func, JobCounter& counter)
+		{
+			auto& self = get();
+			self.submit(self.make_job(std::forward<F>(func), &counter));
+		}
+
+		template<typename F> static void run(F&& func)
+		{
+			auto& self = get();
+			self.submit(self.make_job(std::forward<F>(func), nullptr));
+		}
+
+		// Schedules the function to run once the dependency is done. The counter is incremented immediately, so waiting on it
+		// also waits for the dependency.
+		template<typename F> static void run_after(JobCounter& dependency, F&& func, JobCounter& counter)
+		{
+			auto& self = get();
+			Job*  job  = self.make_job(std::forward<F>(func), &counter);
+			{
+				std::lock_guard lock(dependency.continuation_mutex);
+				if(dependency.pending.load() != 0)
+				{
+					dependency.continuations.push_back(job);
+					return;
+				}
+			}
+			self.submit(job);
+		}
+
+		// Runs other jobs on the calling thread until the counter is done.
+		static void wait(JobCounter const& counter)
+		{
+			auto& self = get();
+			while(!counter.is_done())
+				if(!self.try_run_job())
+					std::this_thread::yield();
+		}
+
+		// Calls the function for every index in the range, split into chunks that are run in parallel. The calling thread
+		// works on the chunks as well. A grain size of zero picks the chunk size so each thread gets a few chunks, which
+		// evens out chunks that take longer than others.
+		template<typename F> static void parallel_for(size_t begin, size_t end, F const& func, size_t grain_size = 0)
+		{
+			if(begin >= end)
+				return;
+
+			size_t const count = end - begin;
+			if(grain_size == 0)
+			{
+				size_t const thread_count = get().workers.size() + 1;
+				grain_size				  = std::max<size_t>(1, count / (thread_count * CHUNKS_PER_THREAD));
+			}
+
+			auto run_chunk = [&func](size_t chunk_begin, size_t chunk_end) {
+				for(size_t i = chunk_begin; i != chunk_end; ++i)
+					func(i);
+			};
+
+			JobCounter counter;
+			size_t	   chunk_begin = begin;
+			for(; end - chunk_begin > grain_size; chunk_begin += grain_size)
+				run([=] { run_chunk(chunk_begin, chunk_begin + grain_size); }, counter);
+
+			run_chunk(chunk_begin, end);
+			wait(counter);
+		}
+
+		static unsigned get_worker_count() noexcept
+		{
+			return static_cast<unsigned>(get().workers.size());
+		}
+
+	private:
+		static constexpr size_t	  CHUNKS_PER_THREAD = 4;
+		static constexpr unsigned IDLE_SPIN_COUNT	= 64;
+
+		std::vector<WorkStealingDeque> deques;
+		ConcurrentQueue<Job*>		   injected_jobs;
+		std::atomic<uint32_t>		   work_signal		= 0;
+		std::atomic<unsigned>		   sleeping_workers = 0;
+		std::atomic_bool			   is_running		= true;
+		std::vector<std::thread>	   workers; // Declared last, so workers start after everything else is initialized.
+
+		template<typename F> Job* make_job(F&& func, JobCounter* counter)
+		{
+			if(counter)
+				counter->pending.fetch_add(1);
+
+			Job* job	 = job_cache.acquire();
+			job->counter = counter;
+			job->assign(std::forward<F>(func));
+			return job;
+		}
+
+		void submit(Job* job)
+		{
+			if(current_worker_index < deques.size())
+				deques[current_worker_index].push(job);
+			else
+				injected_jobs.enqueue(job);
+
+			// Pairs with the fence in run_worker. Without it, the push may become visible only after the load, so that this
+			// thread sees no sleeping worker while the worker about to sleep sees no job.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(sleeping_workers.load() != 0)
+			{
+				work_signal.fetch_add(1);
+				work_signal.notify_one();
+			}
+		}
+
+		Job* find_job()
+		{
+			if(current_worker_index < deques.size())
+				if(Job* job = deques[current_worker_index].pop())
+					return job;
+
+			Job* job;
+			if(injected_jobs.try_dequeue(job))
+				return job;
+
+			// Steals starting at a pseudo-random victim, so that thieves don't all contend for the same deque.
+			thread_local uint32_t random_state = make_random_seed();
+			random_state ^= random_state << 13;
+			random_state ^= random_state >> 17;
+			random_state ^= random_state << 5;
+
+			size_t const deque_count = deques.size();
+			for(size_t i = 0; i != deque_count; ++i)
+			{
+				size_t const victim = (random_state + i) % deque_count;
+				if(victim != current_worker_index)
+					if(Job* stolen = deques[victim].steal())
+						return stolen;
+			}
+			return nullptr;
+		}
+
+		static uint32_t make_random_seed() noexcept
+		{
+			auto const hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+			return static_cast<uint32_t>(hash) | 1; // Xorshift requires a nonzero state.
+		}
+
+		bool try_run_job()
+		{
+			Job* job = find_job();
+			if(!job)
+				return false;
+
+			execute(job);
+			return true;
+		}
+
+		void execute(Job* job)
+		{
+			job->invoke(*job);
+
+			JobCounter* counter = job->counter;
+			job_cache.release(job);
+			if(!counter)
+				return;
+
+			std::vector<Job*> continuations;
+
+			counter->finishing.fetch_add(1);
+			if(counter->pending.fetch_sub(1) == 1)
+			{
+				std::lock_guard lock(counter->continuation_mutex);
+				continuations.swap(counter->continuations);
+			}
+			counter->finishing.fetch_sub(1); // Last access to the counter.
+
+			// Only submitted after the last access, since a continuation may destroy the counter.
+			for(Job* continuation : continuations)
+				submit(continuation);
+		}
+
+		void run_worker(unsigned index)
+		{
+			current_worker_index = index;
+			while(is_running)
+			{
+				if(try_run_job())
+					continue;
+
+				unsigned spins = 0;
+				while(spins != IDLE_SPIN_COUNT && is_running && !try_run_job())
+					++spins;
+
+				if(spins != IDLE_SPIN_COUNT)
+					continue;
+
+				// Announces sleeping before checking for work one last time, so that a concurrent submit is either seen here
+				// or changes the signal and wakes this worker.
+				uint32_t const signal = work_signal.load();
+				sleeping_workers.fetch_add(1);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if(!try_run_job() && is_running)
+					work_signal.wait(signal);
+				sleeping_workers.fetch_sub(1);
+			}
+		}
+	};
+}
@@ -35,6 +35,26 @@
 
 #endif
 
+#if defined(__AVX2__)
+	#define VT_SIMD_AVX2 1
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || _M_IX86_FP >= 2
+	#define VT_SIMD_SSE 1
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+	#define VT_SIMD_NEON 1
+#endif
+
+// Hardware half-precision conversion ships with every CPU that supports AVX2.
+#if defined(__F16C__) || (VT_COMPILER_MSVC && VT_SIMD_AVX2)
+	#define VT_SIMD_F16C 1
+#endif
+
+// Fused multiply-add changes rounding, so it is only used when strict floating-point semantics are not requested.
+#if !VT_STRICT_MATH && (defined(__FMA__) || (VT_COMPILER_MSVC && VT_SIMD_AVX2) || VT_SIMD_NEON)
+	#define VT_SIMD_FMA 1
+#endif
+
 #include <stdexcept>
 
 #if VT_DEBUG
@@ -1,9 +1,12 @@
 module;
+#include <array>
 #include <cmath>
 #include <format>
 #include <string>
+#include <type_traits>
 export module vt.Core.Matrix;
 
+import vt.Core.Simd;
 import vt.Core.Vector;
 
 namespace vt
@@ -19,6 +22,14 @@ namespace vt
 	template<typename T>
 	concept Scalar = IsScalar<T>::value;
 
+	template<int D> std::array<simd::Float4Reg, D> load_simd_rows(Matrix<float, D, D> const& mat) noexcept
+	{
+		std::array<simd::Float4Reg, D> regs;
+		for(int r = 0; r != D; ++r)
+			regs[r] = simd::load_vector(mat.rows[r]);
+		return regs;
+	}
+
 	export template<typename T, int R, int C> struct Matrix
 	{
 		using Row = Vector<T, C>;
@@ -171,6 +182,17 @@ namespace vt
 		template<Scalar S, int C2> constexpr auto operator*(Matrix<S, C, C2> const& that) const noexcept
 		{
 			Matrix<decltype(rows[0][0] * that[0][0]), R, C2> product {};
+			if constexpr(simd::USE_SIMD<T, S, R> && R == C && C == C2)
+			{
+				if(!std::is_constant_evaluated())
+				{
+					if constexpr(R == 4)
+						simd::multiply_4x4(&product.rows[0].x, &rows[0].x, &that.rows[0].x);
+					else
+						simd::multiply_3x3(&product.rows[0].x, &rows[0].x, &that.rows[0].x);
+					return product;
+				}
+			}
 			for(int r = 0; r != R; ++r)
 				for(int c = 0; c != C2; ++c)
 					for(int i = 0; i != C; ++i)
@@ -181,6 +203,14 @@ namespace vt
 		template<Scalar S> constexpr auto operator*(Vector<S, C> vec) const noexcept
 		{
 			Vector<decltype(rows[0][0] * vec[0]), R> product {};
+			if constexpr(simd::USE_SIMD<T, S, R> && R == C)
+			{
+				if(!std::is_constant_evaluated())
+				{
+					simd::store_vector(product, simd::combine_rows<R>(simd::load_vector(vec), load_simd_rows(*this).data()));
+					return product;
+				}
+			}
 			for(int r = 0; r != R; ++r)
 				for(int c = 0; c != C; ++c)
 					product[r] += rows[c][r] * vec[c];
@@ -189,7 +219,15 @@ namespace vt
 
 		template<Scalar S> friend constexpr auto operator*(Vector<S, R> vec, Matrix const& mat) noexcept
 		{
-			Vector<decltype(vec[0] * rows[0][0]), C> product {};
+			Vector<decltype(vec[0] * mat.rows[0][0]), C> product {};
+			if constexpr(simd::USE_SIMD<T, S, R> && R == C)
+			{
+				if(!std::is_constant_evaluated())
+				{
+					simd::store_vector(product, simd::combine_rows<R>(simd::load_vector(vec), load_simd_rows(mat).data()));
+					return product;
+				}
+			}
 			for(int c = 0; c != C; ++c)
 				for(int r = 0; r != R; ++r)
 					product[c] += vec[r] * mat.rows[r][c];
@@ -0,0 +1,101 @@
+module;
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+export module vt.Core.Packing;
+
+import vt.Core.Vector;
+
+namespace vt
+{
+	// Maps a value in [0, 1] to an unsigned normalized integer with the given number of bits.
+	constexpr uint32_t to_unorm(float value, unsigned bits) noexcept
+	{
+		float const max = static_cast<float>((1u << bits) - 1);
+		return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * max + 0.5f);
+	}
+
+	constexpr float from_unorm(uint32_t value, unsigned bits) noexcept
+	{
+		return static_cast<float>(value) / static_cast<float>((1u << bits) - 1);
+	}
+
+	// Packs a color into 8 bits per channel, with red in the lowest byte, matching the RGBA8 unorm vertex format.
+	export constexpr uint32_t pack_unorm_rgba8(Float4 color) noexcept
+	{
+		return to_unorm(color.r, 8) | to_unorm(color.g, 8) << 8 | to_unorm(color.b, 8) << 16 | to_unorm(color.a, 8) << 24;
+	}
+
+	export constexpr Float4 unpack_unorm_rgba8(uint32_t packed) noexcept
+	{
+		return {
+			from_unorm(packed & 0xFF, 8),
+			from_unorm(packed >> 8 & 0xFF, 8),
+			from_unorm(packed >> 16 & 0xFF, 8),
+			from_unorm(packed >> 24, 8),
+		};
+	}
+
+	// Packs a color into 10 bits for each color channel and 2 bits of alpha, with red in the lowest bits, matching the
+	// RGB10A2 unorm vertex format.
+	export constexpr uint32_t pack_unorm_rgb10a2(Float4 color) noexcept
+	{
+		return to_unorm(color.r, 10) | to_unorm(color.g, 10) << 10 | to_unorm(color.b, 10) << 20 | to_unorm(color.a, 2) << 30;
+	}
+
+	export constexpr Float4 unpack_unorm_rgb10a2(uint32_t packed) noexcept
+	{
+		return {
+			from_unorm(packed & 0x3FF, 10),
+			from_unorm(packed >> 10 & 0x3FF, 10),
+			from_unorm(packed >> 20 & 0x3FF, 10),
+			from_unorm(packed >> 30, 2),
+		};
+	}
+
+	// Maps a unit vector onto the octahedron and unfolds it into a square, which yields coordinates in [-1, 1].
+	export Float2 encode_octahedral(Float3 normal) noexcept
+	{
+		float const inv_l1_norm = 1.0f / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+
+		Float2 oct {normal.x * inv_l1_norm, normal.y * inv_l1_norm};
+		if(normal.z < 0) // Folds the lower hemisphere over the diagonals.
+		{
+			oct = {
+				(1 - std::abs(oct.y)) * std::copysign(1.0f, oct.x),
+				(1 - std::abs(oct.x)) * std::copysign(1.0f, oct.y),
+			};
+		}
+		return oct;
+	}
+
+	export Float3 decode_octahedral(Float2 oct) noexcept
+	{
+		Float3 normal {oct.x, oct.y, 1 - std::abs(oct.x) - std::abs(oct.y)};
+
+		float const fold = std::max(-normal.z, 0.0f);
+		normal.x += normal.x >= 0 ? -fold : fold;
+		normal.y += normal.y >= 0 ? -fold : fold;
+		return normalize(normal);
+	}
+
+	// Packs a unit vector into two 16-bit signed normalized integers, with x in the lower half, matching the two-component
+	// 16-bit snorm vertex format. Shaders decode it with the same steps as decode_octahedral.
+	export uint32_t pack_octahedral_normal(Float3 normal) noexcept
+	{
+		auto const oct = encode_octahedral(normal);
+
+		auto to_snorm16 = [](float value) {
+			return static_cast<uint16_t>(static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f)));
+		};
+		return to_snorm16(oct.x) | static_cast<uint32_t>(to_snorm16(oct.y)) << 16;
+	}
+
+	export Float3 unpack_octahedral_normal(uint32_t packed) noexcept
+	{
+		auto from_snorm16 = [](uint32_t value) {
+			return std::max(static_cast<int16_t>(value & 0xFFFF) / 32767.0f, -1.0f);
+		};
+		return decode_octahedral({from_snorm16(packed), from_snorm16(packed >> 16)});
+	}
+}
@@ -0,0 +1,187 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <cmath>
+#include <format>
+#include <string>
+export module vt.Core.Quaternion;
+
+import vt.Core.Matrix;
+import vt.Core.Simd;
+import vt.Core.Vector;
+
+namespace vt
+{
+	// Unit quaternions represent rotations. Rotating a vector by the product a * b rotates it by b first, then by a.
+	export struct Quaternion
+	{
+		float x = 0, y = 0, z = 0, w = 1;
+
+		static constexpr Quaternion identity() noexcept
+		{
+			return {};
+		}
+
+		// The axis is expected to be normalized.
+		static Quaternion from_axis_angle(Float3 axis, float radians) noexcept
+		{
+			float const half = radians / 2;
+			float const sin	 = std::sin(half);
+			return {axis.x * sin, axis.y * sin, axis.z * sin, std::cos(half)};
+		}
+
+		// Expects an orthonormal rotation matrix in row vector convention, i.e. its rows are the rotated basis vectors.
+		static Quaternion from_matrix(Float3x3 const& mat) noexcept
+		{
+			auto& m = mat.rows;
+
+			float const trace = m[0].x + m[1].y + m[2].z;
+			if(trace > 0)
+			{
+				float const s = 2 * std::sqrt(trace + 1);
+				return {(m[1].z - m[2].y) / s, (m[2].x - m[0].z) / s, (m[0].y - m[1].x) / s, s / 4};
+			}
+			if(m[0].x > m[1].y && m[0].x > m[2].z)
+			{
+				float const s = 2 * std::sqrt(1 + m[0].x - m[1].y - m[2].z);
+				return {s / 4, (m[1].x + m[0].y) / s, (m[2].x + m[0].z) / s, (m[1].z - m[2].y) / s};
+			}
+			if(m[1].y > m[2].z)
+			{
+				float const s = 2 * std::sqrt(1 + m[1].y - m[0].x - m[2].z);
+				return {(m[1].x + m[0].y) / s, s / 4, (m[2].y + m[1].z) / s, (m[2].x - m[0].z) / s};
+			}
+			float const s = 2 * std::sqrt(1 + m[2].z - m[0].x - m[1].y);
+			return {(m[2].x + m[0].z) / s, (m[2].y + m[1].z) / s, s / 4, (m[0].y - m[1].x) / s};
+		}
+
+		constexpr Float3 vector_part() const noexcept
+		{
+			return {x, y, z};
+		}
+
+		std::string to_string() const
+		{
+			return std::format("[{}, {}, {}, {}]", x, y, z, w);
+		}
+
+		constexpr bool operator==(Quaternion const&) const noexcept = default;
+
+		constexpr Quaternion operator*(Quaternion const& that) const noexcept
+		{
+			return {
+				w * that.x + x * that.w + y * that.z - z * that.y,
+				w * that.y - x * that.z + y * that.w + z * that.x,
+				w * that.z + x * that.y - y * that.x + z * that.w,
+				w * that.w - x * that.x - y * that.y - z * that.z,
+			};
+		}
+
+		constexpr Quaternion& operator*=(Quaternion const& that) noexcept
+		{
+			return *this = *this * that;
+		}
+	};
+
+	export constexpr Quaternion conjugate(Quaternion const& quat) noexcept
+	{
+		return {-quat.x, -quat.y, -quat.z, quat.w};
+	}
+
+	export constexpr float dot(Quaternion const& left, Quaternion const& right) noexcept
+	{
+		return left.x * right.x + left.y * right.y + left.z * right.z + left.w * right.w;
+	}
+
+	export constexpr Quaternion inverse(Quaternion const& quat) noexcept
+	{
+		auto conj = conjugate(quat);
+
+		float const inv_norm = 1.0f / dot(quat, quat);
+		return {conj.x * inv_norm, conj.y * inv_norm, conj.z * inv_norm, conj.w * inv_norm};
+	}
+
+	export Quaternion normalize(Quaternion const& quat) noexcept
+	{
+		Quaternion normalized;
+		simd::store4(&normalized.x, simd::normalize<4>(simd::load4(&quat.x)));
+		return normalized;
+	}
+
+	// Rotates the vector by the quaternion, which is expected to be normalized.
+	export constexpr Float3 rotate(Quaternion const& quat, Float3 vec) noexcept
+	{
+		// Expansion of q * v * q^-1 that avoids computing the full quaternion products.
+		auto const axis = quat.vector_part();
+		auto const t	= 2.0f * cross(axis, vec);
+		return vec + quat.w * t + cross(axis, t);
+	}
+
+	// Normalized linear interpolation, which takes the shorter path. Cheaper than slerp, but does not interpolate at constant
+	// angular velocity.
+	export Quaternion nlerp(Quaternion const& from, Quaternion const& to, float t) noexcept
+	{
+		float const sign = dot(from, to) < 0 ? -1.0f : 1.0f;
+
+		auto const from_reg = simd::load4(&from.x);
+		auto const to_reg	= simd::load4(&to.x);
+		auto const delta	= simd::sub(simd::mul(simd::splat(sign), to_reg), from_reg);
+		auto const blended	= simd::mul_add(simd::splat(t), delta, from_reg);
+
+		Quaternion result;
+		simd::store4(&result.x, simd::normalize<4>(blended));
+		return result;
+	}
+
+	// Spherical linear interpolation, which takes the shorter path.
+	export Quaternion slerp(Quaternion const& from, Quaternion const& to, float t) noexcept
+	{
+		float cos_angle = dot(from, to);
+		float sign		= 1;
+		if(cos_angle < 0)
+		{
+			cos_angle = -cos_angle;
+			sign	  = -1;
+		}
+
+		// Nearly parallel quaternions make the sine below vanish, so fall back to linear interpolation.
+		constexpr float NLERP_THRESHOLD = 0.9995f;
+		if(cos_angle > NLERP_THRESHOLD)
+			return nlerp(from, to, t);
+
+		float const angle	  = std::acos(cos_angle);
+		float const inv_sin	  = 1.0f / std::sin(angle);
+		float const from_part = std::sin((1 - t) * angle) * inv_sin;
+		float const to_part	  = std::sin(t * angle) * inv_sin * sign;
+
+		auto const blended = simd::mul_add(simd::splat(to_part), simd::load4(&to.x),
+										   simd::mul(simd::splat(from_part), simd::load4(&from.x)));
+		Quaternion result;
+		simd::store4(&result.x, blended);
+		return result;
+	}
+
+	// Returns the rotation matrix in row vector convention, so that vec * to_matrix3(quat) equals rotate(quat, vec).
+	export constexpr Float3x3 to_matrix3(Quaternion const& quat) noexcept
+	{
+		float const xx = quat.x * quat.x, yy = quat.y * quat.y, zz = quat.z * quat.z;
+		float const xy = quat.x * quat.y, xz = quat.x * quat.z, yz = quat.y * quat.z;
+		float const wx = quat.w * quat.x, wy = quat.w * quat.y, wz = quat.w * quat.z;
+		return {{
+			{1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy)},
+			{2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx)},
+			{2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy)},
+		}};
+	}
+
+	export constexpr Float4x4 to_matrix4(Quaternion const& quat) noexcept
+	{
+		auto const rot = to_matrix3(quat);
+		return {{
+			{rot.rows[0].x, rot.rows[0].y, rot.rows[0].z, 0},
+			{rot.rows[1].x, rot.rows[1].y, rot.rows[1].z, 0},
+			{rot.rows[2].x, rot.rows[2].y, rot.rows[2].z, 0},
+			{0, 0, 0, 1},
+		}};
+	}
+}
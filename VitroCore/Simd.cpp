@@ -0,0 +1,799 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <bit>
+#include <cmath>
+#include <type_traits>
+
+#if VT_SIMD_SSE
+	#include <immintrin.h>
+#elif VT_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+export module vt.Core.Simd;
+
+// Thin layer over the instruction set available for the target, so that math code can be written once against these
+// primitives. Without a supported instruction set, a scalar fallback with identical semantics is used. When VT_STRICT_MATH is
+// defined, every primitive performs the same operations in the same order as the scalar code in vt.Core.Vector and
+// vt.Core.Matrix, so that results are bit-identical regardless of which path was taken.
+namespace vt::simd
+{
+	// True if the primitives below map to actual vector instructions and are worth dispatching to.
+	export constexpr inline bool ENABLED = VT_SIMD_SSE || VT_SIMD_NEON;
+
+#if VT_SIMD_SSE
+
+	export using Float4Reg = __m128;
+
+	export VT_ALWAYS_INLINE Float4Reg load4(float const src[])
+	{
+		return _mm_loadu_ps(src);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg load3(float const src[])
+	{
+		__m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<double const*>(src)));
+		return _mm_movelh_ps(xy, _mm_load_ss(src + 2));
+	}
+
+	export VT_ALWAYS_INLINE void store4(float dst[], Float4Reg reg)
+	{
+		_mm_storeu_ps(dst, reg);
+	}
+
+	export VT_ALWAYS_INLINE void store3(float dst[], Float4Reg reg)
+	{
+		_mm_store_sd(reinterpret_cast<double*>(dst), _mm_castps_pd(reg));
+		_mm_store_ss(dst + 2, _mm_movehl_ps(reg, reg));
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg zero()
+	{
+		return _mm_setzero_ps();
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg splat(float value)
+	{
+		return _mm_set1_ps(value);
+	}
+
+	export template<int LANE> VT_ALWAYS_INLINE Float4Reg splat_lane(Float4Reg reg)
+	{
+		return _mm_shuffle_ps(reg, reg, _MM_SHUFFLE(LANE, LANE, LANE, LANE));
+	}
+
+	export VT_ALWAYS_INLINE float first_lane(Float4Reg reg)
+	{
+		return _mm_cvtss_f32(reg);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg add(Float4Reg left, Float4Reg right)
+	{
+		return _mm_add_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg sub(Float4Reg left, Float4Reg right)
+	{
+		return _mm_sub_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg mul(Float4Reg left, Float4Reg right)
+	{
+		return _mm_mul_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg div(Float4Reg left, Float4Reg right)
+	{
+		return _mm_div_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg min(Float4Reg left, Float4Reg right)
+	{
+		return _mm_min_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg max(Float4Reg left, Float4Reg right)
+	{
+		return _mm_max_ps(left, right);
+	}
+
+	// Computes left * right + addend.
+	export VT_ALWAYS_INLINE Float4Reg mul_add(Float4Reg left, Float4Reg right, Float4Reg addend)
+	{
+	#if VT_SIMD_FMA
+		return _mm_fmadd_ps(left, right, addend);
+	#else
+		return _mm_add_ps(_mm_mul_ps(left, right), addend);
+	#endif
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg sqrt(Float4Reg reg)
+	{
+		return _mm_sqrt_ps(reg);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg abs(Float4Reg reg)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), reg);
+	}
+
+	// Comparisons return a mask with all bits set in lanes where the comparison holds.
+	export VT_ALWAYS_INLINE Float4Reg greater(Float4Reg left, Float4Reg right)
+	{
+		return _mm_cmpgt_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg bit_and(Float4Reg left, Float4Reg right)
+	{
+		return _mm_and_ps(left, right);
+	}
+
+	// Collects the sign bit of every lane into the low bits of the result, so that bit i is set if lane i of a mask is set.
+	export VT_ALWAYS_INLINE unsigned to_bitmask(Float4Reg mask)
+	{
+		return static_cast<unsigned>(_mm_movemask_ps(mask));
+	}
+
+	// Sums the first N lanes. In strict mode, the sum starts at zero and accumulates lanes in order like the scalar loop.
+	export template<int N> VT_ALWAYS_INLINE float horizontal_sum(Float4Reg reg)
+	{
+		static_assert(N == 3 || N == 4);
+
+	#if VT_STRICT_MATH
+		__m128 sum = _mm_add_ss(_mm_setzero_ps(), reg);
+		sum		   = _mm_add_ss(sum, splat_lane<1>(reg));
+		sum		   = _mm_add_ss(sum, _mm_movehl_ps(reg, reg));
+		if constexpr(N == 4)
+			sum = _mm_add_ss(sum, splat_lane<3>(reg));
+		return _mm_cvtss_f32(sum);
+	#else
+		if constexpr(N == 3)
+			reg = _mm_and_ps(reg, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+
+		__m128 pairs = _mm_add_ps(reg, _mm_movehl_ps(reg, reg));
+		return _mm_cvtss_f32(_mm_add_ss(pairs, splat_lane<1>(pairs)));
+	#endif
+	}
+
+	// Computes the cross product of the first three lanes. The fourth lane of the result is zero if both inputs have zero in
+	// their fourth lane.
+	export VT_ALWAYS_INLINE Float4Reg cross3(Float4Reg left, Float4Reg right)
+	{
+		__m128 left_yzx	 = _mm_shuffle_ps(left, left, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 right_yzx = _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 left_zxy	 = _mm_shuffle_ps(left, left, _MM_SHUFFLE(3, 1, 0, 2));
+		__m128 right_zxy = _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 1, 0, 2));
+		return _mm_sub_ps(_mm_mul_ps(left_yzx, right_zxy), _mm_mul_ps(right_yzx, left_zxy));
+	}
+
+#elif VT_SIMD_NEON
+
+	export using Float4Reg = float32x4_t;
+
+	export VT_ALWAYS_INLINE Float4Reg load4(float const src[])
+	{
+		return vld1q_f32(src);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg load3(float const src[])
+	{
+		return vcombine_f32(vld1_f32(src), vld1_lane_f32(src + 2, vdup_n_f32(0), 0));
+	}
+
+	export VT_ALWAYS_INLINE void store4(float dst[], Float4Reg reg)
+	{
+		vst1q_f32(dst, reg);
+	}
+
+	export VT_ALWAYS_INLINE void store3(float dst[], Float4Reg reg)
+	{
+		vst1_f32(dst, vget_low_f32(reg));
+		vst1q_lane_f32(dst + 2, reg, 2);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg zero()
+	{
+		return vdupq_n_f32(0);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg splat(float value)
+	{
+		return vdupq_n_f32(value);
+	}
+
+	export template<int LANE> VT_ALWAYS_INLINE Float4Reg splat_lane(Float4Reg reg)
+	{
+		return vdupq_laneq_f32(reg, LANE);
+	}
+
+	export VT_ALWAYS_INLINE float first_lane(Float4Reg reg)
+	{
+		return vgetq_lane_f32(reg, 0);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg add(Float4Reg left, Float4Reg right)
+	{
+		return vaddq_f32(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg sub(Float4Reg left, Float4Reg right)
+	{
+		return vsubq_f32(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg mul(Float4Reg left, Float4Reg right)
+	{
+		return vmulq_f32(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg div(Float4Reg left, Float4Reg right)
+	{
+		return vdivq_f32(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg min(Float4Reg left, Float4Reg right)
+	{
+		return vminq_f32(left, right);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg max(Float4Reg left, Float4Reg right)
+	{
+		return vmaxq_f32(left, right);
+	}
+
+	// Computes left * right + addend.
+	export VT_ALWAYS_INLINE Float4Reg mul_add(Float4Reg left, Float4Reg right, Float4Reg addend)
+	{
+	#if VT_SIMD_FMA
+		return vfmaq_f32(addend, left, right);
+	#else
+		return vaddq_f32(vmulq_f32(left, right), addend);
+	#endif
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg sqrt(Float4Reg reg)
+	{
+		return vsqrtq_f32(reg);
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg abs(Float4Reg reg)
+	{
+		return vabsq_f32(reg);
+	}
+
+	// Comparisons return a mask with all bits set in lanes where the comparison holds.
+	export VT_ALWAYS_INLINE Float4Reg greater(Float4Reg left, Float4Reg right)
+	{
+		return vreinterpretq_f32_u32(vcgtq_f32(left, right));
+	}
+
+	export VT_ALWAYS_INLINE Float4Reg bit_and(Float4Reg left, Float4Reg right)
+	{
+		return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(left), vreinterpretq_u32_f32(right)));
+	}
+
+	// Collects the sign bit of every lane into the low bits of the result, so that bit i is set if lane i of a mask is set.
+	export VT_ALWAYS_INLINE unsigned to_bitmask(Float4Reg mask)
+	{
+		int32x4_t const shifts {0, 1, 2, 3};
+		return vaddvq_u32(vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(mask), 31), shifts));
+	}
+
+	// Sums the first N lanes. In strict mode, the sum starts at zero and accumulates lanes in order like the scalar loop.
+	export template<int N> VT_ALWAYS_INLINE float horizontal_sum(Float4Reg reg)
+	{
+		static_assert(N == 3 || N == 4);
+
+	#if VT_STRICT_MATH
+		float sum = 0;
+		sum += vgetq_lane_f32(reg, 0);
+		sum += vgetq_lane_f32(reg, 1);
+		sum += vgetq_lane_f32(reg, 2);
+		if constexpr(N == 4)
+			sum += vgetq_lane_f32(reg, 3);
+		return sum;
+	#else
+		if constexpr(N == 3)
+			reg = vsetq_lane_f32(0, reg, 3);
+
+		return vaddvq_f32(reg);
+	#endif
+	}
+
+	// Computes the cross product of the first three lanes. The fourth lane of the result is zero if both inputs have zero in
+	// their fourth lane.
+	export VT_ALWAYS_INLINE Float4Reg cross3(Float4Reg left, Float4Reg right)
+	{
+		auto yzx = [](float32x4_t reg) {
+			float32x4_t rotated = vextq_f32(reg, reg, 1); // y z w x
+			rotated				= vsetq_lane_f32(vgetq_lane_f32(reg, 0), rotated, 2);
+			return vsetq_lane_f32(vgetq_lane_f32(reg, 3), rotated, 3);
+		};
+		auto zxy = [](float32x4_t reg) {
+			float32x4_t rotated = vextq_f32(reg, reg, 2); // z w x y
+			rotated				= vsetq_lane_f32(vgetq_lane_f32(reg, 0), rotated, 1);
+			rotated				= vsetq_lane_f32(vgetq_lane_f32(reg, 1), rotated, 2);
+			return vsetq_lane_f32(vgetq_lane_f32(reg, 3), rotated, 3);
+		};
+		return vsubq_f32(vmulq_f32(yzx(left), zxy(right)), vmulq_f32(yzx(right), zxy(left)));
+	}
+
+#else
+
+	export struct Float4Reg
+	{
+		float lanes[4];
+	};
+
+	template<typename Func> Float4Reg for_each_lane(Float4Reg left, Float4Reg right, Func func)
+	{
+		Float4Reg result;
+		for(int i = 0; i != 4; ++i)
+			result.lanes[i] = func(left.lanes[i], right.lanes[i]);
+		return result;
+	}
+
+	export Float4Reg load4(float const src[])
+	{
+		return {src[0], src[1], src[2], src[3]};
+	}
+
+	export Float4Reg load3(float const src[])
+	{
+		return {src[0], src[1], src[2], 0};
+	}
+
+	export void store4(float dst[], Float4Reg reg)
+	{
+		for(int i = 0; i != 4; ++i)
+			dst[i] = reg.lanes[i];
+	}
+
+	export void store3(float dst[], Float4Reg reg)
+	{
+		for(int i = 0; i != 3; ++i)
+			dst[i] = reg.lanes[i];
+	}
+
+	export Float4Reg zero()
+	{
+		return {};
+	}
+
+	export Float4Reg splat(float value)
+	{
+		return {value, value, value, value};
+	}
+
+	export template<int LANE> Float4Reg splat_lane(Float4Reg reg)
+	{
+		return splat(reg.lanes[LANE]);
+	}
+
+	export float first_lane(Float4Reg reg)
+	{
+		return reg.lanes[0];
+	}
+
+	export Float4Reg add(Float4Reg left, Float4Reg right)
+	{
+		return for_each_lane(left, right, [](float l, float r) {
+			return l + r;
+		});
+	}
+
+	export Float4Reg sub(Float4Reg left, Float4Reg right)
+	{
+		return for_each_lane(left, right, [](float l, float r) {
+			return l - r;
+		});
+	}
+
+	export Float4Reg mul(Float4Reg left, Float4Reg right)
+	{
+		return for_each_lane(left, right, [](float l, float r) {
+			return l * r;
+		});
+	}
+
+	export Float4Reg div(Float4Reg left, Float4Reg right)
+	{
+		return for_each_lane(left, right, [](float l, float r) {
+			return l / r;
+		});
+	}
+
+	export Float4Reg min(Float4Reg left, Float4Reg right)
+	{
+		return for_each_lane(left, right, [](float l, float r) {
+			return l < r ? l : r;
+		});
+	}
+
+	export Float4Reg max(Float4Reg left, Float4Reg right)
+	{
+		return for_each_lane(left, right, [](float l, float r) {
+			return l > r ? l : r;
+		});
+	}
+
+	export Float4Reg mul_add(Float4Reg left, Float4Reg right, Float4Reg addend)
+	{
+		return add(mul(left, right), addend);
+	}
+
+	export Float4Reg sqrt(Float4Reg reg)
+	{
+		for(float& lane : reg.lanes)
+			lane = std::sqrt(lane);
+		return reg;
+	}
+
+	export Float4Reg abs(Float4Reg reg)
+	{
+		for(float& lane : reg.lanes)
+			lane = std::abs(lane);
+		return reg;
+	}
+
+	// Comparisons return a mask with all bits set in lanes where the comparison holds.
+	export Float4Reg greater(Float4Reg left, Float4Reg right)
+	{
+		return for_each_lane(left, right, [](float l, float r) {
+			return std::bit_cast<float>(l > r ? ~0u : 0u);
+		});
+	}
+
+	export Float4Reg bit_and(Float4Reg left, Float4Reg right)
+	{
+		return for_each_lane(left, right, [](float l, float r) {
+			return std::bit_cast<float>(std::bit_cast<unsigned>(l) & std::bit_cast<unsigned>(r));
+		});
+	}
+
+	// Collects the sign bit of every lane into the low bits of the result, so that bit i is set if lane i of a mask is set.
+	export unsigned to_bitmask(Float4Reg mask)
+	{
+		unsigned bits = 0;
+		for(int i = 0; i != 4; ++i)
+			bits |= (std::bit_cast<unsigned>(mask.lanes[i]) >> 31) << i;
+		return bits;
+	}
+
+	export template<int N> float horizontal_sum(Float4Reg reg)
+	{
+		float sum = 0;
+		for(int i = 0; i != N; ++i)
+			sum += reg.lanes[i];
+		return sum;
+	}
+
+	export Float4Reg cross3(Float4Reg left, Float4Reg right)
+	{
+		auto& l = left.lanes;
+		auto& r = right.lanes;
+		return {
+			l[1] * r[2] - r[1] * l[2],
+			l[2] * r[0] - r[2] * l[0],
+			l[0] * r[1] - r[0] * l[1],
+			0,
+		};
+	}
+
+#endif
+
+	// Reciprocal of the square root for every lane. In strict mode, this is computed exactly like the scalar expression
+	// 1.0f / std::sqrt(x).
+	export VT_ALWAYS_INLINE Float4Reg inv_sqrt(Float4Reg reg)
+	{
+#if VT_SIMD_SSE && !VT_STRICT_MATH
+		// Estimate refined with one Newton-Raphson step, which is accurate to about 22 bits.
+		__m128 estimate = _mm_rsqrt_ps(reg);
+		__m128 muls		= _mm_mul_ps(_mm_mul_ps(reg, estimate), estimate);
+		return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), estimate), _mm_sub_ps(_mm_set1_ps(3.0f), muls));
+#else
+		return div(splat(1.0f), sqrt(reg));
+#endif
+	}
+
+	// Dot product over the first N lanes, returned in every lane.
+	export template<int N> VT_ALWAYS_INLINE Float4Reg dot(Float4Reg left, Float4Reg right)
+	{
+		return splat(horizontal_sum<N>(mul(left, right)));
+	}
+
+	// Scales the first N lanes to unit length.
+	export template<int N> VT_ALWAYS_INLINE Float4Reg normalize(Float4Reg reg)
+	{
+		return mul(inv_sqrt(dot<N>(reg, reg)), reg);
+	}
+
+	// Computes the linear combination weights.x * rows[0] + weights.y * rows[1] + ... over N rows, accumulating from zero in
+	// row order, which is how the scalar matrix products accumulate.
+	export template<int N> VT_ALWAYS_INLINE Float4Reg combine_rows(Float4Reg weights, Float4Reg const rows[])
+	{
+#if VT_STRICT_MATH
+		Float4Reg sum = add(zero(), mul(splat_lane<0>(weights), rows[0]));
+#else
+		Float4Reg sum = mul(splat_lane<0>(weights), rows[0]);
+#endif
+		sum = mul_add(splat_lane<1>(weights), rows[1], sum);
+		if constexpr(N > 2)
+			sum = mul_add(splat_lane<2>(weights), rows[2], sum);
+		if constexpr(N > 3)
+			sum = mul_add(splat_lane<3>(weights), rows[3], sum);
+		return sum;
+	}
+
+	// Multiplies two row-major 4x4 matrices stored as 16 contiguous floats.
+	export VT_ALWAYS_INLINE void multiply_4x4(float dst[], float const left[], float const right[])
+	{
+#if VT_SIMD_AVX2
+		// Two result rows are computed per iteration, one in each 128-bit half.
+		__m256 const right_rows[] {
+			_mm256_broadcast_ps(reinterpret_cast<__m128 const*>(right)),
+			_mm256_broadcast_ps(reinterpret_cast<__m128 const*>(right + 4)),
+			_mm256_broadcast_ps(reinterpret_cast<__m128 const*>(right + 8)),
+			_mm256_broadcast_ps(reinterpret_cast<__m128 const*>(right + 12)),
+		};
+		for(int r = 0; r != 4; r += 2)
+		{
+			__m256 left_rows = _mm256_loadu_ps(left + 4 * r);
+
+	#if VT_STRICT_MATH || !VT_SIMD_FMA
+			__m256 sum = _mm256_add_ps(_mm256_setzero_ps(), _mm256_mul_ps(_mm256_permute_ps(left_rows, 0x00), right_rows[0]));
+			sum		   = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(left_rows, 0x55), right_rows[1]));
+			sum		   = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(left_rows, 0xAA), right_rows[2]));
+			sum		   = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(left_rows, 0xFF), right_rows[3]));
+	#else
+			__m256 sum = _mm256_mul_ps(_mm256_permute_ps(left_rows, 0x00), right_rows[0]);
+			sum		   = _mm256_fmadd_ps(_mm256_permute_ps(left_rows, 0x55), right_rows[1], sum);
+			sum		   = _mm256_fmadd_ps(_mm256_permute_ps(left_rows, 0xAA), right_rows[2], sum);
+			sum		   = _mm256_fmadd_ps(_mm256_permute_ps(left_rows, 0xFF), right_rows[3], sum);
+	#endif
+			_mm256_storeu_ps(dst + 4 * r, sum);
+		}
+#else
+		Float4Reg const right_rows[] {
+			load4(right),
+			load4(right + 4),
+			load4(right + 8),
+			load4(right + 12),
+		};
+		for(int r = 0; r != 4; ++r)
+			store4(dst + 4 * r, combine_rows<4>(load4(left + 4 * r), right_rows));
+#endif
+	}
+
+	// Multiplies two row-major 3x3 matrices stored as 9 contiguous floats.
+	export VT_ALWAYS_INLINE void multiply_3x3(float dst[], float const left[], float const right[])
+	{
+		Float4Reg const right_rows[] {
+			load3(right),
+			load3(right + 3),
+			load3(right + 6),
+		};
+		Float4Reg const results[] {
+			combine_rows<3>(load3(left), right_rows),
+			combine_rows<3>(load3(left + 3), right_rows),
+			combine_rows<3>(load3(left + 6), right_rows),
+		};
+		// Storing happens afterwards in case the destination aliases one of the inputs.
+		store3(dst, results[0]);
+		store3(dst + 3, results[1]);
+		store3(dst + 6, results[2]);
+	}
+
+	// The widest register available, used by kernels that stream over structure-of-arrays data. Such kernels process
+	// PACK_WIDTH elements per iteration and handle the remainder with the partial load and store functions.
+#if VT_SIMD_AVX2
+
+	export using FloatPack = __m256;
+
+	export constexpr inline int PACK_WIDTH = 8;
+
+	export VT_ALWAYS_INLINE FloatPack load_pack(float const src[])
+	{
+		return _mm256_loadu_ps(src);
+	}
+
+	export VT_ALWAYS_INLINE void store_pack(float dst[], FloatPack pack)
+	{
+		_mm256_storeu_ps(dst, pack);
+	}
+
+	__m256i make_tail_mask(int count)
+	{
+		return _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	}
+
+	// Loads the first count elements and sets the remaining lanes to the fill value.
+	export VT_ALWAYS_INLINE FloatPack load_pack_partial(float const src[], int count, float fill = 0)
+	{
+		__m256i mask = make_tail_mask(count);
+		return _mm256_blendv_ps(_mm256_set1_ps(fill), _mm256_maskload_ps(src, mask), _mm256_castsi256_ps(mask));
+	}
+
+	export VT_ALWAYS_INLINE void store_pack_partial(float dst[], FloatPack pack, int count)
+	{
+		_mm256_maskstore_ps(dst, make_tail_mask(count), pack);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack splat_pack(float value)
+	{
+		return _mm256_set1_ps(value);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack add(FloatPack left, FloatPack right)
+	{
+		return _mm256_add_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack sub(FloatPack left, FloatPack right)
+	{
+		return _mm256_sub_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack mul(FloatPack left, FloatPack right)
+	{
+		return _mm256_mul_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack div(FloatPack left, FloatPack right)
+	{
+		return _mm256_div_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack min(FloatPack left, FloatPack right)
+	{
+		return _mm256_min_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack max(FloatPack left, FloatPack right)
+	{
+		return _mm256_max_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack mul_add(FloatPack left, FloatPack right, FloatPack addend)
+	{
+	#if VT_SIMD_FMA
+		return _mm256_fmadd_ps(left, right, addend);
+	#else
+		return _mm256_add_ps(_mm256_mul_ps(left, right), addend);
+	#endif
+	}
+
+	export VT_ALWAYS_INLINE FloatPack sqrt(FloatPack pack)
+	{
+		return _mm256_sqrt_ps(pack);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack abs(FloatPack pack)
+	{
+		return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), pack);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack greater(FloatPack left, FloatPack right)
+	{
+		return _mm256_cmp_ps(left, right, _CMP_GT_OQ);
+	}
+
+	export VT_ALWAYS_INLINE FloatPack bit_and(FloatPack left, FloatPack right)
+	{
+		return _mm256_and_ps(left, right);
+	}
+
+	export VT_ALWAYS_INLINE unsigned to_bitmask(FloatPack mask)
+	{
+		return static_cast<unsigned>(_mm256_movemask_ps(mask));
+	}
+
+	export VT_ALWAYS_INLINE FloatPack inv_sqrt(FloatPack pack)
+	{
+	#if VT_STRICT_MATH
+		return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(pack));
+	#else
+		__m256 estimate = _mm256_rsqrt_ps(pack);
+		__m256 muls		= _mm256_mul_ps(_mm256_mul_ps(pack, estimate), estimate);
+		return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), estimate), _mm256_sub_ps(_mm256_set1_ps(3.0f), muls));
+	#endif
+	}
+
+	export VT_ALWAYS_INLINE float reduce_min(FloatPack pack)
+	{
+		__m128 half = _mm_min_ps(_mm256_castps256_ps128(pack), _mm256_extractf128_ps(pack, 1));
+		half		= _mm_min_ps(half, _mm_movehl_ps(half, half));
+		return _mm_cvtss_f32(_mm_min_ss(half, splat_lane<1>(half)));
+	}
+
+	export VT_ALWAYS_INLINE float reduce_max(FloatPack pack)
+	{
+		__m128 half = _mm_max_ps(_mm256_castps256_ps128(pack), _mm256_extractf128_ps(pack, 1));
+		half		= _mm_max_ps(half, _mm_movehl_ps(half, half));
+		return _mm_cvtss_f32(_mm_max_ss(half, splat_lane<1>(half)));
+	}
+
+#else
+
+	export using FloatPack = Float4Reg;
+
+	export constexpr inline int PACK_WIDTH = 4;
+
+	export VT_ALWAYS_INLINE FloatPack load_pack(float const src[])
+	{
+		return load4(src);
+	}
+
+	export VT_ALWAYS_INLINE void store_pack(float dst[], FloatPack pack)
+	{
+		store4(dst, pack);
+	}
+
+	// Loads the first count elements and sets the remaining lanes to the fill value.
+	export VT_ALWAYS_INLINE FloatPack load_pack_partial(float const src[], int count, float fill = 0)
+	{
+		float lanes[] {fill, fill, fill, fill};
+		for(int i = 0; i != count; ++i)
+			lanes[i] = src[i];
+		return load4(lanes);
+	}
+
+	export VT_ALWAYS_INLINE void store_pack_partial(float dst[], FloatPack pack, int count)
+	{
+		float lanes[4];
+		store4(lanes, pack);
+		for(int i = 0; i != count; ++i)
+			dst[i] = lanes[i];
+	}
+
+	export VT_ALWAYS_INLINE FloatPack splat_pack(float value)
+	{
+		return splat(value);
+	}
+
+	export VT_ALWAYS_INLINE float reduce_min(FloatPack pack)
+	{
+		float lanes[4];
+		store4(lanes, pack);
+		return std::fmin(std::fmin(lanes[0], lanes[1]), std::fmin(lanes[2], lanes[3]));
+	}
+
+	export VT_ALWAYS_INLINE float reduce_max(FloatPack pack)
+	{
+		float lanes[4];
+		store4(lanes, pack);
+		return std::fmax(std::fmax(lanes[0], lanes[1]), std::fmax(lanes[2], lanes[3]));
+	}
+
+#endif
+
+	// True if operations on vectors of the given component types and size should be dispatched to the primitives above
+	// outside of constant evaluation.
+	export template<typename T1, typename T2, int D>
+	constexpr inline bool USE_SIMD = ENABLED && std::is_same_v<T1, float> && std::is_same_v<T2, float> && (D == 3 || D == 4);
+
+	export template<template<typename, int> typename V, int D>
+	VT_ALWAYS_INLINE Float4Reg load_vector(V<float, D> const& vec)
+	{
+		if constexpr(D == 4)
+			return load4(&vec.x);
+		else
+			return load3(&vec.x);
+	}
+
+	export template<template<typename, int> typename V, int D>
+	VT_ALWAYS_INLINE void store_vector(V<float, D>& vec, Float4Reg reg)
+	{
+		if constexpr(D == 4)
+			store4(&vec.x, reg);
+		else
+			store3(&vec.x, reg);
+	}
+
+	export template<typename V> VT_ALWAYS_INLINE V store_vector(Float4Reg reg)
+	{
+		V vec;
+		store_vector(vec, reg);
+		return vec;
+	}
+}
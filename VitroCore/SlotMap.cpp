@@ -0,0 +1,212 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+export module vt.Core.SlotMap;
+
+namespace vt
+{
+	// Refers to an element of a SlotMap<T>. A handle becomes stale once its element is erased, even if the slot is reused.
+	// Default-constructed handles are null and never refer to an element.
+	export template<typename T> struct SlotHandle
+	{
+		uint32_t index		= 0;
+		uint32_t generation = 0;
+
+		explicit operator bool() const noexcept
+		{
+			return generation != 0;
+		}
+
+		bool operator==(SlotHandle const&) const noexcept = default;
+	};
+
+	// Associative container that hands out generational handles to its elements. Elements are stored densely, so iteration is
+	// as fast as over a vector, while insertion, erasure and lookup are constant time. Erasing moves the last element into
+	// the erased position, so element order and references are not stable, but handles are.
+	export template<typename T> class SlotMap
+	{
+	public:
+		template<typename... Ts> SlotHandle<T> emplace(Ts&&... args)
+		{
+			uint32_t const dense_index = static_cast<uint32_t>(values.size());
+			values.emplace_back(std::forward<Ts>(args)...);
+
+			uint32_t slot_index;
+			if(free_head == NO_SLOT)
+			{
+				slot_index = static_cast<uint32_t>(slots.size());
+				slots.push_back({dense_index, 1});
+			}
+			else
+			{
+				slot_index = free_head;
+
+				auto& slot = slots[slot_index];
+				free_head  = slot.index;
+				slot.index = dense_index;
+			}
+			dense_to_slot.push_back(slot_index);
+			return {slot_index, slots[slot_index].generation};
+		}
+
+		SlotHandle<T> insert(T&& value)
+		{
+			return emplace(std::move(value));
+		}
+
+		SlotHandle<T> insert(T const& value)
+		{
+			return emplace(value);
+		}
+
+		// Removes the element and returns it, which lets the caller defer its destruction.
+		T extract(SlotHandle<T> handle)
+		{
+			VT_ASSERT(contains(handle), "Handle is stale or null.");
+
+			auto&		   slot		   = slots[handle.index];
+			uint32_t const dense_index = slot.index;
+
+			T value = std::move(values[dense_index]);
+			if(dense_index != values.size() - 1)
+			{
+				uint32_t const moved_slot = dense_to_slot.back();
+
+				values[dense_index]		   = std::move(values.back());
+				dense_to_slot[dense_index] = moved_slot;
+				slots[moved_slot].index	   = dense_index;
+			}
+			values.pop_back();
+			dense_to_slot.pop_back();
+
+			// Slots whose generation would overflow are retired instead of reused, so old handles can never alias them.
+			if(++slot.generation != 0)
+			{
+				slot.index = free_head;
+				free_head  = handle.index;
+			}
+			return value;
+		}
+
+		void erase(SlotHandle<T> handle)
+		{
+			extract(handle);
+		}
+
+		bool contains(SlotHandle<T> handle) const noexcept
+		{
+			return handle.index < slots.size() && handle.generation != 0 && slots[handle.index].generation == handle.generation;
+		}
+
+		// Returns null if the handle is stale or null.
+		T* find(SlotHandle<T> handle) noexcept
+		{
+			return contains(handle) ? &values[slots[handle.index].index] : nullptr;
+		}
+
+		T const* find(SlotHandle<T> handle) const noexcept
+		{
+			return contains(handle) ? &values[slots[handle.index].index] : nullptr;
+		}
+
+		T& operator[](SlotHandle<T> handle) noexcept
+		{
+			VT_ASSERT(contains(handle), "Handle is stale or null.");
+			return values[slots[handle.index].index];
+		}
+
+		T const& operator[](SlotHandle<T> handle) const noexcept
+		{
+			VT_ASSERT(contains(handle), "Handle is stale or null.");
+			return values[slots[handle.index].index];
+		}
+
+		// Handle of the element at the given position in iteration order.
+		SlotHandle<T> get_handle(size_t dense_index) const noexcept
+		{
+			uint32_t const slot_index = dense_to_slot[dense_index];
+			return {slot_index, slots[slot_index].generation};
+		}
+
+		// Erases all elements and invalidates all handles.
+		void clear()
+		{
+			for(uint32_t slot_index : dense_to_slot)
+			{
+				auto& slot = slots[slot_index];
+				if(++slot.generation != 0)
+				{
+					slot.index = free_head;
+					free_head  = slot_index;
+				}
+			}
+			values.clear();
+			dense_to_slot.clear();
+		}
+
+		void reserve(size_t capacity)
+		{
+			values.reserve(capacity);
+			dense_to_slot.reserve(capacity);
+			slots.reserve(capacity);
+		}
+
+		auto begin() noexcept
+		{
+			return values.begin();
+		}
+
+		auto begin() const noexcept
+		{
+			return values.begin();
+		}
+
+		auto end() noexcept
+		{
+			return values.end();
+		}
+
+		auto end() const noexcept
+		{
+			return values.end();
+		}
+
+		T* data() noexcept
+		{
+			return values.data();
+		}
+
+		T const* data() const noexcept
+		{
+			return values.data();
+		}
+
+		size_t size() const noexcept
+		{
+			return values.size();
+		}
+
+		bool empty() const noexcept
+		{
+			return values.empty();
+		}
+
+	private:
+		static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+		struct Slot
+		{
+			uint32_t index; // Index into the dense arrays while occupied, otherwise the next free slot.
+			uint32_t generation;
+		};
+
+		std::vector<T>		  values;
+		std::vector<uint32_t> dense_to_slot;
+		std::vector<Slot>	  slots;
+		uint32_t			  free_head = NO_SLOT;
+	};
+}
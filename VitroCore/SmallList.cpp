@@ -1,9 +1,590 @@
 module;
-#include <vector>
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 export module vt.Core.SmallList;
 
+import vt.Core.Scope;
+
 namespace vt
 {
-	// This will be replaced with a dynamic array container optimized for small sizes, eventually.
-	export template<typename T> using SmallList = std::vector<T>;
+	// Types for which moving to a new address and destroying the original is equivalent to copying the bytes. Specialize
+	// this for types that own resources through handles, so that containers can relocate them with memcpy.
+	export template<typename T> struct IsTriviallyRelocatable : std::is_trivially_copyable<T>
+	{};
+
+	template<typename T> constexpr size_t default_small_list_capacity() noexcept
+	{
+		constexpr size_t INLINE_BYTES = 128;
+		return std::max<size_t>(4, INLINE_BYTES / sizeof(T));
+	}
+
+	// Dynamic array that stores up to N elements inline and only allocates from the heap once it grows beyond that. Has the
+	// same interface as std::vector. Unlike with std::vector, moving a list that has not spilled to the heap moves its
+	// elements, so iterators and pointers into a moved-from list do not stay valid.
+	export template<typename T, size_t N = default_small_list_capacity<T>()> class SmallList
+	{
+	public:
+		using value_type			 = T;
+		using size_type				 = size_t;
+		using difference_type		 = ptrdiff_t;
+		using reference				 = T&;
+		using const_reference		 = T const&;
+		using pointer				 = T*;
+		using const_pointer			 = T const*;
+		using iterator				 = T*;
+		using const_iterator		 = T const*;
+		using reverse_iterator		 = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		SmallList() noexcept = default;
+
+		explicit SmallList(size_t count)
+		{
+			resize(count);
+		}
+
+		SmallList(size_t count, T const& value)
+		{
+			resize(count, value);
+		}
+
+		SmallList(std::initializer_list<T> list)
+		{
+			append(list.begin(), list.end());
+		}
+
+		template<std::input_iterator It> SmallList(It first, It last)
+		{
+			append(first, last);
+		}
+
+		SmallList(SmallList const& that)
+		{
+			append(that.begin(), that.end());
+		}
+
+		SmallList(SmallList&& that) noexcept
+		{
+			take(std::move(that));
+		}
+
+		~SmallList()
+		{
+			destroy(ptr, ptr + count);
+			deallocate();
+		}
+
+		SmallList& operator=(SmallList const& that)
+		{
+			if(this != &that)
+			{
+				clear();
+				append(that.begin(), that.end());
+			}
+			return *this;
+		}
+
+		SmallList& operator=(SmallList&& that) noexcept
+		{
+			if(this != &that)
+			{
+				clear();
+				deallocate();
+				take(std::move(that));
+			}
+			return *this;
+		}
+
+		SmallList& operator=(std::initializer_list<T> list)
+		{
+			clear();
+			append(list.begin(), list.end());
+			return *this;
+		}
+
+		T& operator[](size_t index) noexcept
+		{
+			VT_ASSERT_PURE(index < count, "Index out of range.");
+			return ptr[index];
+		}
+
+		T const& operator[](size_t index) const noexcept
+		{
+			VT_ASSERT_PURE(index < count, "Index out of range.");
+			return ptr[index];
+		}
+
+		T& at(size_t index)
+		{
+			if(index >= count)
+				throw std::out_of_range("SmallList index out of range.");
+			return ptr[index];
+		}
+
+		T const& at(size_t index) const
+		{
+			if(index >= count)
+				throw std::out_of_range("SmallList index out of range.");
+			return ptr[index];
+		}
+
+		bool operator==(SmallList const& that) const
+		{
+			return std::equal(begin(), end(), that.begin(), that.end());
+		}
+
+		auto operator<=>(SmallList const& that) const
+		{
+			return std::lexicographical_compare_three_way(begin(), end(), that.begin(), that.end());
+		}
+
+		void assign(size_t new_count, T const& value)
+		{
+			clear();
+			resize(new_count, value);
+		}
+
+		template<std::input_iterator It> void assign(It first, It last)
+		{
+			clear();
+			append(first, last);
+		}
+
+		void assign(std::initializer_list<T> list)
+		{
+			assign(list.begin(), list.end());
+		}
+
+		template<typename... Ts> T& emplace_back(Ts&&... args)
+		{
+			if(count == cap)
+				return emplace_back_with_growth(std::forward<Ts>(args)...);
+
+			T* element = std::construct_at(ptr + count, std::forward<Ts>(args)...);
+			++count;
+			return *element;
+		}
+
+		void push_back(T const& value)
+		{
+			emplace_back(value);
+		}
+
+		void push_back(T&& value)
+		{
+			emplace_back(std::move(value));
+		}
+
+		void pop_back() noexcept
+		{
+			VT_ASSERT_PURE(count != 0, "List is empty.");
+			std::destroy_at(ptr + --count);
+		}
+
+		template<typename... Ts> T* emplace(T const* position, Ts&&... args)
+		{
+			size_t const index = position - ptr;
+
+			emplace_back(std::forward<Ts>(args)...);
+			std::rotate(ptr + index, ptr + count - 1, ptr + count);
+			return ptr + index;
+		}
+
+		T* insert(T const* position, T const& value)
+		{
+			return emplace(position, value);
+		}
+
+		T* insert(T const* position, T&& value)
+		{
+			return emplace(position, std::move(value));
+		}
+
+		T* insert(T const* position, size_t insert_count, T const& value)
+		{
+			size_t const index	   = position - ptr;
+			size_t const old_count = count;
+
+			resize(count + insert_count, value);
+			std::rotate(ptr + index, ptr + old_count, ptr + count);
+			return ptr + index;
+		}
+
+		// The inserted range must not refer to elements of this list.
+		template<std::input_iterator It> T* insert(T const* position, It first, It last)
+		{
+			size_t const index	   = position - ptr;
+			size_t const old_count = count;
+
+			append(first, last);
+			std::rotate(ptr + index, ptr + old_count, ptr + count);
+			return ptr + index;
+		}
+
+		T* insert(T const* position, std::initializer_list<T> list)
+		{
+			return insert(position, list.begin(), list.end());
+		}
+
+		T* erase(T const* position)
+		{
+			return erase(position, position + 1);
+		}
+
+		T* erase(T const* first, T const* last)
+		{
+			T* const dst = ptr + (first - ptr);
+			T* const src = ptr + (last - ptr);
+
+			T* const new_end = std::move(src, ptr + count, dst);
+			destroy(new_end, ptr + count);
+			count = new_end - ptr;
+			return dst;
+		}
+
+		void clear() noexcept
+		{
+			destroy(ptr, ptr + count);
+			count = 0;
+		}
+
+		void resize(size_t new_count)
+		{
+			resize_with(new_count, [](T* element) {
+				std::construct_at(element);
+			});
+		}
+
+		void resize(size_t new_count, T const& value)
+		{
+			if(new_count <= cap)
+			{
+				resize_with(new_count, [&](T* element) {
+					std::construct_at(element, value);
+				});
+				return;
+			}
+
+			// Constructs the new elements before relocating, since the value may refer to an element of this list.
+			size_t const new_capacity = grown_capacity(new_count);
+
+			T* const   new_ptr = std::allocator<T>().allocate(new_capacity);
+			ScopeGuard free_new_ptr([&] {
+				std::allocator<T>().deallocate(new_ptr, new_capacity);
+			});
+			std::uninitialized_fill(new_ptr + count, new_ptr + new_count, value);
+			free_new_ptr.dismiss();
+
+			adopt(new_ptr, new_capacity);
+			count = new_count;
+		}
+
+		void reserve(size_t new_capacity)
+		{
+			if(new_capacity > cap)
+				reallocate(new_capacity);
+		}
+
+		void shrink_to_fit()
+		{
+			if(ptr == inline_data() || count == cap)
+				return;
+
+			T* const old_ptr = ptr;
+			size_t	 old_cap = cap;
+			if(count <= N)
+			{
+				ptr = inline_data();
+				cap = N;
+			}
+			else
+			{
+				ptr = std::allocator<T>().allocate(count);
+				cap = count;
+			}
+			relocate(ptr, old_ptr, count);
+			std::allocator<T>().deallocate(old_ptr, old_cap);
+		}
+
+		void swap(SmallList& that) noexcept
+		{
+			SmallList temp(std::move(that));
+			that  = std::move(*this);
+			*this = std::move(temp);
+		}
+
+		T& front() noexcept
+		{
+			return ptr[0];
+		}
+
+		T const& front() const noexcept
+		{
+			return ptr[0];
+		}
+
+		T& back() noexcept
+		{
+			return ptr[count - 1];
+		}
+
+		T const& back() const noexcept
+		{
+			return ptr[count - 1];
+		}
+
+		T* begin() noexcept
+		{
+			return ptr;
+		}
+
+		T const* begin() const noexcept
+		{
+			return ptr;
+		}
+
+		T const* cbegin() const noexcept
+		{
+			return ptr;
+		}
+
+		T* end() noexcept
+		{
+			return ptr + count;
+		}
+
+		T const* end() const noexcept
+		{
+			return ptr + count;
+		}
+
+		T const* cend() const noexcept
+		{
+			return ptr + count;
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		const_reverse_iterator crbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		const_reverse_iterator crend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		T* data() noexcept
+		{
+			return ptr;
+		}
+
+		T const* data() const noexcept
+		{
+			return ptr;
+		}
+
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		size_t capacity() const noexcept
+		{
+			return cap;
+		}
+
+		static constexpr size_t inline_capacity() noexcept
+		{
+			return N;
+		}
+
+		static constexpr size_t max_size() noexcept
+		{
+			return std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>());
+		}
+
+		bool empty() const noexcept
+		{
+			return count == 0;
+		}
+
+		// Returns whether the elements currently live in the inline storage.
+		bool is_inline() const noexcept
+		{
+			return ptr == inline_data();
+		}
+
+	private:
+		T*	   ptr	 = inline_data();
+		size_t count = 0;
+		size_t cap	 = N;
+		alignas(T) unsigned char storage[N * sizeof(T)];
+
+		T* inline_data() noexcept
+		{
+			return reinterpret_cast<T*>(storage);
+		}
+
+		T const* inline_data() const noexcept
+		{
+			return reinterpret_cast<T const*>(storage);
+		}
+
+		// Moves elements to uninitialized memory and ends the lifetime of the originals.
+		static void relocate(T* dst, T* src, size_t n) noexcept
+		{
+			if constexpr(IsTriviallyRelocatable<T>::value)
+			{
+				if(n != 0)
+					std::memcpy(static_cast<void*>(dst), static_cast<void const*>(src), n * sizeof(T));
+			}
+			else
+			{
+				std::uninitialized_move_n(src, n, dst);
+				std::destroy_n(src, n);
+			}
+		}
+
+		static void destroy(T* first, T* last) noexcept
+		{
+			if constexpr(!std::is_trivially_destructible_v<T>)
+				std::destroy(first, last);
+		}
+
+		void deallocate() noexcept
+		{
+			if(!is_inline())
+				std::allocator<T>().deallocate(ptr, cap);
+
+			ptr = inline_data();
+			cap = N;
+		}
+
+		void take(SmallList&& that) noexcept
+		{
+			if(that.is_inline())
+			{
+				relocate(ptr, that.ptr, that.count);
+				count = that.count;
+			}
+			else
+			{
+				ptr		 = that.ptr;
+				count	 = that.count;
+				cap		 = that.cap;
+				that.ptr = that.inline_data();
+				that.cap = N;
+			}
+			that.count = 0;
+		}
+
+		size_t grown_capacity(size_t required) const noexcept
+		{
+			return std::max(cap * 2, required);
+		}
+
+		void reallocate(size_t new_capacity)
+		{
+			adopt(std::allocator<T>().allocate(new_capacity), new_capacity);
+		}
+
+		// Relocates the elements into the given block and releases the current one.
+		void adopt(T* new_ptr, size_t new_capacity) noexcept
+		{
+			relocate(new_ptr, ptr, count);
+
+			if(!is_inline())
+				std::allocator<T>().deallocate(ptr, cap);
+
+			ptr = new_ptr;
+			cap = new_capacity;
+		}
+
+		// Constructs the new element before relocating, since the arguments may refer to elements of this list.
+		template<typename... Ts> T& emplace_back_with_growth(Ts&&... args)
+		{
+			size_t const new_capacity = grown_capacity(count + 1);
+
+			T* const   new_ptr = std::allocator<T>().allocate(new_capacity);
+			ScopeGuard free_new_ptr([&] {
+				std::allocator<T>().deallocate(new_ptr, new_capacity);
+			});
+			T* const element = std::construct_at(new_ptr + count, std::forward<Ts>(args)...);
+			free_new_ptr.dismiss();
+
+			adopt(new_ptr, new_capacity);
+			++count;
+			return *element;
+		}
+
+		template<typename It> void append(It first, It last)
+		{
+			if constexpr(std::forward_iterator<It>)
+				reserve(count + std::distance(first, last));
+
+			for(; first != last; ++first)
+				emplace_back(*first);
+		}
+
+		void resize_with(size_t new_count, auto construct)
+		{
+			if(new_count < count)
+			{
+				destroy(ptr + new_count, ptr + count);
+				count = new_count;
+				return;
+			}
+
+			if(new_count > cap)
+				reallocate(grown_capacity(new_count));
+
+			for(; count != new_count; ++count)
+				construct(ptr + count);
+		}
+	};
+
+	export template<typename T, size_t N, typename U> size_t erase(SmallList<T, N>& list, U const& value)
+	{
+		auto const new_end = std::remove(list.begin(), list.end(), value);
+		size_t const erased = list.end() - new_end;
+		list.erase(new_end, list.end());
+		return erased;
+	}
+
+	export template<typename T, size_t N, typename Predicate> size_t erase_if(SmallList<T, N>& list, Predicate predicate)
+	{
+		auto const new_end = std::remove_if(list.begin(), list.end(), predicate);
+		size_t const erased = list.end() - new_end;
+		list.erase(new_end, list.end());
+		return erased;
+	}
 }
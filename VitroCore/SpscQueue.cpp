@@ -0,0 +1,155 @@
+module;
+#include <atomic>
+#include <bit>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+export module vt.Core.SpscQueue;
+
+namespace vt
+{
+	// Bounded lock-free queue for exactly one producer thread and one consumer thread. Both sides keep a cached copy of the
+	// other side's index on their own cache line, so they only touch shared cache lines when the cached copy suggests the
+	// queue is full or empty. Batched operations publish all their elements with a single atomic store.
+	export template<typename T, size_t CAPACITY> class SpscQueue
+	{
+		static_assert(std::has_single_bit(CAPACITY), "Capacity must be a power of two.");
+
+	public:
+		SpscQueue() = default;
+
+		SpscQueue(SpscQueue const&)			   = delete;
+		SpscQueue& operator=(SpscQueue const&) = delete;
+
+		~SpscQueue()
+		{
+			size_t const head = producer.head.load(std::memory_order_relaxed);
+			for(size_t i = consumer.tail.load(std::memory_order_relaxed); i != head; ++i)
+				std::destroy_at(get_slot(i));
+		}
+
+		// Producer side. Returns false without blocking if the queue is full.
+		template<typename... Ts> bool try_emplace(Ts&&... args)
+		{
+			size_t const head = producer.head.load(std::memory_order_relaxed);
+			if(!has_space(head, 1))
+				return false;
+
+			std::construct_at(get_slot(head), std::forward<Ts>(args)...);
+			producer.head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Producer side. Yields to other threads while the queue is full.
+		template<typename... Ts> void emplace(Ts&&... args)
+		{
+			size_t const head = producer.head.load(std::memory_order_relaxed);
+			while(!has_space(head, 1))
+				std::this_thread::yield();
+
+			std::construct_at(get_slot(head), std::forward<Ts>(args)...);
+			producer.head.store(head + 1, std::memory_order_release);
+		}
+
+		// Producer side. Pushes as many elements of the range as fit and returns an iterator past the last pushed element.
+		template<std::forward_iterator It> It try_push_batch(It first, It last)
+		{
+			size_t const head	 = producer.head.load(std::memory_order_relaxed);
+			size_t		 written = static_cast<size_t>(std::distance(first, last));
+			if(!has_space(head, written))
+				written = CAPACITY - (head - producer.cached_tail);
+
+			for(size_t i = 0; i != written; ++i, ++first)
+				std::construct_at(get_slot(head + i), *first);
+
+			producer.head.store(head + written, std::memory_order_release);
+			return first;
+		}
+
+		// Consumer side. Returns false without blocking if the queue is empty.
+		bool try_pop(T& element)
+		{
+			size_t const tail = consumer.tail.load(std::memory_order_relaxed);
+			if(!has_elements(tail))
+				return false;
+
+			T* slot = get_slot(tail);
+			element = std::move(*slot);
+			std::destroy_at(slot);
+			consumer.tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer side. Passes every element that was published by the time of the call to the function, then releases all
+		// of their slots at once. Returns the number of consumed elements.
+		size_t consume_all(auto consume_func)
+		{
+			size_t const tail = consumer.tail.load(std::memory_order_relaxed);
+			size_t const head = producer.head.load(std::memory_order_acquire);
+
+			for(size_t i = tail; i != head; ++i)
+			{
+				T* slot = get_slot(i);
+				consume_func(std::move(*slot));
+				std::destroy_at(slot);
+			}
+			consumer.cached_head = head;
+			consumer.tail.store(head, std::memory_order_release);
+			return head - tail;
+		}
+
+		// Only exact when called from the consumer while the producer is idle, or vice versa.
+		size_t size_approx() const noexcept
+		{
+			return producer.head.load(std::memory_order_relaxed) - consumer.tail.load(std::memory_order_relaxed);
+		}
+
+		static constexpr size_t capacity() noexcept
+		{
+			return CAPACITY;
+		}
+
+	private:
+		static constexpr size_t CACHE_LINE_SIZE = 64;
+
+		struct alignas(CACHE_LINE_SIZE) ProducerState
+		{
+			std::atomic<size_t> head		= 0;
+			size_t				cached_tail = 0; // Only accessed by the producer.
+		};
+
+		struct alignas(CACHE_LINE_SIZE) ConsumerState
+		{
+			std::atomic<size_t> tail		= 0;
+			size_t				cached_head = 0; // Only accessed by the consumer.
+		};
+
+		ProducerState producer;
+		ConsumerState consumer;
+		alignas(CACHE_LINE_SIZE) alignas(T) unsigned char storage[CAPACITY * sizeof(T)];
+
+		T* get_slot(size_t index) noexcept
+		{
+			return reinterpret_cast<T*>(storage) + (index & (CAPACITY - 1));
+		}
+
+		bool has_space(size_t head, size_t count) noexcept
+		{
+			if(head + count - producer.cached_tail <= CAPACITY)
+				return true;
+
+			producer.cached_tail = consumer.tail.load(std::memory_order_acquire);
+			return head + count - producer.cached_tail <= CAPACITY;
+		}
+
+		bool has_elements(size_t tail) noexcept
+		{
+			if(tail != consumer.cached_head)
+				return true;
+
+			consumer.cached_head = producer.head.load(std::memory_order_acquire);
+			return tail != consumer.cached_head;
+		}
+	};
+}
@@ -0,0 +1,276 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+export module vt.Core.TransformHierarchy;
+
+import vt.Core.AffineTransform;
+import vt.Core.Matrix;
+import vt.Core.Quaternion;
+import vt.Core.Vector;
+
+namespace vt
+{
+	// Stable identifier of a node in a transform hierarchy, which stays valid until the node is removed.
+	export using TransformId = unsigned;
+
+	export constexpr inline TransformId NO_PARENT = std::numeric_limits<TransformId>::max();
+
+	// Owns local and world transforms of a forest of nodes. Nodes are stored as structure of arrays sorted by depth, so every
+	// parent precedes its children and all nodes of one depth level are contiguous and can be updated independently. Only
+	// nodes whose local transform changed, or that have such an ancestor, are recomputed by update().
+	export class TransformHierarchy
+	{
+	public:
+		TransformId add(TransformId parent = NO_PARENT,
+						Float3		translation = {},
+						Quaternion	rotation = {},
+						Float3		scale = {1, 1, 1})
+		{
+			VT_ASSERT(parent == NO_PARENT || is_alive(parent), "Parent transform does not exist.");
+
+			TransformId id;
+			if(free_ids.empty())
+			{
+				id = static_cast<TransformId>(id_to_index.size());
+				id_to_index.emplace_back();
+			}
+			else
+			{
+				id = free_ids.back();
+				free_ids.pop_back();
+			}
+
+			unsigned const index = static_cast<unsigned>(ids.size());
+			id_to_index[id]		 = index;
+
+			unsigned const parent_index = parent == NO_PARENT ? NO_PARENT : id_to_index[parent];
+			ids.push_back(id);
+			parents.push_back(parent_index);
+			depths.push_back(parent == NO_PARENT ? 0 : depths[parent_index] + 1);
+			translations.push_back(translation);
+			rotations.push_back(rotation);
+			scales.push_back(scale);
+			dirty.push_back(true);
+			world_transforms.emplace_back();
+			world_matrices.emplace_back();
+
+			// Appending a node is only out of order if it is shallower than the last node.
+			if(index != 0 && depths[index] < depths[index - 1])
+				needs_sort = true;
+
+			return id;
+		}
+
+		// Removes the node along with all of its descendants.
+		void remove(TransformId id)
+		{
+			VT_ASSERT(is_alive(id), "Transform does not exist.");
+
+			// Parents always precede their children, even before sorting, so a single forward pass finds the whole subtree.
+			std::vector<bool> removed(ids.size());
+			removed[id_to_index[id]] = true;
+			for(unsigned i = id_to_index[id] + 1; i != ids.size(); ++i)
+				if(parents[i] != NO_PARENT && removed[parents[i]])
+					removed[i] = true;
+
+			std::vector<unsigned> order;
+			for(unsigned i = 0; i != ids.size(); ++i)
+			{
+				if(removed[i])
+				{
+					id_to_index[ids[i]] = NO_PARENT;
+					free_ids.push_back(ids[i]);
+				}
+				else
+					order.push_back(i);
+			}
+			reorder(order);
+		}
+
+		bool is_alive(TransformId id) const noexcept
+		{
+			return id < id_to_index.size() && id_to_index[id] != NO_PARENT;
+		}
+
+		void set_translation(TransformId id, Float3 translation) noexcept
+		{
+			unsigned index		= id_to_index[id];
+			translations[index] = translation;
+			dirty[index]		= true;
+		}
+
+		void set_rotation(TransformId id, Quaternion const& rotation) noexcept
+		{
+			unsigned index	 = id_to_index[id];
+			rotations[index] = rotation;
+			dirty[index]	 = true;
+		}
+
+		void set_scale(TransformId id, Float3 scale) noexcept
+		{
+			unsigned index = id_to_index[id];
+			scales[index]  = scale;
+			dirty[index]   = true;
+		}
+
+		Float3 get_translation(TransformId id) const noexcept
+		{
+			return translations[id_to_index[id]];
+		}
+
+		Quaternion get_rotation(TransformId id) const noexcept
+		{
+			return rotations[id_to_index[id]];
+		}
+
+		Float3 get_scale(TransformId id) const noexcept
+		{
+			return scales[id_to_index[id]];
+		}
+
+		// Recomputes the world transforms of all dirty nodes and their descendants, then clears all dirty flags.
+		void update()
+		{
+			if(needs_sort)
+				sort_by_depth();
+
+			size_t level_begin = 0;
+			while(level_begin != ids.size())
+			{
+				unsigned const depth = depths[level_begin];
+
+				size_t level_end = level_begin;
+				while(level_end != ids.size() && depths[level_end] == depth)
+					++level_end;
+
+				update_level(level_begin, level_end);
+				level_begin = level_end;
+			}
+			std::fill(dirty.begin(), dirty.end(), false);
+		}
+
+		// World matrices of all nodes as of the last update, in internal order and contiguous for uploading to an instance
+		// buffer. Use get_index to find the matrix of a particular node.
+		std::span<Float4x4 const> get_world_matrices() const noexcept
+		{
+			return world_matrices;
+		}
+
+		Float4x4 const& get_world_matrix(TransformId id) const noexcept
+		{
+			return world_matrices[id_to_index[id]];
+		}
+
+		AffineTransform const& get_world_transform(TransformId id) const noexcept
+		{
+			return world_transforms[id_to_index[id]];
+		}
+
+		// Internal position of the node. Only changes when nodes are added out of depth order or removed.
+		unsigned get_index(TransformId id) const noexcept
+		{
+			return id_to_index[id];
+		}
+
+		size_t size() const noexcept
+		{
+			return ids.size();
+		}
+
+	private:
+		static constexpr size_t PARALLEL_LEVEL_SIZE = 4096; // Levels with at least this many nodes are updated in parallel.
+
+		std::vector<TransformId>	 ids;
+		std::vector<unsigned>		 parents; // Internal index of the parent, or NO_PARENT for roots.
+		std::vector<unsigned>		 depths;
+		std::vector<Float3>			 translations;
+		std::vector<Quaternion>		 rotations;
+		std::vector<Float3>			 scales;
+		std::vector<uint8_t>		 dirty;
+		std::vector<AffineTransform> world_transforms;
+		std::vector<Float4x4>		 world_matrices;
+		std::vector<unsigned>		 id_to_index;
+		std::vector<TransformId>	 free_ids;
+		bool						 needs_sort = false;
+
+		void update_level(size_t begin, size_t end)
+		{
+			auto update_node = [&](size_t i) {
+				unsigned const parent = parents[i];
+
+				// Parents are in a previous level, so their flags are final by the time this level is updated.
+				bool const parent_dirty = parent != NO_PARENT && dirty[parent];
+				if(!dirty[i] && !parent_dirty)
+					return;
+
+				auto local = AffineTransform::from_components(translations[i], rotations[i], scales[i]);
+				if(parent != NO_PARENT)
+					local = local * world_transforms[parent];
+
+				world_transforms[i] = local;
+				world_matrices[i]	= local.to_matrix();
+				dirty[i]			= true; // Propagates to the children in the next level.
+			};
+
+			if(end - begin >= PARALLEL_LEVEL_SIZE)
+			{
+				std::vector<size_t> indices(end - begin);
+				std::iota(indices.begin(), indices.end(), begin);
+				std::for_each(std::execution::par_unseq, indices.begin(), indices.end(), update_node);
+			}
+			else
+				for(size_t i = begin; i != end; ++i)
+					update_node(i);
+		}
+
+		void sort_by_depth()
+		{
+			std::vector<unsigned> order(ids.size());
+			std::iota(order.begin(), order.end(), 0);
+			std::stable_sort(order.begin(), order.end(), [&](unsigned left, unsigned right) {
+				return depths[left] < depths[right];
+			});
+			reorder(order);
+			needs_sort = false;
+		}
+
+		// Rebuilds all arrays so that the node at order[i] moves to index i. Nodes missing from the order are dropped.
+		void reorder(std::vector<unsigned> const& order)
+		{
+			std::vector<unsigned> old_to_new(ids.size(), NO_PARENT);
+			for(unsigned i = 0; i != order.size(); ++i)
+				old_to_new[order[i]] = i;
+
+			auto permute = [&](auto& array) {
+				std::remove_reference_t<decltype(array)> permuted;
+				permuted.reserve(order.size());
+				for(unsigned old_index : order)
+					permuted.push_back(array[old_index]);
+				array = std::move(permuted);
+			};
+			permute(ids);
+			permute(parents);
+			permute(depths);
+			permute(translations);
+			permute(rotations);
+			permute(scales);
+			permute(dirty);
+			permute(world_transforms);
+			permute(world_matrices);
+
+			for(unsigned i = 0; i != ids.size(); ++i)
+			{
+				id_to_index[ids[i]] = i;
+				if(parents[i] != NO_PARENT)
+					parents[i] = old_to_new[parents[i]];
+			}
+		}
+	};
+}
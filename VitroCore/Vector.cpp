@@ -1,10 +1,14 @@
 module;
+#include "VitroCore/Macros.hpp"
+
 #include <cmath>
 #include <format>
 #include <string>
 #include <type_traits>
 export module vt.Core.Vector;
 
+import vt.Core.Simd;
+
 namespace vt
 {
 	export template<typename From, typename To>
@@ -193,6 +197,10 @@ namespace vt
 
 	export template<typename T1, typename T2, int D> constexpr auto operator+(Vector<T1, D> left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+			if(!std::is_constant_evaluated())
+				return simd::store_vector<Vector<float, D>>(simd::add(simd::load_vector(left), simd::load_vector(right)));
+
 		Vector<decltype(left[0] + right[0]), D> sum;
 		for(int i = 0; i != D; ++i)
 			sum[i] = left[i] + right[i];
@@ -215,6 +223,14 @@ namespace vt
 	export template<typename T1, typename T2, int D>
 	constexpr Vector<T1, D>& operator+=(Vector<T1, D>& left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				simd::store_vector(left, simd::add(simd::load_vector(left), simd::load_vector(right)));
+				return left;
+			}
+		}
 		for(int i = 0; i != D; ++i)
 			left[i] += right[i];
 		return left;
@@ -222,6 +238,14 @@ namespace vt
 
 	export template<typename T, int D> constexpr Vector<T, D>& operator+=(Vector<T, D>& vec, auto scalar) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T, decltype(scalar), D>)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				simd::store_vector(vec, simd::add(simd::load_vector(vec), simd::splat(scalar)));
+				return vec;
+			}
+		}
 		for(T& component : vec)
 			component += scalar;
 		return vec;
@@ -237,6 +261,10 @@ namespace vt
 
 	export template<typename T1, typename T2, int D> constexpr auto operator-(Vector<T1, D> left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+			if(!std::is_constant_evaluated())
+				return simd::store_vector<Vector<float, D>>(simd::sub(simd::load_vector(left), simd::load_vector(right)));
+
 		Vector<decltype(left[0] - right[0]), D> difference;
 		for(int i = 0; i != D; ++i)
 			difference[i] = left[i] - right[i];
@@ -262,6 +290,14 @@ namespace vt
 	export template<typename T1, typename T2, int D>
 	constexpr Vector<T1, D>& operator-=(Vector<T1, D>& left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				simd::store_vector(left, simd::sub(simd::load_vector(left), simd::load_vector(right)));
+				return left;
+			}
+		}
 		for(int i = 0; i != D; ++i)
 			left[i] -= right[i];
 		return left;
@@ -269,6 +305,14 @@ namespace vt
 
 	export template<typename T, int D> constexpr Vector<T, D>& operator-=(Vector<T, D>& vec, auto scalar) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T, decltype(scalar), D>)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				simd::store_vector(vec, simd::sub(simd::load_vector(vec), simd::splat(scalar)));
+				return vec;
+			}
+		}
 		for(T& component : vec)
 			component -= scalar;
 		return vec;
@@ -276,6 +320,10 @@ namespace vt
 
 	export template<typename T1, typename T2, int D> constexpr auto operator*(Vector<T1, D> left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+			if(!std::is_constant_evaluated())
+				return simd::store_vector<Vector<float, D>>(simd::mul(simd::load_vector(left), simd::load_vector(right)));
+
 		Vector<decltype(left[0] * right[0]), D> product;
 		for(int i = 0; i != D; ++i)
 			product[i] = left[i] * right[i];
@@ -284,6 +332,10 @@ namespace vt
 
 	export template<typename T, int D> constexpr auto operator*(Vector<T, D> vec, auto scalar) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T, decltype(scalar), D>)
+			if(!std::is_constant_evaluated())
+				return simd::store_vector<Vector<float, D>>(simd::mul(simd::load_vector(vec), simd::splat(scalar)));
+
 		Vector<decltype(vec[0] * scalar), D> product;
 		for(int i = 0; i != D; ++i)
 			product[i] = vec[i] * scalar;
@@ -298,6 +350,14 @@ namespace vt
 	export template<typename T1, typename T2, int D>
 	constexpr Vector<T1, D>& operator*=(Vector<T1, D>& left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				simd::store_vector(left, simd::mul(simd::load_vector(left), simd::load_vector(right)));
+				return left;
+			}
+		}
 		for(int i = 0; i != D; ++i)
 			left[i] *= right[i];
 		return left;
@@ -305,6 +365,14 @@ namespace vt
 
 	export template<typename T, int D> constexpr Vector<T, D>& operator*=(Vector<T, D>& vec, auto scalar) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T, decltype(scalar), D>)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				simd::store_vector(vec, simd::mul(simd::load_vector(vec), simd::splat(scalar)));
+				return vec;
+			}
+		}
 		for(T& component : vec)
 			component *= scalar;
 		return vec;
@@ -312,6 +380,10 @@ namespace vt
 
 	export template<typename T1, typename T2, int D> constexpr auto operator/(Vector<T1, D> left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+			if(!std::is_constant_evaluated())
+				return simd::store_vector<Vector<float, D>>(simd::div(simd::load_vector(left), simd::load_vector(right)));
+
 		Vector<decltype(left[0] / right[0]), D> quotient;
 		for(int i = 0; i != D; ++i)
 			quotient[i] = left[i] / right[i];
@@ -337,6 +409,14 @@ namespace vt
 	export template<typename T1, typename T2, int D>
 	constexpr Vector<T1, D>& operator/=(Vector<T1, D>& left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				simd::store_vector(left, simd::div(simd::load_vector(left), simd::load_vector(right)));
+				return left;
+			}
+		}
 		for(int i = 0; i != D; ++i)
 			left[i] /= right[i];
 		return left;
@@ -344,6 +424,14 @@ namespace vt
 
 	export template<typename T, int D> constexpr Vector<T, D>& operator/=(Vector<T, D>& vec, auto scalar) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T, decltype(scalar), D>)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				simd::store_vector(vec, simd::div(simd::load_vector(vec), simd::splat(scalar)));
+				return vec;
+			}
+		}
 		for(T& component : vec)
 			component /= scalar;
 		return vec;
@@ -359,6 +447,10 @@ namespace vt
 
 	export template<typename T1, typename T2, int D> constexpr auto dot(Vector<T1, D> left, Vector<T2, D> right) noexcept
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, D>)
+			if(!std::is_constant_evaluated())
+				return simd::horizontal_sum<D>(simd::mul(simd::load_vector(left), simd::load_vector(right)));
+
 		auto const hadamard = left * right;
 
 		decltype(left[0] * right[0]) dot = 0;
@@ -374,6 +466,10 @@ namespace vt
 
 	export template<typename T, int D> constexpr auto normalize(Vector<T, D> vec)
 	{
+		if constexpr(simd::USE_SIMD<T, T, D>)
+			if(!std::is_constant_evaluated())
+				return simd::store_vector<Vector<float, D>>(simd::normalize<D>(simd::load_vector(vec)));
+
 		return 1.0f / length(vec) * vec;
 	}
 
@@ -418,6 +514,10 @@ namespace vt
 	export template<typename T1, typename T2>
 	constexpr auto cross(Vector<T1, 3> left, Vector<T2, 3> right) noexcept -> Vector<decltype(left[0] * right[0]), 3>
 	{
+		if constexpr(simd::USE_SIMD<T1, T2, 3>)
+			if(!std::is_constant_evaluated())
+				return simd::store_vector<Vector<float, 3>>(simd::cross3(simd::load_vector(left), simd::load_vector(right)));
+
 		return {
 			left.y * right.z - right.y * left.z,
 			left.z * right.x - right.z * left.x,
@@ -0,0 +1,261 @@
+module;
+#include "VitroCore/Macros.hpp"
+
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+export module vt.Core.VectorStream;
+
+import vt.Core.Array;
+import vt.Core.Matrix;
+import vt.Core.Simd;
+import vt.Core.Vector;
+
+namespace vt
+{
+	// Stores vectors as structure of arrays, with one contiguous array per component, so that batch kernels can process as many
+	// vectors per instruction as the widest available register allows.
+	export template<typename T, int D> class VectorStream
+	{
+	public:
+		VectorStream() = default;
+
+		explicit VectorStream(size_t count)
+		{
+			resize(count);
+		}
+
+		VectorStream(ConstSpan<Vector<T, D>> vectors)
+		{
+			resize(vectors.size());
+			for(size_t i = 0; i != vectors.size(); ++i)
+				set(i, vectors[i]);
+		}
+
+		Vector<T, D> operator[](size_t index) const noexcept
+		{
+			Vector<T, D> vec;
+			for(int d = 0; d != D; ++d)
+				vec[d] = components[d][index];
+			return vec;
+		}
+
+		void set(size_t index, Vector<T, D> vec) noexcept
+		{
+			for(int d = 0; d != D; ++d)
+				components[d][index] = vec[d];
+		}
+
+		void push_back(Vector<T, D> vec)
+		{
+			for(int d = 0; d != D; ++d)
+				components[d].push_back(vec[d]);
+		}
+
+		void resize(size_t count)
+		{
+			for(auto& component : components)
+				component.resize(count);
+		}
+
+		void reserve(size_t count)
+		{
+			for(auto& component : components)
+				component.reserve(count);
+		}
+
+		void clear() noexcept
+		{
+			for(auto& component : components)
+				component.clear();
+		}
+
+		// Writes the vectors back into array of structures form. The destination must hold at least size() elements.
+		void copy_to(std::span<Vector<T, D>> dst) const noexcept
+		{
+			VT_ASSERT(dst.size() >= size(), "Destination is too small.");
+
+			for(size_t i = 0; i != size(); ++i)
+				dst[i] = (*this)[i];
+		}
+
+		T* component(int index) noexcept
+		{
+			return components[index].data();
+		}
+
+		T const* component(int index) const noexcept
+		{
+			return components[index].data();
+		}
+
+		size_t size() const noexcept
+		{
+			return components[0].size();
+		}
+
+		bool empty() const noexcept
+		{
+			return components[0].empty();
+		}
+
+	private:
+		std::vector<T> components[D];
+	};
+
+	// Invokes the kernel for every full pack and once more for the remaining elements, if any. The kernel receives whether
+	// the pack is full as a compile-time constant, the index of the first element and the number of valid elements.
+	template<typename Kernel> VT_ALWAYS_INLINE void for_each_pack(size_t count, Kernel kernel)
+	{
+		size_t i = 0;
+		for(; i + simd::PACK_WIDTH <= count; i += simd::PACK_WIDTH)
+			kernel(std::true_type(), i, simd::PACK_WIDTH);
+
+		if(i != count)
+			kernel(std::false_type(), i, static_cast<int>(count - i));
+	}
+
+	template<bool FULL> VT_ALWAYS_INLINE simd::FloatPack load(float const src[], int count, float fill = 0)
+	{
+		if constexpr(FULL)
+			return simd::load_pack(src);
+		else
+			return simd::load_pack_partial(src, count, fill);
+	}
+
+	template<bool FULL> VT_ALWAYS_INLINE void store(float dst[], simd::FloatPack pack, int count)
+	{
+		if constexpr(FULL)
+			simd::store_pack(dst, pack);
+		else
+			simd::store_pack_partial(dst, pack, count);
+	}
+
+	template<bool POINTS> void transform(VectorStream<float, 3>& dst, VectorStream<float, 3> const& src, Float4x4 const& mat)
+	{
+		dst.resize(src.size());
+
+		simd::FloatPack m[4][3];
+		for(int r = 0; r != 4; ++r)
+			for(int c = 0; c != 3; ++c)
+				m[r][c] = simd::splat_pack(mat.rows[r][c]);
+
+		float const* x_in  = src.component(0);
+		float const* y_in  = src.component(1);
+		float const* z_in  = src.component(2);
+		float*		 x_out = dst.component(0);
+		float*		 y_out = dst.component(1);
+		float*		 z_out = dst.component(2);
+		for_each_pack(src.size(), [&](auto full, size_t i, int count) {
+			auto x = load<full>(x_in + i, count);
+			auto y = load<full>(y_in + i, count);
+			auto z = load<full>(z_in + i, count);
+
+			// Row vector convention, consistent with Vector * Matrix.
+			simd::FloatPack result[3];
+			for(int c = 0; c != 3; ++c)
+			{
+				auto sum = simd::mul(x, m[0][c]);
+				sum		 = simd::mul_add(y, m[1][c], sum);
+				sum		 = simd::mul_add(z, m[2][c], sum);
+				if constexpr(POINTS)
+					sum = simd::add(sum, m[3][c]);
+				result[c] = sum;
+			}
+			store<full>(x_out + i, result[0], count);
+			store<full>(y_out + i, result[1], count);
+			store<full>(z_out + i, result[2], count);
+		});
+	}
+
+	// Transforms positions by the matrix, treating them as having a w component of 1. The destination may be the source.
+	export void transform_points(VectorStream<float, 3>& dst, VectorStream<float, 3> const& src, Float4x4 const& mat)
+	{
+		transform<true>(dst, src, mat);
+	}
+
+	// Transforms directions by the matrix, treating them as having a w component of 0. The destination may be the source.
+	export void transform_directions(VectorStream<float, 3>& dst, VectorStream<float, 3> const& src, Float4x4 const& mat)
+	{
+		transform<false>(dst, src, mat);
+	}
+
+	// Writes the dot product of each pair of vectors into the destination, which must hold at least as many elements.
+	export template<int D>
+	void dot(std::span<float> dst, VectorStream<float, D> const& left, VectorStream<float, D> const& right) noexcept
+	{
+		VT_ASSERT(left.size() == right.size(), "Vector streams must be of equal size.");
+		VT_ASSERT(dst.size() >= left.size(), "Destination is too small.");
+
+		for_each_pack(left.size(), [&](auto full, size_t i, int count) {
+			auto sum = simd::mul(load<full>(left.component(0) + i, count), load<full>(right.component(0) + i, count));
+			for(int d = 1; d != D; ++d)
+				sum = simd::mul_add(load<full>(left.component(d) + i, count), load<full>(right.component(d) + i, count), sum);
+
+			store<full>(dst.data() + i, sum, count);
+		});
+	}
+
+	// Scales every vector to unit length in place.
+	export template<int D> void normalize(VectorStream<float, D>& stream) noexcept
+	{
+		for_each_pack(stream.size(), [&](auto full, size_t i, int count) {
+			simd::FloatPack comps[D];
+			for(int d = 0; d != D; ++d)
+				comps[d] = load<full>(stream.component(d) + i, count, 1.0f); // Avoids dividing by zero in unused lanes.
+
+			auto length_squared = simd::mul(comps[0], comps[0]);
+			for(int d = 1; d != D; ++d)
+				length_squared = simd::mul_add(comps[d], comps[d], length_squared);
+
+			auto inv_length = simd::inv_sqrt(length_squared);
+			for(int d = 0; d != D; ++d)
+				store<full>(stream.component(d) + i, simd::mul(comps[d], inv_length), count);
+		});
+	}
+
+	// Returns the component-wise minimum over all vectors, or positive infinity if the stream is empty.
+	export template<int D> Vector<float, D> reduce_min(VectorStream<float, D> const& stream) noexcept
+	{
+		constexpr float INF = std::numeric_limits<float>::infinity();
+
+		simd::FloatPack mins[D];
+		for(auto& pack : mins)
+			pack = simd::splat_pack(INF);
+
+		for_each_pack(stream.size(), [&](auto full, size_t i, int count) {
+			for(int d = 0; d != D; ++d)
+				mins[d] = simd::min(mins[d], load<full>(stream.component(d) + i, count, INF));
+		});
+
+		Vector<float, D> result;
+		for(int d = 0; d != D; ++d)
+			result[d] = simd::reduce_min(mins[d]);
+		return result;
+	}
+
+	// Returns the component-wise maximum over all vectors, or negative infinity if the stream is empty.
+	export template<int D> Vector<float, D> reduce_max(VectorStream<float, D> const& stream) noexcept
+	{
+		constexpr float INF = std::numeric_limits<float>::infinity();
+
+		simd::FloatPack maxs[D];
+		for(auto& pack : maxs)
+			pack = simd::splat_pack(-INF);
+
+		for_each_pack(stream.size(), [&](auto full, size_t i, int count) {
+			for(int d = 0; d != D; ++d)
+				maxs[d] = simd::max(maxs[d], load<full>(stream.component(d) + i, count, -INF));
+		});
+
+		Vector<float, D> result;
+		for(int d = 0; d != D; ++d)
+			result[d] = simd::reduce_max(maxs[d]);
+		return result;
+	}
+
+	export using Float2Stream = VectorStream<float, 2>;
+	export using Float3Stream = VectorStream<float, 3>;
+	export using Float4Stream = VectorStream<float, 4>;
+}